@@ -0,0 +1,90 @@
+/// --------------------------------------------------------
+/// Allocation cost against orders per level
+///
+/// For each level depth N, rests N sell orders of random
+/// size at one price, then times a buy for half the level's
+/// quantity under FIFO, pro-rata and top-order pro-rata
+/// allocation. The rest of the level is swept (untimed)
+/// before the next round so every round starts clean.
+///
+/// Usage: bench_allocation [rounds_per_point]
+/// --------------------------------------------------------
+
+#include "order_book.hpp"
+#include "time_utils.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Sample {
+    std::uint64_t median_ns = 0;
+    double trades = 0.0;
+};
+
+template <typename Book>
+Sample run_point(std::size_t orders_per_level, std::size_t rounds, std::uint64_t seed) {
+    constexpr std::int64_t kPrice = 10'000;
+    std::mt19937_64 rng(seed);
+    std::uniform_int_distribution<std::int64_t> size(1, 100);
+
+    Book book;
+    std::vector<lob::Trade> trades;
+    std::vector<std::uint64_t> samples;
+    samples.reserve(rounds);
+    std::uint64_t next_id = 1;
+    std::size_t trade_count = 0;
+
+    for (std::size_t r = 0; r < rounds; ++r) {
+        std::int64_t level_qty = 0;
+        for (std::size_t i = 0; i < orders_per_level; ++i) {
+            const auto qty = size(rng);
+            book.add(lob::Order{next_id++, lob::Side::Sell, 0, kPrice, qty, next_id});
+            level_qty += qty;
+        }
+
+        lob::Order taker{next_id++, lob::Side::Buy, 0, kPrice, std::max<std::int64_t>(1, level_qty / 2), 0};
+        trades.clear();
+        const auto start = lob::now_ns();
+        book.match(taker, trades);
+        samples.push_back(lob::now_ns() - start);
+        trade_count += trades.size();
+
+        lob::Order sweep{next_id++, lob::Side::Buy, 0, kPrice, level_qty, 0};
+        trades.clear();
+        book.match(sweep, trades);
+    }
+
+    std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+    return {samples[samples.size() / 2], static_cast<double>(trade_count) / static_cast<double>(rounds)};
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t base_rounds = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+    const std::size_t depths[] = {1, 4, 16, 64, 256, 1024, 4096};
+
+    std::cout << "orders/level | fifo ns (trades) | pro-rata ns (trades) | top-order ns (trades) | pro-rata ns/order\n";
+    for (const auto n : depths) {
+        const auto rounds = std::max<std::size_t>(32, base_rounds / n);
+        const auto fifo = run_point<lob::OrderBook>(n, rounds, n);
+        const auto pro = run_point<lob::ProRataOrderBook>(n, rounds, n);
+        const auto top = run_point<lob::TopOrderProRataOrderBook>(n, rounds, n);
+
+        std::cout << std::setw(12) << n << " | "
+                  << std::setw(7) << fifo.median_ns << " (" << std::setw(6) << std::fixed << std::setprecision(1)
+                  << fifo.trades << ") | "
+                  << std::setw(11) << pro.median_ns << " (" << std::setw(6) << pro.trades << ") | "
+                  << std::setw(12) << top.median_ns << " (" << std::setw(6) << top.trades << ") | "
+                  << std::setw(8) << std::setprecision(2)
+                  << static_cast<double>(pro.median_ns) / static_cast<double>(n) << "\n";
+    }
+    return 0;
+}
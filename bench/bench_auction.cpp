@@ -0,0 +1,66 @@
+/// --------------------------------------------------------
+/// Call auction uncross on a large book
+///
+/// Rests N orders (default 1M) in auction mode across a
+/// crossed price band, then times the equilibrium search
+/// (indicative_uncross) and the full uncross (search plus
+/// execution) for each book layout.
+///
+/// Usage: bench_auction [orders] [price_range_ticks]
+/// --------------------------------------------------------
+
+#include "order_book.hpp"
+#include "time_utils.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+template <typename Book>
+void run(const char* name, std::size_t orders, std::int64_t range) {
+    constexpr std::int64_t kBase = 10'000;
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<std::int64_t> delta(-range, range);
+    std::uniform_int_distribution<std::int64_t> size(1, 100);
+    std::bernoulli_distribution buy(0.5);
+
+    Book book;
+    for (std::size_t i = 0; i < orders; ++i) {
+        book.add(lob::Order{i + 1, buy(rng) ? lob::Side::Buy : lob::Side::Sell, 0, kBase + delta(rng), size(rng), i});
+    }
+
+    auto start = lob::now_ns();
+    const auto indicative = book.indicative_uncross();
+    const auto search_ns = lob::now_ns() - start;
+
+    std::vector<lob::Trade> trades;
+    trades.reserve(orders);
+    start = lob::now_ns();
+    const auto result = book.uncross(trades);
+    const auto uncross_ns = lob::now_ns() - start;
+
+    std::cout << name << ": price=" << result.price << " volume=" << result.volume
+              << " surplus=" << result.surplus << " trades=" << trades.size()
+              << " | search " << search_ns / 1000.0 << "us"
+              << " | uncross " << uncross_ns / 1e6 << "ms ("
+              << (trades.empty() ? 0.0 : static_cast<double>(uncross_ns) / static_cast<double>(trades.size()))
+              << " ns/trade)"
+              << (indicative.price == result.price ? "" : " MISMATCH") << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t orders = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::int64_t range = argc > 2 ? std::strtoll(argv[2], nullptr, 10) : 500;
+
+    std::cout << "Uncrossing " << orders << " orders over +/-" << range << " ticks\n";
+    run<lob::OrderBook>("map-deque", orders, range);
+    run<lob::FlatDequeOrderBook>("flat-deque", orders, range);
+    run<lob::LadderRingOrderBook>("ladder-ring", orders, range);
+    return 0;
+}
@@ -0,0 +1,263 @@
+/// --------------------------------------------------------
+/// Passive book building: BookBuilder vs the matching path
+///
+/// One book mirrors a feed of order-level updates (35% adds,
+/// 10% executions, 10% partial cancels, 35% deletes, 10%
+/// replaces; bids below asks, so nothing crosses) holding
+/// about `resting` live orders. Four ways to apply it:
+///
+///   engine    MatchingEngine::process() for adds, cancel()
+///             for deletes; reduce = cancel + re-add, from
+///             the caller's own map of live orders
+///   match     OrderBook::match() then add() of the rest;
+///             reduce = cancel + re-add
+///   builder   BookBuilder, one update at a time
+///   builder8  BookBuilder::apply() with prefetch window 8
+///
+/// Cancel + re-add sends a reduced order to the back of its
+/// level: "moved" counts final orders whose queue position
+/// differs from the feed's (checked on the first run). Best
+/// of three runs per cell.
+///
+/// Usage: bench_book_builder [updates] [resting]
+/// --------------------------------------------------------
+
+#include "book_builder.hpp"
+#include "matching_engine.hpp"
+#include "order_id_map.hpp"
+#include "time_utils.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Feed {
+    std::vector<lob::BookUpdate> warmup;
+    std::vector<lob::BookUpdate> updates;
+    std::vector<std::uint64_t> live; // resting at the end
+};
+
+Feed make_feed(std::size_t count, std::size_t resting) {
+    struct Live {
+        std::uint64_t id;
+        std::int64_t qty;
+        lob::Side side;
+    };
+    std::mt19937_64 rng(5);
+    std::vector<Live> live;
+    std::uint64_t next_id = 1;
+    const auto price = [&](lob::Side side) {
+        const auto ticks = static_cast<std::int64_t>(rng() % 51);
+        return side == lob::Side::Buy ? 10'000 - ticks : 10'001 + ticks;
+    };
+    const auto add = [&](std::vector<lob::BookUpdate>& out) {
+        lob::BookUpdate u;
+        u.type = lob::BookUpdate::Type::Add;
+        u.side = rng() % 2 ? lob::Side::Buy : lob::Side::Sell;
+        u.id = next_id++;
+        u.price = price(u.side);
+        u.qty = 1 + static_cast<std::int64_t>(rng() % 1'000);
+        out.push_back(u);
+        live.push_back({u.id, u.qty, u.side});
+    };
+
+    Feed feed;
+    while (live.size() < resting) {
+        add(feed.warmup);
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto roll = rng() % 100;
+        if (live.empty() || roll < 35) {
+            add(feed.updates);
+            continue;
+        }
+        const auto pick = rng() % live.size();
+        auto& order = live[pick];
+        lob::BookUpdate u;
+        u.id = order.id;
+        if (roll < 55) {
+            u.type = lob::BookUpdate::Type::Reduce;
+            u.qty = 1 + static_cast<std::int64_t>(rng() % static_cast<std::uint64_t>(order.qty));
+            order.qty -= u.qty;
+        } else if (roll < 90) {
+            u.type = lob::BookUpdate::Type::Delete;
+            order.qty = 0;
+        } else {
+            u.type = lob::BookUpdate::Type::Replace;
+            u.new_id = next_id++;
+            u.price = price(order.side);
+            u.qty = 1 + static_cast<std::int64_t>(rng() % 1'000);
+            order = {u.new_id, u.qty, order.side};
+        }
+        feed.updates.push_back(u);
+        if (order.qty == 0) {
+            order = live.back();
+            live.pop_back();
+        }
+    }
+    for (const auto& order : live) {
+        feed.live.push_back(order.id);
+    }
+    return feed;
+}
+
+/// Through the matching path: `submit` runs an order through matching and
+/// rests what is left; `cancel` removes and returns an order.
+template <typename Submit, typename Cancel>
+void apply_matching(const lob::BookUpdate& u, Submit&& submit, Cancel&& cancel) {
+    lob::Order order;
+    switch (u.type) {
+    case lob::BookUpdate::Type::Add:
+        order.id = u.id;
+        order.side = u.side;
+        order.price = u.price;
+        order.qty = u.qty;
+        order.ts_ns = u.ts_ns;
+        submit(order);
+        break;
+    case lob::BookUpdate::Type::Reduce:
+        if (cancel(u.id, order) && order.qty > u.qty) {
+            order.qty -= u.qty;
+            submit(order);
+        }
+        break;
+    case lob::BookUpdate::Type::Delete:
+        cancel(u.id, order);
+        break;
+    case lob::BookUpdate::Type::Replace:
+        if (cancel(u.id, order)) {
+            order.id = u.new_id;
+            order.price = u.price;
+            order.qty = u.qty;
+            submit(order);
+        }
+        break;
+    }
+}
+
+template <typename Book>
+std::size_t moved(const Book& book, const Book& reference, const std::vector<std::uint64_t>& live) {
+    std::size_t n = 0;
+    for (const auto id : live) {
+        n += book.queue_position(id).orders_ahead != reference.queue_position(id).orders_ahead;
+    }
+    return n;
+}
+
+struct Result {
+    double ns_per_update = 0.0;
+    std::size_t moved = 0;
+};
+
+template <typename Book>
+void sweep(const char* name, const Feed& feed) {
+    using Builder = lob::BookBuilder<Book>;
+    using Engine = lob::BasicMatchingEngine<Book>;
+    const auto n = static_cast<double>(feed.updates.size());
+    Builder reference;
+    reference.apply(feed.warmup.data(), feed.warmup.size(), 0);
+    reference.apply(feed.updates.data(), feed.updates.size(), 0);
+
+    const auto time_engine = [&](bool check) {
+        lob::LatencyStats latency;
+        Engine engine(latency);
+        std::vector<lob::Trade> trades;
+        lob::OrderIdMap<lob::Order> orders(2 * feed.live.size());
+        const auto submit = [&](const lob::Order& o) {
+            engine.process(o, trades);
+            trades.clear();
+            orders.insert(o.id, o);
+        };
+        const auto cancel = [&](std::uint64_t id, lob::Order& out) {
+            const auto* found = orders.find(id);
+            if (found == nullptr) {
+                return false;
+            }
+            out = *found;
+            orders.erase(id);
+            out.qty = engine.cancel(id);
+            return true;
+        };
+        for (const auto& u : feed.warmup) {
+            apply_matching(u, submit, cancel);
+        }
+        latency.reserve(feed.updates.size());
+        const auto start = lob::now_ns();
+        for (const auto& u : feed.updates) {
+            apply_matching(u, submit, cancel);
+        }
+        const auto ns = lob::now_ns() - start;
+        return Result{static_cast<double>(ns) / n, check ? moved(engine.book(), reference.book(), feed.live) : 0};
+    };
+    const auto time_match = [&](bool check) {
+        Book book;
+        std::vector<lob::Trade> trades;
+        const auto submit = [&](lob::Order o) {
+            book.match(o, trades);
+            trades.clear();
+            if (o.qty > 0) {
+                book.add(std::move(o));
+            }
+        };
+        const auto cancel = [&](std::uint64_t id, lob::Order& out) { return book.cancel(id, out); };
+        for (const auto& u : feed.warmup) {
+            apply_matching(u, submit, cancel);
+        }
+        const auto start = lob::now_ns();
+        for (const auto& u : feed.updates) {
+            apply_matching(u, submit, cancel);
+        }
+        const auto ns = lob::now_ns() - start;
+        return Result{static_cast<double>(ns) / n, check ? moved(book, reference.book(), feed.live) : 0};
+    };
+    const auto time_builder = [&](std::size_t window, bool check) {
+        Builder builder;
+        builder.apply(feed.warmup.data(), feed.warmup.size(), 0);
+        const auto start = lob::now_ns();
+        builder.apply(feed.updates.data(), feed.updates.size(), window);
+        const auto ns = lob::now_ns() - start;
+        return Result{static_cast<double>(ns) / n, check ? moved(builder.book(), reference.book(), feed.live) : 0};
+    };
+
+    const auto best = [](auto&& run) {
+        auto r = run(true);
+        for (int i = 1; i < 3; ++i) {
+            r.ns_per_update = std::min(r.ns_per_update, run(false).ns_per_update);
+        }
+        return r;
+    };
+    const Result results[] = {
+        best(time_engine),
+        best(time_match),
+        best([&](bool check) { return time_builder(0, check); }),
+        best([&](bool check) { return time_builder(8, check); }),
+    };
+    std::cout << std::setw(11) << name;
+    for (const auto& r : results) {
+        std::cout << std::setw(10) << std::fixed << std::setprecision(1) << r.ns_per_update << std::setw(8)
+                  << r.moved;
+    }
+    std::cout << "  " << std::setprecision(2) << results[0].ns_per_update / results[3].ns_per_update << "x\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::size_t resting = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 50'000;
+    const auto feed = make_feed(count, resting);
+    std::cout << "updates " << feed.updates.size() << ", resting " << resting << " at start, " << feed.live.size()
+              << " at end (ns/update, orders moved)\n";
+    std::cout << "       book" << "    engine   moved     match   moved   builder   moved  builder8   moved"
+              << "  engine/builder8\n";
+    sweep<lob::OrderBook>("map-deque", feed);
+    sweep<lob::FlatRingOrderBook>("flat-ring", feed);
+    sweep<lob::FlatListOrderBook>("flat-list", feed);
+    sweep<lob::LadderListOrderBook>("ladder-list", feed);
+    return 0;
+}
@@ -0,0 +1,118 @@
+/// --------------------------------------------------------
+/// Client order id resolution
+///
+/// Inserts N (session, ClOrdID) keys of the usual gateway
+/// shape (prefix + sequence number, 8-20 bytes), then times
+/// random hits and misses against ClientOrderMap and a
+/// std::unordered_map<std::string, id> baseline. Every
+/// erase + reinsert of a quarter of the keys checks the
+/// table stays consistent.
+///
+/// Usage: bench_client_ids [keys] [lookups]
+/// --------------------------------------------------------
+
+#include "client_order_map.hpp"
+#include "time_utils.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+struct Key {
+    std::uint32_t session = 0;
+    std::string clordid;
+};
+
+double per_op(std::uint64_t ns, std::size_t ops) {
+    return static_cast<double>(ns) / static_cast<double>(ops);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t n = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const std::size_t lookups = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5'000'000;
+
+    std::mt19937_64 rng(42);
+    std::uniform_int_distribution<std::uint32_t> session(0, 63);
+    std::uniform_int_distribution<int> width(0, 12);
+    std::vector<Key> keys(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        keys[i].session = session(rng);
+        keys[i].clordid = "ORD" + std::string(static_cast<std::size_t>(width(rng)), '0') + std::to_string(i);
+    }
+    std::vector<std::uint32_t> probes(lookups);
+    std::uniform_int_distribution<std::uint32_t> pick(0, static_cast<std::uint32_t>(n - 1));
+    for (auto& p : probes) {
+        p = pick(rng);
+    }
+
+    lob::ClientOrderMap map(n);
+    std::unordered_map<std::string, std::uint64_t> baseline;
+    baseline.reserve(n);
+
+    auto start = lob::now_ns();
+    for (std::size_t i = 0; i < n; ++i) {
+        map.insert(keys[i].session, keys[i].clordid, i);
+    }
+    const auto map_insert = lob::now_ns() - start;
+
+    start = lob::now_ns();
+    for (std::size_t i = 0; i < n; ++i) {
+        baseline.emplace(std::to_string(keys[i].session) + ':' + keys[i].clordid, i);
+    }
+    const auto base_insert = lob::now_ns() - start;
+
+    std::uint64_t sink = 0;
+    start = lob::now_ns();
+    for (const auto p : probes) {
+        sink += map.find(keys[p].session, keys[p].clordid);
+    }
+    const auto map_hit = lob::now_ns() - start;
+
+    start = lob::now_ns();
+    for (const auto p : probes) {
+        sink += map.find(keys[p].session + 64, keys[p].clordid);
+    }
+    const auto map_miss = lob::now_ns() - start;
+
+    // The baseline key needs building (and allocating) per lookup too.
+    std::string text;
+    start = lob::now_ns();
+    for (const auto p : probes) {
+        text = std::to_string(keys[p].session) + ':' + keys[p].clordid;
+        sink += baseline.find(text)->second;
+    }
+    const auto base_hit = lob::now_ns() - start;
+
+    std::size_t bad = 0;
+    for (std::size_t i = 0; i < n; i += 4) {
+        bad += !map.erase(keys[i].session, keys[i].clordid);
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto id = map.find(keys[i].session, keys[i].clordid);
+        bad += i % 4 == 0 ? id != lob::ClientOrderMap::kNoId : id != i;
+    }
+    for (std::size_t i = 0; i < n; i += 4) {
+        bad += map.insert(keys[i].session, keys[i].clordid, i) != lob::ClientOrderMap::Insert::Ok;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        bad += map.find(keys[i].session, keys[i].clordid) != i;
+    }
+
+    std::cout << std::fixed << std::setprecision(1)
+              << "keys " << n << ", lookups " << lookups << "\n"
+              << "ClientOrderMap  insert " << per_op(map_insert, n) << " ns, hit " << per_op(map_hit, lookups)
+              << " ns, miss " << per_op(map_miss, lookups) << " ns\n"
+              << "unordered_map   insert " << per_op(base_insert, n) << " ns, hit " << per_op(base_hit, lookups)
+              << " ns\n"
+              << "consistency errors: " << bad << " (checksum " << sink % 1000 << ")\n";
+    return bad == 0 ? 0 : 1;
+}
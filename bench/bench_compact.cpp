@@ -0,0 +1,114 @@
+/// --------------------------------------------------------
+/// Wide vs compact order storage on a deep book
+///
+/// Rests N orders over ±2000 ticks (bids below the mid, asks
+/// above), then times a stream of random cancels and orders
+/// priced around the mid that trade against the top levels
+/// and rest. The same stream runs against 64-bit and 32-bit
+/// (CompactStorage) books; their trades must match.
+///
+/// Usage: bench_compact [resting_orders] [operations]
+/// --------------------------------------------------------
+
+#include "order_book.hpp"
+#include "time_utils.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+struct Op {
+    bool cancel = false;
+    lob::Order order;
+};
+
+struct Result {
+    double ns_per_op = 0.0;
+    std::uint64_t checksum = 0;
+};
+
+template <typename Book>
+Result run(const std::vector<lob::Order>& resting, const std::vector<Op>& ops) {
+    Book book;
+    for (const auto& order : resting) {
+        book.add(order);
+    }
+    std::vector<lob::Trade> trades;
+    Result result;
+    const auto start = lob::now_ns();
+    for (const auto& op : ops) {
+        if (op.cancel) {
+            result.checksum += static_cast<std::uint64_t>(book.cancel(op.order.id));
+            continue;
+        }
+        auto order = op.order;
+        book.match(order, trades);
+        if (order.qty > 0) {
+            book.add(std::move(order));
+        }
+        for (const auto& t : trades) {
+            result.checksum = result.checksum * 31 + t.maker_id * 7 + static_cast<std::uint64_t>(t.qty);
+        }
+        trades.clear();
+    }
+    result.ns_per_op = static_cast<double>(lob::now_ns() - start) / static_cast<double>(ops.size());
+    return result;
+}
+
+template <typename Wide, typename Compact>
+void compare(const char* name, const std::vector<lob::Order>& resting, const std::vector<Op>& ops) {
+    const auto wide = run<Wide>(resting, ops);
+    const auto compact = run<Compact>(resting, ops);
+    std::cout << std::setw(12) << name << " | "
+              << std::setw(3) << sizeof(typename Wide::stored_type) << " B " << std::setw(8) << wide.ns_per_op
+              << " ns | "
+              << std::setw(3) << sizeof(typename Compact::stored_type) << " B " << std::setw(8) << compact.ns_per_op
+              << " ns | " << (wide.checksum == compact.checksum ? "same trades" : "TRADES DIFFER") << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t depth = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const std::size_t count = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2'000'000;
+    constexpr std::int64_t kMid = 100'000;
+
+    std::mt19937_64 rng(11);
+    std::uniform_int_distribution<std::int64_t> offset(1, 2'000);
+    std::uniform_int_distribution<std::int64_t> near(-5, 5);
+    std::uniform_int_distribution<std::int64_t> size(1, 100);
+    std::bernoulli_distribution coin(0.5);
+
+    std::vector<lob::Order> resting(depth);
+    std::uint64_t next_id = 1;
+    for (auto& o : resting) {
+        const bool buy = coin(rng);
+        o = lob::Order{next_id++, buy ? lob::Side::Buy : lob::Side::Sell, 0,
+                       buy ? kMid - offset(rng) : kMid + offset(rng), size(rng), next_id};
+    }
+    std::vector<Op> ops(count);
+    for (auto& op : ops) {
+        op.cancel = coin(rng);
+        if (op.cancel) {
+            op.order.id = std::uniform_int_distribution<std::uint64_t>(1, next_id - 1)(rng);
+        } else {
+            const bool buy = coin(rng);
+            op.order = lob::Order{next_id++, buy ? lob::Side::Buy : lob::Side::Sell, 0, kMid + near(rng),
+                                  size(rng), next_id};
+        }
+    }
+
+    std::cout << std::fixed << std::setprecision(1) << "resting " << depth << ", operations " << count << "\n"
+              << "        book |      wide (order, time) |   compact (order, time) |\n";
+    compare<lob::OrderBook, lob::CompactOrderBook>("map-deque", resting, ops);
+    compare<lob::LadderRingOrderBook, lob::BasicOrderBook<lob::LadderLevels, lob::RingOrders, lob::CompactOptions>>(
+        "ladder-ring", resting, ops);
+    compare<lob::LadderListOrderBook, lob::BasicOrderBook<lob::LadderLevels, lob::ListOrders, lob::CompactOptions>>(
+        "ladder-list", resting, ops);
+    return 0;
+}
@@ -0,0 +1,213 @@
+/// --------------------------------------------------------
+/// FIX order entry: decode and encode throughput
+///
+/// N NewOrderSingles (ClOrdIDs of 8-12 bytes, prices 99.00
+/// to 101.00, a few with Account) are written back to back
+/// into one buffer, then decoded three ways:
+///
+///   naive     bytewise: checksum loop, memchr per field,
+///             tags through std::string + std::stoi, price
+///             through std::stod and rounded to ticks
+///   decoder   FixDecoder (SIMD SOH scan and checksum,
+///             integer-only PriceScale)
+///   + id      decoder, then the order's ClOrdID inserted
+///             into a ClientOrderMap, as the gateway does
+///
+/// Every path must reproduce the written orders. Encode
+/// times FixEncoder::execution_report() over a mix of New
+/// and fill reports. Best of three runs per row.
+///
+/// Usage: bench_fix [messages]
+/// --------------------------------------------------------
+
+#include "client_order_map.hpp"
+#include "fix.hpp"
+#include "time_utils.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Stream {
+    std::string bytes;
+    std::vector<lob::Order> orders;
+    std::vector<std::string> clordids;
+};
+
+Stream make_stream(std::size_t count) {
+    std::mt19937_64 rng(11);
+    lob::FixEncoder encoder("CLIENT", "LOB");
+    Stream s;
+    s.bytes.reserve(count * 160);
+    char out[lob::FixEncoder::kMaxMessage];
+    for (std::size_t i = 0; i < count; ++i) {
+        lob::Order order;
+        order.side = rng() % 2 ? lob::Side::Buy : lob::Side::Sell;
+        order.price = 9'900 + static_cast<std::int64_t>(rng() % 201);
+        order.qty = 1 + static_cast<std::int64_t>(rng() % 1'000);
+        order.account = rng() % 4 == 0 ? static_cast<std::uint32_t>(1 + rng() % 100) : 0;
+        auto clordid = "ORD" + std::to_string(10'000 + i * 7 + rng() % 7);
+        s.bytes += encoder.new_order(order, clordid, 1'700'000'000'000'000'000ULL + i, out);
+        s.orders.push_back(order);
+        s.clordids.push_back(std::move(clordid));
+    }
+    return s;
+}
+
+/// The straightforward tag=value parser: no SIMD, a std::string per tag,
+/// the price as a double.
+bool naive_decode(const char* data, std::size_t size, lob::FixMessage& out, std::size_t& length) {
+    const char* body_length = data + lob::fix::kBeginString.size() + 2;
+    const auto body = static_cast<std::size_t>(std::strchr(body_length, lob::fix::kSoh) - data) + 1;
+    const auto trailer = body + static_cast<std::size_t>(std::atoi(body_length));
+    if (trailer + lob::fix::kTrailerLength > size) {
+        return false;
+    }
+    unsigned sum = 0;
+    for (std::size_t i = 0; i < trailer; ++i) {
+        sum += static_cast<unsigned char>(data[i]);
+    }
+    if (sum % 256 != static_cast<unsigned>(std::atoi(data + trailer + 3))) {
+        return false;
+    }
+    out = lob::FixMessage{};
+    const char* p = data + body;
+    const char* end = data + trailer;
+    while (p < end) {
+        const char* soh = static_cast<const char*>(std::memchr(p, lob::fix::kSoh, static_cast<std::size_t>(end - p)));
+        const char* eq = static_cast<const char*>(std::memchr(p, '=', static_cast<std::size_t>(soh - p)));
+        const int tag = std::stoi(std::string(p, eq));
+        const std::string_view value(eq + 1, static_cast<std::size_t>(soh - eq - 1));
+        switch (tag) {
+        case 35:
+            out.type = value == "D" ? lob::FixMsgType::NewOrderSingle : lob::FixMsgType::Other;
+            break;
+        case 11:
+            out.clordid = value;
+            break;
+        case 54:
+            out.order.side = value == "1" ? lob::Side::Buy : lob::Side::Sell;
+            break;
+        case 38:
+            out.order.qty = std::stoll(std::string(value));
+            break;
+        case 44:
+            out.order.price = std::llround(std::stod(std::string(value)) * 100.0);
+            break;
+        case 1:
+            out.order.account = static_cast<std::uint32_t>(std::stoul(std::string(value)));
+            break;
+        default:
+            break;
+        }
+        p = soh + 1;
+    }
+    length = trailer + lob::fix::kTrailerLength;
+    return true;
+}
+
+bool same(const lob::FixMessage& msg, const Stream& s, std::size_t i) {
+    const auto& o = s.orders[i];
+    return msg.type == lob::FixMsgType::NewOrderSingle && msg.clordid == s.clordids[i] &&
+           msg.order.side == o.side && msg.order.price == o.price && msg.order.qty == o.qty &&
+           msg.order.account == o.account;
+}
+
+template <typename Decode>
+double time_decode(const Stream& s, Decode&& decode) {
+    double best = 0.0;
+    for (int run = 0; run < 3; ++run) {
+        lob::FixMessage msg;
+        std::size_t pos = 0;
+        std::size_t i = 0;
+        bool ok = true;
+        const auto start = lob::now_ns();
+        while (pos < s.bytes.size()) {
+            std::size_t length = 0;
+            if (!decode(s.bytes.data() + pos, s.bytes.size() - pos, msg, length, i)) {
+                ok = false;
+                break;
+            }
+            ok = ok && (run > 0 || same(msg, s, i));
+            pos += length;
+            ++i;
+        }
+        const auto ns = static_cast<double>(lob::now_ns() - start);
+        if (!ok || i != s.orders.size()) {
+            std::cerr << "decode mismatch at message " << i << "\n";
+            std::exit(1);
+        }
+        best = run == 0 ? ns : std::min(best, ns);
+    }
+    return best;
+}
+
+void row(const char* name, double ns, std::size_t count, std::size_t bytes) {
+    std::cout << std::setw(9) << name << std::setw(10) << std::fixed << std::setprecision(1)
+              << ns / static_cast<double>(count) << std::setw(11) << static_cast<double>(bytes) * 1e3 / ns
+              << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const auto s = make_stream(count);
+    std::cout << "messages " << count << ", " << std::setprecision(1) << std::fixed
+              << static_cast<double>(s.bytes.size()) / static_cast<double>(count) << " bytes each\n";
+    std::cout << "     path    ns/msg       MB/s\n";
+
+    const lob::FixDecoder decoder;
+    const double naive = time_decode(s, [](const char* p, std::size_t n, lob::FixMessage& m, std::size_t& len,
+                                           std::size_t) { return naive_decode(p, n, m, len); });
+    const double fast = time_decode(s, [&](const char* p, std::size_t n, lob::FixMessage& m, std::size_t& len,
+                                           std::size_t) { return decoder.decode(p, n, m, len) == lob::FixError::None; });
+    lob::ClientOrderMap ids(count);
+    const double with_ids = time_decode(s, [&](const char* p, std::size_t n, lob::FixMessage& m, std::size_t& len,
+                                               std::size_t i) {
+        if (i == 0) {
+            ids.clear();
+        }
+        return decoder.decode(p, n, m, len) == lob::FixError::None &&
+               ids.insert(0, m.clordid, i + 1) == lob::ClientOrderMap::Insert::Ok;
+    });
+    row("naive", naive, count, s.bytes.size());
+    row("decoder", fast, count, s.bytes.size());
+    row("+ id", with_ids, count, s.bytes.size());
+    std::cout << "decoder speedup " << std::setprecision(2) << naive / fast << "x\n";
+
+    lob::FixEncoder encoder("LOB", "CLIENT");
+    char out[lob::FixEncoder::kMaxMessage];
+    std::size_t encoded = 0;
+    double best = 0.0;
+    for (int run = 0; run < 3; ++run) {
+        encoded = 0;
+        const auto start = lob::now_ns();
+        for (std::size_t i = 0; i < count; ++i) {
+            lob::ExecReport r;
+            r.exec_id = i + 1;
+            r.order_id = i + 1;
+            r.side = s.orders[i].side;
+            r.price = s.orders[i].price;
+            r.leaves_qty = s.orders[i].qty;
+            r.type = i % 3 == 0 ? lob::ExecType::Fill : lob::ExecType::New;
+            if (r.type == lob::ExecType::Fill) {
+                r.last_qty = r.cum_qty = r.leaves_qty;
+                r.leaves_qty = 0;
+            }
+            encoded += encoder.execution_report(r, s.clordids[i], 1'700'000'000'000'000'000ULL + i, out).size();
+        }
+        const auto ns = static_cast<double>(lob::now_ns() - start);
+        best = run == 0 ? ns : std::min(best, ns);
+    }
+    row("encode", best, count, encoded);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/// --------------------------------------------------------
+/// Interleaved multi-symbol matching vs symbol count and K
+///
+/// One engine per symbol; orders (a fifth of them cancels)
+/// arrive spread uniformly over the symbols. Every book is
+/// warmed with the first half of the stream, then the second
+/// half is timed through process_interleaved() with
+/// prefetch windows K = 0 (plain loop), 1, 2, 4, 8, 16.
+/// Each K must produce the K = 0 trades.
+///
+/// Best of three runs per cell.
+///
+/// Usage: bench_group_prefetch [orders]
+/// --------------------------------------------------------
+
+#include "group_match.hpp"
+#include "time_utils.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kWindows[] = {0, 1, 2, 4, 8, 16};
+
+std::vector<lob::RoutedOrder> make_orders(std::size_t n, std::uint32_t symbols) {
+    std::mt19937_64 rng(11);
+    std::vector<std::vector<std::uint64_t>> issued(symbols);
+    std::vector<lob::RoutedOrder> orders(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto& r = orders[i];
+        r.symbol = static_cast<std::uint32_t>(rng() % symbols);
+        auto& ids = issued[r.symbol];
+        if (!ids.empty() && rng() % 5 == 0) {
+            r.cancel = true;
+            r.order.id = ids[rng() % ids.size()];
+            continue;
+        }
+        r.order.id = i + 1;
+        r.order.side = rng() % 2 ? lob::Side::Buy : lob::Side::Sell;
+        r.order.price = 10'000 + static_cast<std::int64_t>(rng() % 17) - 8;
+        r.order.qty = 1 + static_cast<std::int64_t>(rng() % 100);
+        r.order.ts_ns = i;
+        ids.push_back(r.order.id);
+    }
+    return orders;
+}
+
+std::uint64_t checksum(const std::vector<lob::SymbolTrade>& trades) {
+    std::uint64_t sum = 0;
+    for (const auto& t : trades) {
+        sum = sum * 1'000'003 + t.symbol + t.trade.maker_id * 7 + static_cast<std::uint64_t>(t.trade.qty);
+    }
+    return sum;
+}
+
+struct Result {
+    double ns_per_order = 0.0;
+    std::uint64_t checksum = 0;
+};
+
+template <typename Book>
+Result run(const std::vector<lob::RoutedOrder>& orders, std::uint32_t symbols, std::size_t window) {
+    using Engine = lob::BasicMatchingEngine<Book>;
+    lob::LatencyStats latency;
+    latency.reserve(orders.size());
+    std::vector<std::unique_ptr<Engine>> engines;
+    for (std::uint32_t s = 0; s < symbols; ++s) {
+        engines.push_back(std::make_unique<Engine>(latency));
+    }
+
+    const auto half = orders.size() / 2;
+    std::vector<lob::SymbolTrade> trades;
+    trades.reserve(orders.size());
+    lob::process_interleaved(engines, orders.data(), half, 0, trades);
+    trades.clear();
+
+    const auto start = lob::now_ns();
+    lob::process_interleaved(engines, orders.data() + half, orders.size() - half, window, trades);
+    const auto ns = lob::now_ns() - start;
+    return {static_cast<double>(ns) / static_cast<double>(orders.size() - half), checksum(trades)};
+}
+
+template <typename Book>
+bool sweep(const char* name, std::size_t count) {
+    std::cout << "\n" << name << "\nsymbols |";
+    for (const auto k : kWindows) {
+        std::cout << "   K=" << std::setw(2) << k << " ns";
+    }
+    std::cout << " | best speedup\n";
+
+    bool ok = true;
+    for (const std::uint32_t symbols : {1u, 16u, 256u, 1024u, 4096u}) {
+        const auto orders = make_orders(count, symbols);
+        std::cout << std::setw(7) << symbols << " |";
+        double base = 0.0;
+        double best = 0.0;
+        std::uint64_t expected = 0;
+        for (const auto k : kWindows) {
+            auto r = run<Book>(orders, symbols, k);
+            for (int i = 1; i < 3; ++i) {
+                const auto again = run<Book>(orders, symbols, k);
+                r.ns_per_order = std::min(r.ns_per_order, again.ns_per_order);
+            }
+            if (k == 0) {
+                base = best = r.ns_per_order;
+                expected = r.checksum;
+            }
+            best = std::min(best, r.ns_per_order);
+            ok &= r.checksum == expected;
+            std::cout << std::setw(11) << std::fixed << std::setprecision(1) << r.ns_per_order
+                      << (r.checksum == expected ? " " : "!");
+        }
+        std::cout << " | " << std::setprecision(2) << base / best << "x\n";
+    }
+    return ok;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    std::cout << "orders " << count << " (first half warms the books, second half timed)\n";
+
+    bool ok = sweep<lob::OrderBook>("map-deque", count);
+    ok &= sweep<lob::FlatRingOrderBook>("flat-ring", count);
+    if (!ok) {
+        std::cout << "TRADE MISMATCH (marked !)\n";
+    }
+    return ok ? 0 : 1;
+}
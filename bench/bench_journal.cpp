@@ -0,0 +1,266 @@
+/// --------------------------------------------------------
+/// Trade log formats: size, encode and decode speed
+///
+/// Runs the --simulate order flow through a MatchingEngine
+/// and logs its trades (index, taker timestamp, taker and
+/// maker ids, price, qty, taker side) four ways:
+///
+///   csv       CsvWriter; decoded by splitting on commas
+///             and from_chars
+///   varint    row by row, each field the zigzag LEB128
+///             delta from the previous row's
+///   journal   JournalWriter without LZ: bit-packed columns
+///   +lz       the same, blocks LZ-compressed where that
+///             saves a sixteenth or more
+///
+/// Decoding rebuilds every column as int64s (side as its
+/// dictionary entry), checked against the input on the
+/// first run. "csv MB/s" is CSV bytes per second of decode,
+/// to compare against disk bandwidth. Best of three runs.
+///
+/// Usage: bench_journal [orders]
+/// --------------------------------------------------------
+
+#include "journal.hpp"
+#include "matching_engine.hpp"
+#include "sim.hpp"
+#include "time_utils.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+constexpr std::size_t kColumns = 7;
+constexpr std::size_t kSide = 6;
+
+using Table = std::vector<std::vector<std::int64_t>>; // [column][row]
+
+Table make_trades(std::size_t orders) {
+    lob::LatencyStats latency;
+    lob::MatchingEngine engine(latency);
+    std::vector<lob::Trade> trades;
+    Table t(kColumns);
+    lob::SimConfig cfg;
+    cfg.count = orders;
+    cfg.seed = 5;
+    lob::run_simulation(cfg, [&](const lob::Order& order) {
+        trades.clear();
+        engine.process(order, trades);
+        for (const auto& tr : trades) {
+            t[0].push_back(static_cast<std::int64_t>(t[0].size()));
+            t[1].push_back(static_cast<std::int64_t>(order.ts_ns));
+            t[2].push_back(static_cast<std::int64_t>(tr.taker_id));
+            t[3].push_back(static_cast<std::int64_t>(tr.maker_id));
+            t[4].push_back(tr.price);
+            t[5].push_back(tr.qty);
+            t[6].push_back(order.side == lob::Side::Buy ? 0 : 1);
+        }
+    });
+    return t;
+}
+
+constexpr std::string_view kNames[kColumns] = {"trade_idx", "ts_ns", "taker_id", "maker_id", "price", "qty", "side"};
+constexpr std::string_view kSides[2] = {"BUY", "SELL"};
+
+struct Cell {
+    double bytes = 0.0;
+    double encode_ns = 0.0;
+    double decode_ns = 0.0;
+};
+
+volatile std::int64_t g_sink = 0; // keeps decoded columns live
+
+/// Encode(table) -> bytes; decode(bytes, table&) -> ok. Times per row.
+template <typename Encode, typename Decode>
+Cell run(const Table& in, Encode&& encode, Decode&& decode) {
+    const auto rows = static_cast<double>(in[0].size());
+    Cell cell;
+    Table out(kColumns); // reused, so later runs do not page in fresh memory
+    for (int rep = 0; rep < 3; ++rep) {
+        const auto t0 = lob::now_ns();
+        const std::string bytes = encode(in);
+        for (auto& column : out) {
+            column.clear();
+        }
+        const auto t1 = lob::now_ns();
+        const bool ok = decode(bytes, out);
+        const auto t2 = lob::now_ns();
+        if (!ok || (rep == 0 && out != in)) {
+            std::cerr << "decode mismatch\n";
+            std::exit(1);
+        }
+        g_sink = out[4].empty() ? 0 : out[4].back();
+        const auto enc = static_cast<double>(t1 - t0) / rows;
+        const auto dec = static_cast<double>(t2 - t1) / rows;
+        cell.encode_ns = rep == 0 ? enc : std::min(cell.encode_ns, enc);
+        cell.decode_ns = rep == 0 ? dec : std::min(cell.decode_ns, dec);
+        cell.bytes = static_cast<double>(bytes.size()) / rows;
+    }
+    return cell;
+}
+
+std::string csv_encode(const Table& t) {
+    std::ostringstream out;
+    {
+        lob::CsvWriter csv(out);
+        for (const auto name : kNames) {
+            csv.field(name);
+        }
+        csv.end_row();
+        for (std::size_t i = 0; i < t[0].size(); ++i) {
+            for (std::size_t c = 0; c < kColumns; ++c) {
+                if (c == kSide) {
+                    csv.field(kSides[t[c][i]]);
+                } else {
+                    csv.field(t[c][i]);
+                }
+            }
+            csv.end_row();
+        }
+    }
+    return std::move(out).str();
+}
+
+bool csv_decode(const std::string& bytes, Table& t) {
+    const char* p = bytes.data();
+    const char* end = p + bytes.size();
+    std::vector<std::string_view> fields;
+    lob::journal::split_line(p, end, fields); // header
+    while (lob::journal::split_line(p, end, fields)) {
+        if (fields.size() != kColumns) {
+            return false;
+        }
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            std::int64_t v = 0;
+            if (c == kSide) {
+                v = fields[c] == kSides[1] ? 1 : 0;
+            } else if (std::from_chars(fields[c].data(), fields[c].data() + fields[c].size(), v).ec != std::errc{}) {
+                return false;
+            }
+            t[c].push_back(v);
+        }
+    }
+    return true;
+}
+
+std::string varint_encode(const Table& t) {
+    std::string out;
+    std::int64_t prev[kColumns] = {};
+    for (std::size_t i = 0; i < t[0].size(); ++i) {
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            const auto d = static_cast<std::uint64_t>(t[c][i]) - static_cast<std::uint64_t>(prev[c]);
+            prev[c] = t[c][i];
+            auto z = (d << 1) ^ static_cast<std::uint64_t>(static_cast<std::int64_t>(d) >> 63);
+            for (; z >= 0x80; z >>= 7) {
+                out.push_back(static_cast<char>(z | 0x80));
+            }
+            out.push_back(static_cast<char>(z));
+        }
+    }
+    return out;
+}
+
+bool varint_decode(const std::string& bytes, Table& t) {
+    const auto* p = reinterpret_cast<const std::uint8_t*>(bytes.data());
+    const auto* end = p + bytes.size();
+    std::int64_t prev[kColumns] = {};
+    while (p < end) {
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            std::uint64_t z = 0;
+            unsigned shift = 0;
+            do {
+                if (p == end || shift > 63) {
+                    return false;
+                }
+                z |= std::uint64_t{*p & 0x7Fu} << shift;
+                shift += 7;
+            } while (*p++ & 0x80);
+            const auto d = (z >> 1) ^ (~(z & 1) + 1);
+            prev[c] = static_cast<std::int64_t>(static_cast<std::uint64_t>(prev[c]) + d);
+            t[c].push_back(prev[c]);
+        }
+    }
+    return true;
+}
+
+std::string journal_encode(const Table& t, bool compress) {
+    std::ostringstream out;
+    std::vector<lob::JournalColumn> columns;
+    for (const auto name : kNames) {
+        columns.push_back({std::string(name), lob::JournalColumnKind::Int});
+    }
+    columns[kSide].kind = lob::JournalColumnKind::Text;
+    {
+        lob::JournalWriter writer(out, std::move(columns), compress);
+        for (std::size_t i = 0; i < t[0].size(); ++i) {
+            for (std::size_t c = 0; c < kColumns; ++c) {
+                if (c == kSide) {
+                    writer.field(kSides[t[c][i]]);
+                } else {
+                    writer.field(t[c][i]);
+                }
+            }
+            writer.end_row();
+        }
+    }
+    return std::move(out).str();
+}
+
+bool journal_decode(const std::string& bytes, Table& t) {
+    lob::JournalReader reader;
+    std::string error;
+    if (!reader.open(reinterpret_cast<const std::uint8_t*>(bytes.data()), bytes.size(), error)) {
+        return false;
+    }
+    lob::JournalBlock block;
+    while (reader.next(block, error)) {
+        for (std::size_t c = 0; c < kColumns; ++c) {
+            auto values = block.values[c].begin();
+            if (c == kSide) {
+                // Entry numbers are block-local: map them back to 0/1.
+                std::vector<std::int64_t> side;
+                for (const auto text : block.text[c]) {
+                    side.push_back(text == kSides[1] ? 1 : 0);
+                }
+                for (std::size_t i = 0; i < block.rows; ++i) {
+                    t[c].push_back(side[static_cast<std::size_t>(values[i])]);
+                }
+            } else {
+                t[c].insert(t[c].end(), values, values + static_cast<std::ptrdiff_t>(block.rows));
+            }
+        }
+    }
+    return error.empty();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t orders = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const auto trades = make_trades(orders);
+    std::cout << "trades " << trades[0].size() << " from " << orders
+              << " orders (bytes/row, ns/row encode and decode)\n";
+    std::cout << "   format  bytes  ratio   encode   decode  csv MB/s\n";
+
+    const auto csv = run(trades, csv_encode, csv_decode);
+    const auto row = [&](const char* name, const Cell& c) {
+        std::cout << std::setw(9) << name << std::fixed << std::setprecision(1) << std::setw(7) << c.bytes
+                  << std::setw(6) << csv.bytes / c.bytes << "x" << std::setw(9) << c.encode_ns << std::setw(9)
+                  << c.decode_ns << std::setw(10) << std::setprecision(0) << csv.bytes / c.decode_ns * 1e3
+                  << "\n";
+    };
+    row("csv", csv);
+    row("varint", run(trades, varint_encode, varint_decode));
+    row("journal", run(trades, [](const Table& t) { return journal_encode(t, false); }, journal_decode));
+    row("+lz", run(trades, [](const Table& t) { return journal_encode(t, true); }, journal_decode));
+    return 0;
+}
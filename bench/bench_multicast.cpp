@@ -0,0 +1,200 @@
+/// --------------------------------------------------------
+/// Trade fan-out to 1-4 consumers
+///
+/// The producer publishes trades in match-sized batches
+/// (1-16). Consumers, added in this order:
+///   journal  — after the producer
+///   mktdata  — gated on the journal
+///   risk     — after the producer
+///   dumper   — gated on mktdata and risk
+/// Each folds what it reads into a checksum, which must match
+/// the producer's.
+///
+/// Compared against copying: one single-consumer ring per
+/// consumer, the producer writing each trade once per ring.
+///
+/// Usage: bench_multicast [trades] [ring_capacity]
+/// --------------------------------------------------------
+
+#include "multicast_ring.hpp"
+#include "time_utils.hpp"
+#include "types.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::uint64_t fold(std::uint64_t sum, const lob::Trade& t) {
+    return sum * 31 + t.maker_id + static_cast<std::uint64_t>(t.qty);
+}
+
+std::vector<lob::Trade> make_trades(std::size_t n) {
+    std::mt19937_64 rng(5);
+    std::vector<lob::Trade> trades(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        auto& t = trades[i];
+        t.taker_id = i;
+        t.maker_id = rng() % 1'000'000;
+        t.price = 10'000 + static_cast<std::int64_t>(rng() % 100);
+        t.qty = 1 + static_cast<std::int64_t>(rng() % 100);
+    }
+    return trades;
+}
+
+/// Batch sizes as a match would produce them.
+std::vector<std::uint8_t> make_batches(std::size_t n) {
+    std::mt19937_64 rng(9);
+    std::vector<std::uint8_t> batches;
+    for (std::size_t done = 0; done < n;) {
+        const auto b = std::min<std::size_t>(1 + rng() % 16, n - done);
+        batches.push_back(static_cast<std::uint8_t>(b));
+        done += b;
+    }
+    return batches;
+}
+
+struct Result {
+    double mtrades_per_s = 0.0;
+    bool ok = false;
+};
+
+Result run_multicast(const std::vector<lob::Trade>& trades, const std::vector<std::uint8_t>& batches,
+                     std::size_t consumers, std::size_t capacity) {
+    lob::MulticastRing<lob::Trade> ring(capacity);
+    const auto journal = ring.add_consumer();
+    std::size_t ids[4] = {journal, 0, 0, 0};
+    if (consumers > 1) {
+        ids[1] = ring.add_consumer({journal});
+    }
+    if (consumers > 2) {
+        ids[2] = ring.add_consumer();
+    }
+    if (consumers > 3) {
+        ids[3] = ring.add_consumer({ids[1], ids[2]});
+    }
+
+    const auto last = static_cast<std::int64_t>(trades.size()) - 1;
+    std::vector<std::uint64_t> sums(consumers, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            std::uint64_t sum = 0;
+            lob::detail::Backoff backoff;
+            while (ring.cursor(ids[c]) < last) {
+                if (ring.poll(ids[c], [&](const lob::Trade& t, std::int64_t) { sum = fold(sum, t); }) == 0) {
+                    backoff.wait();
+                } else {
+                    backoff.spins = 0;
+                }
+            }
+            sums[c] = sum;
+        });
+    }
+
+    const auto start = lob::now_ns();
+    std::uint64_t expected = 0;
+    const auto* next = trades.data();
+    for (const auto b : batches) {
+        ring.publish(next, b);
+        for (std::size_t i = 0; i < b; ++i) {
+            expected = fold(expected, next[i]);
+        }
+        next += b;
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    const auto ns = lob::now_ns() - start;
+
+    Result r;
+    r.mtrades_per_s = static_cast<double>(trades.size()) * 1e3 / static_cast<double>(ns);
+    r.ok = true;
+    for (const auto s : sums) {
+        r.ok &= s == expected;
+    }
+    return r;
+}
+
+Result run_copying(const std::vector<lob::Trade>& trades, const std::vector<std::uint8_t>& batches,
+                   std::size_t consumers, std::size_t capacity) {
+    std::vector<std::unique_ptr<lob::MulticastRing<lob::Trade>>> rings;
+    for (std::size_t c = 0; c < consumers; ++c) {
+        rings.push_back(std::make_unique<lob::MulticastRing<lob::Trade>>(capacity));
+        rings.back()->add_consumer();
+    }
+
+    const auto last = static_cast<std::int64_t>(trades.size()) - 1;
+    std::vector<std::uint64_t> sums(consumers, 0);
+    std::vector<std::thread> threads;
+    for (std::size_t c = 0; c < consumers; ++c) {
+        threads.emplace_back([&, c] {
+            auto& ring = *rings[c];
+            std::uint64_t sum = 0;
+            lob::detail::Backoff backoff;
+            while (ring.cursor(0) < last) {
+                if (ring.poll(0, [&](const lob::Trade& t, std::int64_t) { sum = fold(sum, t); }) == 0) {
+                    backoff.wait();
+                } else {
+                    backoff.spins = 0;
+                }
+            }
+            sums[c] = sum;
+        });
+    }
+
+    const auto start = lob::now_ns();
+    std::uint64_t expected = 0;
+    const auto* next = trades.data();
+    for (const auto b : batches) {
+        for (auto& ring : rings) {
+            ring->publish(next, b);
+        }
+        for (std::size_t i = 0; i < b; ++i) {
+            expected = fold(expected, next[i]);
+        }
+        next += b;
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+    const auto ns = lob::now_ns() - start;
+
+    Result r;
+    r.mtrades_per_s = static_cast<double>(trades.size()) * 1e3 / static_cast<double>(ns);
+    r.ok = true;
+    for (const auto s : sums) {
+        r.ok &= s == expected;
+    }
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    const std::size_t capacity = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8192;
+
+    const auto trades = make_trades(count);
+    const auto batches = make_batches(count);
+
+    std::cout << "trades " << count << ", ring " << capacity << " x " << sizeof(lob::Trade) << " B, "
+              << std::thread::hardware_concurrency() << " hardware threads\n"
+              << "consumers | multicast Mtrades/s | per-consumer copy Mtrades/s\n";
+    bool ok = true;
+    for (std::size_t c = 1; c <= 4; ++c) {
+        const auto multicast = run_multicast(trades, batches, c, capacity);
+        const auto copying = run_copying(trades, batches, c, capacity);
+        ok &= multicast.ok && copying.ok;
+        std::cout << std::setw(9) << c << " | " << std::fixed << std::setprecision(1) << std::setw(19)
+                  << multicast.mtrades_per_s << " | " << std::setw(27) << copying.mtrades_per_s
+                  << (multicast.ok && copying.ok ? "" : "  CHECKSUM MISMATCH") << "\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,265 @@
+/// --------------------------------------------------------
+/// parse -> risk -> match -> publish, three ways
+///
+///   loop       — one loop per line, as main.cpp's --stdin:
+///                getline, parse, process, write trades
+///   coroutine  — run_pipeline(): the stages as coroutines
+///                on one thread, linked by bounded channels
+///   threaded   — one thread per stage group (parse+risk,
+///                match, publish) linked by SPSC rings
+///
+/// Input is an in-memory order stream (a fifth of it
+/// cancels); output goes to a sink that hashes every byte,
+/// so all three must write the same trade CSV.
+///
+/// Best of three runs each.
+///
+/// Usage: bench_pipeline [orders] [channel_capacity]
+/// --------------------------------------------------------
+
+#include "multicast_ring.hpp"
+#include "pipeline.hpp"
+#include "time_utils.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Discards output, keeping an FNV-1a hash of it.
+class HashSink : public std::streambuf {
+public:
+    std::uint64_t hash = 14'695'981'039'346'656'037ull;
+
+protected:
+    int_type overflow(int_type c) override {
+        if (c != traits_type::eof()) {
+            add(static_cast<char>(c));
+        }
+        return c;
+    }
+
+    std::streamsize xsputn(const char* s, std::streamsize n) override {
+        for (std::streamsize i = 0; i < n; ++i) {
+            add(s[i]);
+        }
+        return n;
+    }
+
+private:
+    void add(char c) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * 1'099'511'628'211ull;
+    }
+};
+
+std::string make_input(std::size_t n) {
+    std::mt19937_64 rng(3);
+    const lob::PriceScale scale;
+    std::string text;
+    text.reserve(n * 16);
+    for (std::size_t i = 1; i <= n; ++i) {
+        if (i > 1 && rng() % 5 == 0) {
+            text += "C " + std::to_string(1 + rng() % (i - 1)) + "\n";
+            continue;
+        }
+        text += rng() % 2 ? "B " : "S ";
+        text += scale.to_string(9'950 + static_cast<std::int64_t>(rng() % 101));
+        text += ' ';
+        text += std::to_string(1 + rng() % 100);
+        text += '\n';
+    }
+    return text;
+}
+
+struct Result {
+    double ns_per_msg = 0.0;
+    std::size_t trades = 0;
+    std::uint64_t hash = 0;
+};
+
+Result run_loop(const std::string& input, std::size_t orders) {
+    lob::LatencyStats latency;
+    latency.reserve(orders);
+    lob::MatchingEngine engine(latency);
+    const lob::PriceScale scale;
+    std::istringstream in(input);
+    HashSink sink;
+    std::ostream out(&sink);
+    Result r;
+
+    const auto start = lob::now_ns();
+    {
+        lob::CsvWriter csv(out);
+        csv.field("taker_id").field("maker_id").field("price").field("qty").end_row();
+        std::vector<lob::Trade> trades;
+        lob::PipelineMessage msg;
+        std::string line;
+        std::uint64_t lines = 0;
+        while (std::getline(in, line)) {
+            if (!lob::parse_message(line, scale, ++lines, msg)) {
+                continue;
+            }
+            if (msg.cancel) {
+                engine.cancel(msg.order.id);
+                continue;
+            }
+            if (!lob::OrderBook::fits(msg.order)) {
+                continue;
+            }
+            engine.process(msg.order, trades);
+            for (const auto& t : trades) {
+                csv.field(t.taker_id).field(t.maker_id).field(t.price).field(t.qty).end_row();
+            }
+            r.trades += trades.size();
+            trades.clear();
+        }
+    }
+    r.ns_per_msg = static_cast<double>(lob::now_ns() - start) / static_cast<double>(orders);
+    r.hash = sink.hash;
+    return r;
+}
+
+Result run_coroutine(const std::string& input, std::size_t orders, std::size_t capacity) {
+    lob::LatencyStats latency;
+    latency.reserve(orders);
+    lob::MatchingEngine engine(latency);
+    std::istringstream in(input);
+    HashSink sink;
+    std::ostream out(&sink);
+
+    const auto start = lob::now_ns();
+    const auto stats = lob::run_pipeline(engine, in, out, lob::PriceScale{}, capacity);
+    Result r;
+    r.ns_per_msg = static_cast<double>(lob::now_ns() - start) / static_cast<double>(orders);
+    r.trades = stats.trades;
+    r.hash = sink.hash;
+    return r;
+}
+
+/// Consume `ring` on this thread until `last` (set by the producer
+/// once it is done) has been handled.
+template <typename T, typename Fn>
+void drain(lob::MulticastRing<T>& ring, const std::atomic<std::int64_t>& last, Fn&& fn) {
+    lob::detail::Backoff backoff;
+    for (;;) {
+        if (ring.poll(0, fn) > 0) {
+            backoff.spins = 0;
+            continue;
+        }
+        const auto end = last.load(std::memory_order_acquire);
+        if (end != -2 && ring.cursor(0) == end) {
+            return;
+        }
+        backoff.wait();
+    }
+}
+
+Result run_threaded(const std::string& input, std::size_t orders, std::size_t capacity) {
+    lob::LatencyStats latency;
+    latency.reserve(orders);
+    lob::MatchingEngine engine(latency);
+    std::istringstream in(input);
+    HashSink sink;
+    std::ostream out(&sink);
+
+    lob::MulticastRing<lob::PipelineMessage> messages(capacity);
+    lob::MulticastRing<lob::Trade> trades_out(capacity);
+    messages.add_consumer();
+    trades_out.add_consumer();
+    std::atomic<std::int64_t> last_message{-2};
+    std::atomic<std::int64_t> last_trade{-2};
+    Result r;
+
+    const auto start = lob::now_ns();
+    std::thread publisher([&] {
+        lob::CsvWriter csv(out);
+        csv.field("taker_id").field("maker_id").field("price").field("qty").end_row();
+        drain(trades_out, last_trade, [&](const lob::Trade& t, std::int64_t) {
+            csv.field(t.taker_id).field(t.maker_id).field(t.price).field(t.qty).end_row();
+            ++r.trades;
+        });
+    });
+    std::thread matcher([&] {
+        std::vector<lob::Trade> trades;
+        drain(messages, last_message, [&](const lob::PipelineMessage& msg, std::int64_t) {
+            if (msg.cancel) {
+                engine.cancel(msg.order.id);
+                return;
+            }
+            engine.process(msg.order, trades);
+            if (!trades.empty()) {
+                trades_out.publish(trades.data(), trades.size());
+                trades.clear();
+            }
+        });
+        last_trade.store(trades_out.published(), std::memory_order_release);
+    });
+
+    lob::ChunkedLineReader reader(in);
+    lob::PipelineMessage msg;
+    std::string_view line;
+    std::uint64_t lines = 0;
+    while (reader.fill()) {
+        while (reader.next_line(line)) {
+            if (lob::parse_message(line, lob::PriceScale{}, ++lines, msg) &&
+                (msg.cancel || lob::OrderBook::fits(msg.order))) {
+                messages.publish(&msg, 1);
+            }
+        }
+    }
+    last_message.store(messages.published(), std::memory_order_release);
+    matcher.join();
+    publisher.join();
+
+    r.ns_per_msg = static_cast<double>(lob::now_ns() - start) / static_cast<double>(orders);
+    r.hash = sink.hash;
+    return r;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t orders = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+    const std::size_t capacity = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+
+    const auto input = make_input(orders);
+    std::cout << "messages " << orders << " (" << input.size() / 1024 << " KiB), channel " << capacity << ", "
+              << std::thread::hardware_concurrency() << " hardware threads\n"
+              << "pipeline  | ns/msg | trades\n";
+
+    // Best of three: the run is short enough for one noisy neighbour
+    // to swing it.
+    const auto best_of = [](auto&& run) {
+        auto best = run();
+        for (int i = 1; i < 3; ++i) {
+            const auto r = run();
+            best = r.ns_per_msg < best.ns_per_msg ? r : best;
+        }
+        return best;
+    };
+    const auto loop = best_of([&] { return run_loop(input, orders); });
+    const auto coroutine = best_of([&] { return run_coroutine(input, orders, capacity); });
+    const auto threaded = best_of([&] { return run_threaded(input, orders, capacity); });
+    const auto print = [](const char* name, const Result& r) {
+        std::cout << std::left << std::setw(9) << name << std::right << " | " << std::fixed << std::setprecision(1)
+                  << std::setw(6) << r.ns_per_msg << " | " << r.trades << "\n";
+    };
+    print("loop", loop);
+    print("coroutine", coroutine);
+    print("threaded", threaded);
+
+    const bool ok = coroutine.hash == loop.hash && threaded.hash == loop.hash;
+    if (!ok) {
+        std::cout << "OUTPUT MISMATCH\n";
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,97 @@
+/// --------------------------------------------------------
+/// Pre-trade risk cost with 10k accounts
+///
+/// 1. check() alone over a pre-generated stream of orders
+///    spread across the accounts (one table line each).
+/// 2. check() + on_rest() — the accepted-order path.
+/// 3. Engine throughput with and without the risk stage.
+///
+/// Usage: bench_risk [orders] [accounts]
+/// --------------------------------------------------------
+
+#include "matching_engine.hpp"
+#include "sim.hpp"
+#include "time_utils.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+namespace {
+
+lob::RiskLimits bench_limits() {
+    lob::RiskLimits limits;
+    limits.max_order_qty = 95;
+    limits.max_notional = 950'000;
+    limits.max_position = 1'000'000;
+    limits.max_open_orders = 1'000'000;
+    limits.max_price_distance = 40;
+    return limits;
+}
+
+template <typename Fn>
+double ns_per_order(std::size_t count, Fn&& fn) {
+    const auto start = lob::now_ns();
+    fn();
+    return static_cast<double>(lob::now_ns() - start) / static_cast<double>(count);
+}
+
+double engine_ns(const std::vector<lob::Order>& orders, std::uint32_t accounts) {
+    lob::LatencyStats latency;
+    latency.reserve(orders.size());
+    lob::MatchingEngine engine(latency);
+    if (accounts > 0) {
+        engine.risk().assign(accounts, bench_limits());
+    }
+    std::vector<lob::Trade> trades;
+    return ns_per_order(orders.size(), [&] {
+        for (const auto& order : orders) {
+            engine.process(order, trades);
+            trades.clear();
+        }
+    });
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 5'000'000;
+    const auto accounts = static_cast<std::uint32_t>(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 10'000);
+
+    lob::SimConfig cfg;
+    cfg.count = count;
+    cfg.accounts = accounts;
+    std::vector<lob::Order> orders;
+    orders.reserve(count);
+    lob::run_simulation(cfg, [&](const lob::Order& order) { orders.push_back(order); });
+
+    lob::PreTradeRisk risk;
+    risk.assign(accounts, bench_limits());
+    std::size_t rejected = 0;
+    const auto check_ns = ns_per_order(count, [&] {
+        for (const auto& order : orders) {
+            rejected += risk.check(order, 9'990, 10'010) != lob::RejectReason::None;
+        }
+    });
+
+    risk.assign(accounts, bench_limits());
+    const auto accept_ns = ns_per_order(count, [&] {
+        for (const auto& order : orders) {
+            if (risk.check(order, 9'990, 10'010) == lob::RejectReason::None) {
+                risk.on_rest(order);
+            }
+        }
+    });
+
+    const auto plain_ns = engine_ns(orders, 0);
+    const auto checked_ns = engine_ns(orders, accounts);
+
+    std::cout << count << " orders over " << accounts << " accounts ("
+              << sizeof(lob::AccountRisk) * accounts / 1024 << " KiB table)\n"
+              << "check only:        " << check_ns << " ns/order (" << rejected << " rejected)\n"
+              << "check + on_rest:   " << accept_ns << " ns/order\n"
+              << "engine, no risk:   " << plain_ns << " ns/order\n"
+              << "engine, with risk: " << checked_ns << " ns/order (+" << checked_ns - plain_ns << ")\n";
+    return 0;
+}
@@ -0,0 +1,288 @@
+/// --------------------------------------------------------
+/// Binary codec: SBE flyweights vs raw structs vs FIX
+///
+/// N orders (and one execution report each) are encoded
+/// back to back into one buffer and decoded again, four
+/// ways:
+///
+///   raw      memcpy of the in-memory Order / ExecReport
+///            (host layout and padding; not a wire format)
+///   sbe      wire.hpp messages, little-endian (native here)
+///   sbe-be   the same fields in a big-endian schema: one
+///            bswap per field
+///   fix      FixEncoder / FixDecoder tag=value, for scale
+///
+/// Decoding walks the framed stream and rebuilds every
+/// Order / ExecReport, checked against the input on the
+/// first run. Best of three runs per cell.
+///
+/// Usage: bench_sbe [messages]
+/// --------------------------------------------------------
+
+#include "fix.hpp"
+#include "time_utils.hpp"
+#include "wire.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+using namespace lob::wire;
+
+using BigSchema = lob::sbe::Schema<1, 2, std::endian::big>;
+using BigNewOrder = lob::sbe::Message<BigSchema, 1, OrderSide, Price, Qty, OrderAccount>;
+using BigReport = lob::sbe::Message<BigSchema, 3, ExecId, OrderId, ContraId, Price, LastQty, LeavesQty, CumQty,
+                                    Account, Type, OrderSide, Reason>;
+
+struct Input {
+    std::vector<lob::Order> orders;
+    std::vector<lob::ExecReport> reports;
+};
+
+Input make_input(std::size_t count) {
+    std::mt19937_64 rng(3);
+    Input in;
+    for (std::size_t i = 0; i < count; ++i) {
+        lob::Order o;
+        o.id = i + 1;
+        o.side = rng() % 2 ? lob::Side::Buy : lob::Side::Sell;
+        o.price = 9'900 + static_cast<std::int64_t>(rng() % 201);
+        o.qty = 1 + static_cast<std::int64_t>(rng() % 1'000);
+        o.account = static_cast<std::uint32_t>(rng() % 100);
+        in.orders.push_back(o);
+        lob::ExecReport r;
+        r.exec_id = i + 1;
+        r.order_id = o.id;
+        r.contra_id = rng() % 2 ? i : 0;
+        r.price = o.price;
+        r.last_qty = r.contra_id ? o.qty / 2 : 0;
+        r.leaves_qty = o.qty - r.last_qty;
+        r.cum_qty = r.last_qty;
+        r.account = o.account;
+        r.type = r.contra_id ? lob::ExecType::PartialFill : lob::ExecType::New;
+        r.side = o.side;
+        in.reports.push_back(r);
+    }
+    return in;
+}
+
+bool same(const lob::Order& a, const lob::Order& b) {
+    return a.side == b.side && a.price == b.price && a.qty == b.qty && a.account == b.account;
+}
+
+bool same(const lob::ExecReport& a, const lob::ExecReport& b) {
+    return a.exec_id == b.exec_id && a.order_id == b.order_id && a.contra_id == b.contra_id && a.price == b.price &&
+           a.last_qty == b.last_qty && a.leaves_qty == b.leaves_qty && a.cum_qty == b.cum_qty &&
+           a.account == b.account && a.type == b.type && a.side == b.side && a.reason == b.reason;
+}
+
+template <typename M>
+std::size_t put_order(const lob::Order& o, std::byte* out) {
+    lob::sbe::Encoder<M> m(out);
+    m.template set<OrderSide>(o.side).template set<Price>(o.price).template set<Qty>(o.qty);
+    m.template set<OrderAccount>(o.account);
+    return m.size;
+}
+
+template <typename M>
+lob::Order get_order(const lob::sbe::Reader<M>& m) {
+    lob::Order o;
+    o.side = m.template get<OrderSide>();
+    o.price = m.template get<Price>();
+    o.qty = m.template get<Qty>();
+    o.account = m.template get<OrderAccount>();
+    return o;
+}
+
+template <typename M>
+std::size_t put_report(const lob::ExecReport& r, std::byte* out) {
+    lob::sbe::Encoder<M> m(out);
+    m.template set<ExecId>(r.exec_id).template set<OrderId>(r.order_id).template set<ContraId>(r.contra_id);
+    m.template set<Price>(r.price).template set<LastQty>(r.last_qty).template set<LeavesQty>(r.leaves_qty);
+    m.template set<CumQty>(r.cum_qty).template set<Account>(r.account).template set<Type>(r.type);
+    m.template set<OrderSide>(r.side).template set<Reason>(r.reason);
+    return m.size;
+}
+
+template <typename M>
+lob::ExecReport get_report(const lob::sbe::Reader<M>& m) {
+    lob::ExecReport r;
+    r.exec_id = m.template get<ExecId>();
+    r.order_id = m.template get<OrderId>();
+    r.contra_id = m.template get<ContraId>();
+    r.price = m.template get<Price>();
+    r.last_qty = m.template get<LastQty>();
+    r.leaves_qty = m.template get<LeavesQty>();
+    r.cum_qty = m.template get<CumQty>();
+    r.account = m.template get<Account>();
+    r.type = m.template get<Type>();
+    r.side = m.template get<OrderSide>();
+    r.reason = m.template get<Reason>();
+    return r;
+}
+
+volatile std::int64_t g_sink = 0; // keeps decoded items live
+
+/// A codec is encode(item, out) -> bytes written, and decode(p, size,
+/// item&) -> bytes consumed (0 on error).
+struct Cell {
+    double encode_ns = 0.0;
+    double decode_ns = 0.0;
+    double bytes = 0.0;
+    bool decoded = true; // false: decode not measured, printed as -
+};
+
+template <typename T, typename Encode, typename Decode>
+Cell run(const std::vector<T>& items, Encode&& encode, Decode&& decode) {
+    std::vector<std::byte> buf(items.size() * 512);
+    Cell cell;
+    std::size_t used = 0;
+    for (int rep = 0; rep < 3; ++rep) {
+        const auto t0 = lob::now_ns();
+        used = 0;
+        for (const auto& item : items) {
+            used += encode(item, buf.data() + used);
+        }
+        const auto t1 = lob::now_ns();
+        std::size_t pos = 0;
+        std::size_t i = 0;
+        bool ok = true;
+        std::int64_t sum = 0;
+        T item;
+        while (pos < used) {
+            const auto n = decode(buf.data() + pos, used - pos, item);
+            ok = ok && n > 0 && (rep > 0 || same(item, items[i]));
+            if (n == 0) {
+                break;
+            }
+            sum += item.price;
+            pos += n;
+            ++i;
+        }
+        const auto t2 = lob::now_ns();
+        g_sink = sum;
+        if (!ok || i != items.size()) {
+            std::cerr << "decode mismatch at message " << i << "\n";
+            std::exit(1);
+        }
+        const auto n = static_cast<double>(items.size());
+        const auto enc = static_cast<double>(t1 - t0) / n;
+        const auto dec = static_cast<double>(t2 - t1) / n;
+        cell.encode_ns = rep == 0 ? enc : std::min(cell.encode_ns, enc);
+        cell.decode_ns = rep == 0 ? dec : std::min(cell.decode_ns, dec);
+    }
+    cell.bytes = static_cast<double>(used) / static_cast<double>(items.size());
+    return cell;
+}
+
+template <typename T>
+std::size_t raw_put(const T& item, std::byte* out) {
+    std::memcpy(out, &item, sizeof(T));
+    return sizeof(T);
+}
+
+template <typename T>
+std::size_t raw_get(const std::byte* p, std::size_t, T& item) {
+    std::memcpy(&item, p, sizeof(T));
+    return sizeof(T);
+}
+
+template <typename S, typename M, typename T, typename Get>
+std::size_t sbe_get(const std::byte* p, std::size_t size, T& item, Get&& get) {
+    lob::sbe::Frame frame;
+    if (lob::sbe::decode<S, M>(p, size, frame) != lob::sbe::Error::None) {
+        return 0;
+    }
+    item = get(frame.get<M>());
+    return frame.length;
+}
+
+void row(const char* name, const Cell& orders, const Cell& reports) {
+    std::cout << std::setw(7) << name << std::fixed << std::setprecision(1);
+    for (const auto& c : {orders, reports}) {
+        std::cout << std::setw(9) << c.encode_ns;
+        if (c.decoded) {
+            std::cout << std::setw(9) << c.decode_ns;
+        } else {
+            std::cout << std::setw(9) << "-";
+        }
+        std::cout << std::setw(7) << c.bytes;
+    }
+    std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+    const auto in = make_input(count);
+    std::cout << "messages " << count << " (ns/msg encode, decode; bytes/msg)\n";
+    std::cout << "  codec  order:enc      dec  bytes report:enc     dec  bytes\n";
+
+    row("raw", run(in.orders, raw_put<lob::Order>, raw_get<lob::Order>),
+        run(in.reports, raw_put<lob::ExecReport>, raw_get<lob::ExecReport>));
+    row("sbe", run(in.orders, put_order<NewOrder>, [](const std::byte* p, std::size_t n, lob::Order& o) {
+            return sbe_get<Schema, NewOrder>(p, n, o, [](const auto& m) { return get_order<NewOrder>(m); });
+        }),
+        run(in.reports, put_report<ExecutionReport>, [](const std::byte* p, std::size_t n, lob::ExecReport& r) {
+            return sbe_get<Schema, ExecutionReport>(p, n, r,
+                                                    [](const auto& m) { return get_report<ExecutionReport>(m); });
+        }));
+    row("sbe-be", run(in.orders, put_order<BigNewOrder>, [](const std::byte* p, std::size_t n, lob::Order& o) {
+            return sbe_get<BigSchema, BigNewOrder>(p, n, o, [](const auto& m) { return get_order<BigNewOrder>(m); });
+        }),
+        run(in.reports, put_report<BigReport>, [](const std::byte* p, std::size_t n, lob::ExecReport& r) {
+            return sbe_get<BigSchema, BigReport>(p, n, r, [](const auto& m) { return get_report<BigReport>(m); });
+        }));
+
+    // FIX: orders as NewOrderSingle; reports only encode (there is no
+    // ExecutionReport decoder), so their decode column is -.
+    lob::FixEncoder client("CLIENT", "LOB");
+    const lob::FixDecoder decoder;
+    const auto fix_orders = run(
+        in.orders,
+        [&](const lob::Order& o, std::byte* out) {
+            // The encoder builds the header in front of the body: copy the view out.
+            char clordid[24];
+            char msg[lob::FixEncoder::kMaxMessage];
+            const auto end = std::to_chars(clordid, clordid + sizeof(clordid), o.id).ptr;
+            const auto v = client.new_order(o, {clordid, static_cast<std::size_t>(end - clordid)}, 0, msg);
+            std::memcpy(out, v.data(), v.size());
+            return v.size();
+        },
+        [&](const std::byte* p, std::size_t n, lob::Order& o) -> std::size_t {
+            lob::FixMessage msg;
+            std::size_t length = 0;
+            if (decoder.decode(reinterpret_cast<const char*>(p), n, msg, length) != lob::FixError::None) {
+                return 0;
+            }
+            o = msg.order;
+            return length;
+        });
+    lob::FixEncoder venue("LOB", "CLIENT");
+    Cell fix_reports;
+    fix_reports.decoded = false;
+    {
+        char out[lob::FixEncoder::kMaxMessage];
+        for (int rep = 0; rep < 3; ++rep) {
+            std::size_t bytes = 0;
+            const auto t0 = lob::now_ns();
+            for (const auto& r : in.reports) {
+                bytes += venue.execution_report(r, "ORD", 0, out).size();
+            }
+            const auto ns = static_cast<double>(lob::now_ns() - t0) / static_cast<double>(count);
+            fix_reports.encode_ns = rep == 0 ? ns : std::min(fix_reports.encode_ns, ns);
+            fix_reports.bytes = static_cast<double>(bytes) / static_cast<double>(count);
+        }
+    }
+    row("fix", fix_orders, fix_reports);
+    return 0;
+}
@@ -0,0 +1,94 @@
+/// --------------------------------------------------------
+/// Throttle cost per message at 10M msg/s
+///
+/// Replays a stream arriving at 10M msg/s (synthetic TSC
+/// timestamps 100 ns apart) spread over the accounts, with
+/// a per-account rate that lets about half of it through
+/// (reject mode), or one just above the arrival rate so the
+/// queue absorbs bursts (queue mode). Also times admit()
+/// with a live read_tsc() per message.
+///
+/// Messages cycle through a cache-resident pool of orders so
+/// the stream itself does not turn this into a memory test.
+///
+/// Usage: bench_throttle [messages] [accounts]
+/// --------------------------------------------------------
+
+#include "throttle.hpp"
+#include "time_utils.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace {
+
+constexpr double kArrivalRate = 10'000'000.0;
+constexpr std::size_t kPoolSize = 1 << 16;
+
+struct Result {
+    double ns_per_msg = 0.0;
+    lob::ThrottleCounters counters;
+};
+
+/// load: arrival rate over the accounts' combined limit.
+Result replay(const std::vector<lob::Order>& pool, std::size_t count, std::uint32_t accounts, double load,
+              lob::ThrottleAction action, double tsc_hz, bool live_clock) {
+    lob::ThrottleConfig cfg;
+    cfg.account_rate = kArrivalRate / load / accounts;
+    cfg.account_burst = 4;
+    cfg.action = action;
+    cfg.accounts = accounts;
+    lob::Throttle throttle;
+    throttle.configure(cfg, tsc_hz);
+
+    const auto spacing = tsc_hz / kArrivalRate;
+    std::uint64_t sink = 0;
+    const auto start = lob::now_ns();
+    auto ts = static_cast<double>(lob::read_tsc());
+    for (std::size_t i = 0; i < count; ++i) {
+        const auto& order = pool[i & (kPoolSize - 1)];
+        ts += spacing;
+        const auto now = live_clock ? lob::read_tsc() : static_cast<std::uint64_t>(ts);
+        if (throttle.queued() > 0) {
+            throttle.release_due(now, [&](const lob::Order& o) { sink += o.id; });
+        }
+        sink += static_cast<std::uint64_t>(throttle.admit(order, now));
+    }
+    const auto elapsed = lob::now_ns() - start;
+    if (sink == 42) {
+        std::cout << "";
+    }
+    return {static_cast<double>(elapsed) / static_cast<double>(count), throttle.counters()};
+}
+
+void print(const char* name, const Result& r) {
+    std::cout << name << " " << r.ns_per_msg << " ns/msg  admitted " << r.counters.admitted
+              << ", rejected " << r.counters.rejected << ", queued " << r.counters.queued
+              << ", released " << r.counters.released << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t count = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+    const auto accounts = static_cast<std::uint32_t>(argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 1'000);
+
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<std::uint32_t> account(0, accounts - 1);
+    std::vector<lob::Order> pool(kPoolSize);
+    for (std::size_t i = 0; i < kPoolSize; ++i) {
+        pool[i].id = i + 1;
+        pool[i].account = account(rng);
+    }
+
+    const auto tsc_hz = lob::tsc_ticks_per_second();
+    std::cout << count << " messages at 10M msg/s over " << accounts << " accounts (TSC "
+              << tsc_hz / 1e9 << " GHz, budget 100 ns/msg)\n";
+    print("reject mode, 2x load:   ", replay(pool, count, accounts, 2.0, lob::ThrottleAction::Reject, tsc_hz, false));
+    print("queue mode, 0.9x load:  ", replay(pool, count, accounts, 0.9, lob::ThrottleAction::Queue, tsc_hz, false));
+    print("reject mode, live rdtsc:", replay(pool, count, accounts, 2.0, lob::ThrottleAction::Reject, tsc_hz, true));
+    return 0;
+}
@@ -0,0 +1,87 @@
+#pragma once
+/// --------------------------------------------------------
+/// Fill allocation policies for an incoming order that
+/// does not clear a whole price level
+///
+/// • FifoAllocation           — price-time priority (default)
+/// • ProRataAllocation        — split by resting size
+/// • TopOrderProRataAllocation — the order at the front of the
+///   level fills first, the remainder is split pro rata
+///
+/// Pro-rata rounding: each order gets floor(qty * size / total);
+/// shares below min_allocation round to zero. The residual is
+/// then handed out in queue (FIFO) order, each order taking as
+/// much as it still has resting.
+/// --------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+
+namespace lob {
+
+struct FifoAllocation {
+    static constexpr bool pro_rata = false;
+};
+
+struct ProRataAllocation {
+    static constexpr bool pro_rata = true;
+    static constexpr bool top_order_priority = false;
+    static constexpr std::int64_t min_allocation = 1;
+};
+
+struct TopOrderProRataAllocation : ProRataAllocation {
+    static constexpr bool top_order_priority = true;
+};
+
+/// a * b / c without intermediate overflow.
+inline std::int64_t mul_div(std::int64_t a, std::int64_t b, std::int64_t c) noexcept {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<std::int64_t>(static_cast<__int128>(a) * b / c);
+#else
+    return static_cast<std::int64_t>(static_cast<long double>(a) * static_cast<long double>(b)
+                                     / static_cast<long double>(c));
+#endif
+}
+
+/// Split `qty` across resting[0..n) (queue order) into out[0..n).
+/// Every out[i] <= resting[i]; the sum is min(qty, sum of resting).
+template <typename Policy>
+void allocate_pro_rata(const std::int64_t* resting, std::size_t n, std::int64_t qty, std::int64_t* out) {
+    std::size_t first = 0;
+    if constexpr (Policy::top_order_priority) {
+        if (n > 0) {
+            out[0] = std::min(qty, resting[0]);
+            qty -= out[0];
+            first = 1;
+        }
+    }
+
+    std::int64_t total = 0;
+    for (auto i = first; i < n; ++i) {
+        total += resting[i];
+    }
+    if (qty >= total) {
+        std::copy(resting + first, resting + n, out + first);
+        return;
+    }
+
+    std::int64_t allocated = 0;
+    for (auto i = first; i < n; ++i) {
+        auto share = mul_div(qty, resting[i], total);
+        if (share < Policy::min_allocation) {
+            share = 0;
+        }
+        out[i] = share;
+        allocated += share;
+    }
+
+    auto residual = qty - allocated;
+    for (auto i = first; i < n && residual > 0; ++i) {
+        const auto extra = std::min(residual, resting[i] - out[i]);
+        out[i] += extra;
+        residual -= extra;
+    }
+}
+
+} // namespace lob
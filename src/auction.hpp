@@ -0,0 +1,107 @@
+#pragma once
+/// --------------------------------------------------------
+/// Call auction equilibrium price
+///
+/// Input is the crossed part of the book: bid levels priced
+/// at or above the best ask (best first, descending) and ask
+/// levels at or below the best bid (best first, ascending).
+/// One ascending pass over the merged prices keeps
+///   S(p) = ask qty priced <= p   (grows as asks are passed)
+///   D(p) = bid qty priced >= p   (shrinks as bids are passed)
+/// and picks, among those level prices, the one that
+///   1. maximises executable volume min(D, S)
+///   2. then minimises the surplus |D - S|
+///   3. then follows market pressure: the highest such price
+///      if every tie has buy surplus, the lowest if every tie
+///      has sell surplus, otherwise the one nearest reference
+/// --------------------------------------------------------
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+namespace lob {
+
+struct AuctionLevel {
+    std::int64_t price = 0;
+    std::int64_t qty = 0;
+};
+
+struct AuctionResult {
+    bool crossed = false;
+    std::int64_t price = 0;
+    std::int64_t volume = 0;
+    std::int64_t surplus = 0; // bid minus ask quantity at the price
+};
+
+/// O(levels). `reference` breaks the final tie; 0 means the midpoint of
+/// the best bid and best ask.
+inline AuctionResult find_equilibrium(const std::vector<AuctionLevel>& bids, const std::vector<AuctionLevel>& asks,
+                                      std::int64_t reference = 0) {
+    if (bids.empty() || asks.empty()) {
+        return {};
+    }
+    if (reference == 0) {
+        reference = bids.front().price + (asks.front().price - bids.front().price) / 2;
+    }
+
+    std::int64_t demand = 0;
+    for (const auto& b : bids) {
+        demand += b.qty;
+    }
+    std::int64_t supply = 0;
+
+    AuctionResult lowest;   // lowest-priced tie
+    AuctionResult highest;  // highest-priced tie
+    AuctionResult nearest;  // tie nearest the reference
+    bool any_buy_surplus = false;
+    bool any_sell_surplus = false;
+
+    std::size_t a = 0;
+    auto b = bids.size();
+    while (a < asks.size() || b > 0) {
+        auto price = a < asks.size() ? asks[a].price : bids[b - 1].price;
+        if (b > 0 && bids[b - 1].price < price) {
+            price = bids[b - 1].price;
+        }
+        for (; a < asks.size() && asks[a].price == price; ++a) {
+            supply += asks[a].qty;
+        }
+
+        const AuctionResult here{true, price, demand < supply ? demand : supply, demand - supply};
+        const bool better = here.volume > lowest.volume
+                         || (here.volume == lowest.volume && std::llabs(here.surplus) < std::llabs(lowest.surplus));
+        const bool tie = !better && here.volume == lowest.volume
+                      && std::llabs(here.surplus) == std::llabs(lowest.surplus);
+        if (better) {
+            lowest = highest = nearest = here;
+            any_buy_surplus = any_sell_surplus = false;
+        } else if (tie) {
+            highest = here;
+            if (std::llabs(price - reference) < std::llabs(nearest.price - reference)) {
+                nearest = here;
+            }
+        }
+        if (better || tie) {
+            any_buy_surplus |= here.surplus > 0;
+            any_sell_surplus |= here.surplus < 0;
+        }
+
+        for (; b > 0 && bids[b - 1].price == price; --b) {
+            demand -= bids[b - 1].qty;
+        }
+    }
+
+    if (lowest.volume == 0) {
+        return {};
+    }
+    if (any_buy_surplus && !any_sell_surplus) {
+        return highest;
+    }
+    if (any_sell_surplus && !any_buy_surplus) {
+        return lowest;
+    }
+    return nearest;
+}
+
+} // namespace lob
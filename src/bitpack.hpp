@@ -0,0 +1,147 @@
+#pragma once
+/// --------------------------------------------------------
+/// Bit packing of 64-bit integers, 256 at a time
+///
+/// A mini-block stores 256 values of `width` bits each
+/// (0-64) in 4 * width words, so it takes exactly width
+/// bits per value. Values are interleaved over 4 lanes of
+/// 64-bit words: value 4j + l sits in lane l at bit j *
+/// width, and lane l's words are every fourth word from l.
+/// All 4 lanes share the same shifts, so unpacking emits 4
+/// consecutive values per AVX2 op and stores them straight
+/// to the output:
+///
+///   word  0    1    2    3    4    5    6    7   ...
+///   lane  0    1    2    3    0    1    2    3   ...
+///
+/// Each width has its own unpack routine, fully unrolled so
+/// every shift is an immediate; unpack() picks it from a
+/// table. The frame-of-reference base is added on the way
+/// out. Scalar fallback when AVX2 is not enabled at compile
+/// time; both produce the same layout.
+/// --------------------------------------------------------
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+namespace lob {
+
+inline constexpr std::size_t kPackBlock = 256;
+
+/// Packed size in bytes of one mini-block of the given width.
+constexpr std::size_t packed_bytes(unsigned width) noexcept {
+    return width * kPackBlock / 8;
+}
+
+/// Bits needed for every value in [0, range].
+constexpr unsigned pack_width(std::uint64_t range) noexcept {
+    return static_cast<unsigned>(std::bit_width(range));
+}
+
+/// Store in[0..256) - base (all < 2^width after subtraction) into
+/// out[0..4 * width) words.
+inline void pack(const std::uint64_t* in, std::uint64_t base, unsigned width, std::uint64_t* out) noexcept {
+    std::memset(out, 0, packed_bytes(width));
+    if (width == 0) {
+        return;
+    }
+    for (std::size_t k = 0; k < kPackBlock; ++k) {
+        const auto lane = k % 4;
+        const auto bit = (k / 4) * width;
+        const auto v = in[k] - base;
+        out[4 * (bit / 64) + lane] |= v << (bit % 64);
+        if (bit % 64 + width > 64) {
+            out[4 * (bit / 64 + 1) + lane] |= v >> (64 - bit % 64);
+        }
+    }
+}
+
+namespace detail {
+
+template <unsigned W>
+constexpr std::uint64_t pack_mask() noexcept {
+    return W == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << W) - 1;
+}
+
+#if defined(__AVX2__)
+
+template <unsigned W, std::size_t J>
+inline void unpack_step(const std::uint64_t* in, std::uint64_t* out, __m256i base, __m256i mask) noexcept {
+    constexpr std::size_t bit = J * W;
+    constexpr std::size_t word = bit / 64;
+    constexpr int shift = static_cast<int>(bit % 64);
+    auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 4 * word));
+    if constexpr (shift > 0) {
+        v = _mm256_srli_epi64(v, shift);
+    }
+    if constexpr (shift + W > 64) {
+        const auto next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 4 * (word + 1)));
+        v = _mm256_or_si256(v, _mm256_slli_epi64(next, 64 - shift));
+    }
+    if constexpr (W < 64) {
+        v = _mm256_and_si256(v, mask);
+    }
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 4 * J), _mm256_add_epi64(v, base));
+}
+
+template <unsigned W>
+inline void unpack_width(const std::uint64_t* in, std::uint64_t base, std::uint64_t* out) noexcept {
+    const auto b = _mm256_set1_epi64x(static_cast<long long>(base));
+    if constexpr (W == 0) {
+        for (std::size_t k = 0; k < kPackBlock; k += 4) {
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + k), b);
+        }
+    } else {
+        const auto mask = _mm256_set1_epi64x(static_cast<long long>(pack_mask<W>()));
+        [&]<std::size_t... J>(std::index_sequence<J...>) {
+            (unpack_step<W, J>(in, out, b, mask), ...);
+        }(std::make_index_sequence<kPackBlock / 4>{});
+    }
+}
+
+#else
+
+template <unsigned W>
+inline void unpack_width(const std::uint64_t* in, std::uint64_t base, std::uint64_t* out) noexcept {
+    for (std::size_t j = 0; j < kPackBlock / 4; ++j) {
+        const std::size_t bit = j * W;
+        const std::size_t word = bit / 64;
+        const unsigned shift = bit % 64;
+        for (std::size_t lane = 0; lane < 4; ++lane) {
+            std::uint64_t v = 0;
+            if constexpr (W > 0) {
+                v = in[4 * word + lane] >> shift;
+                if (shift + W > 64) {
+                    v |= in[4 * (word + 1) + lane] << (64 - shift);
+                }
+                v &= pack_mask<W>();
+            }
+            out[4 * j + lane] = v + base;
+        }
+    }
+}
+
+#endif
+
+using UnpackFn = void (*)(const std::uint64_t*, std::uint64_t, std::uint64_t*) noexcept;
+
+inline constexpr auto kUnpack = []<std::size_t... W>(std::index_sequence<W...>) {
+    return std::array<UnpackFn, sizeof...(W)>{&unpack_width<static_cast<unsigned>(W)>...};
+}(std::make_index_sequence<65>{});
+
+} // namespace detail
+
+/// out[0..256) = the packed values + base.
+inline void unpack(const std::uint64_t* in, std::uint64_t base, unsigned width, std::uint64_t* out) noexcept {
+    detail::kUnpack[width](in, base, out);
+}
+
+} // namespace lob
@@ -0,0 +1,180 @@
+#pragma once
+/// --------------------------------------------------------
+/// BookBuilder — passive mirror of an exchange book
+///
+/// Market data consumers rebuild the venue's book from its
+/// order-level events; the venue has already matched. The
+/// builder applies those events by order id straight to an
+/// OrderBook's storage and never runs match():
+///
+///   Add      rest a new order at the back of its level
+///   Reduce   take shares off in place, keeping priority
+///            (executions, partial cancels); the order
+///            leaves the book at zero
+///   Delete   remove the order
+///   Replace  remove it and add a new id, price and size on
+///            the same side, at the back (priority lost)
+///
+/// Updates of an id that is not resting are counted, not
+/// applied. So are adds (and replaces) to an id that is still
+/// resting: applying one would overwrite the id's entry and
+/// orphan the live order in its level.
+///
+/// Most updates are by id, so the default book queues orders
+/// in a list: reduce and delete reach the order through its
+/// node in O(1), where the contiguous queues search the level.
+/// apply(updates, n, window) software-pipelines a batch as
+/// group_match.hpp does: id slots 2K updates ahead, the order
+/// node and levels K ahead.
+/// --------------------------------------------------------
+
+#include "order_book.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace lob {
+
+/// One order-level market data event.
+struct BookUpdate {
+    enum class Type : std::uint8_t { Add, Reduce, Delete, Replace };
+
+    Type type = Type::Add;
+    Side side = Side::Buy;    // Add only
+    std::uint64_t id = 0;
+    std::uint64_t new_id = 0; // Replace only
+    std::int64_t price = 0;   // Add, Replace
+    std::int64_t qty = 0;     // Add, Replace: size; Reduce: shares taken off
+    std::uint64_t ts_ns = 0;
+};
+
+struct BookBuilderStats {
+    std::uint64_t adds = 0;
+    std::uint64_t reduces = 0;
+    std::uint64_t deletes = 0;
+    std::uint64_t replaces = 0;
+    std::uint64_t unknown_refs = 0;  // reduce/delete/replace of no resting order
+    std::uint64_t duplicate_ids = 0; // add/replace to an id that is still resting
+};
+
+template <typename Book = FlatListOrderBook>
+class BookBuilder {
+public:
+    using book_type = Book;
+
+    /// False, with nothing changed, if the id is already resting.
+    bool add(std::uint64_t id, Side side, std::int64_t price, std::int64_t qty, std::uint64_t ts_ns) {
+        if (live(id)) {
+            return false;
+        }
+        Order order;
+        order.id = id;
+        order.side = side;
+        order.price = price;
+        order.qty = qty;
+        order.ts_ns = ts_ns;
+        book_.add(std::move(order));
+        ++stats_.adds;
+        return true;
+    }
+
+    /// False if the id is not resting.
+    bool reduce(std::uint64_t id, std::int64_t qty) {
+        ++stats_.reduces;
+        return known(book_.reduce(id, qty) > 0);
+    }
+
+    bool remove(std::uint64_t id) {
+        ++stats_.deletes;
+        return known(book_.cancel(id) > 0);
+    }
+
+    bool replace(std::uint64_t id, std::uint64_t new_id, std::int64_t price, std::int64_t qty,
+                 std::uint64_t ts_ns) {
+        ++stats_.replaces;
+        Order order;
+        if ((new_id != id && live(new_id)) || !known(book_.cancel(id, order))) {
+            return false;
+        }
+        order.id = new_id;
+        order.price = price;
+        order.qty = qty;
+        order.ts_ns = ts_ns;
+        order.cum_qty = 0;
+        book_.add(std::move(order));
+        return true;
+    }
+
+    bool apply(const BookUpdate& u) {
+        switch (u.type) {
+        case BookUpdate::Type::Add:
+            return add(u.id, u.side, u.price, u.qty, u.ts_ns);
+        case BookUpdate::Type::Reduce:
+            return reduce(u.id, u.qty);
+        case BookUpdate::Type::Delete:
+            return remove(u.id);
+        case BookUpdate::Type::Replace:
+            return replace(u.id, u.new_id, u.price, u.qty, u.ts_ns);
+        }
+        return false;
+    }
+
+    /// Apply updates[0, n) in order, prefetching `window` updates ahead
+    /// (0: none). The book ends up the same for any window.
+    void apply(const BookUpdate* updates, std::size_t n, std::size_t window = 8) {
+        for (std::size_t i = 0; i < n; ++i) {
+            if (window > 0) {
+                if (i + 2 * window < n) {
+                    prefetch_early(updates[i + 2 * window]);
+                }
+                if (i + window < n) {
+                    prefetch_late(updates[i + window]);
+                }
+            }
+            apply(updates[i]);
+        }
+    }
+
+    /// First prefetch stage for an update: the id slot it looks up and,
+    /// for an add, the levels it rests on.
+    void prefetch_early(const BookUpdate& u) const noexcept {
+        if (u.type == BookUpdate::Type::Add) {
+            Order order;
+            order.id = u.id;
+            order.side = u.side;
+            order.price = u.price;
+            book_.prefetch(order);
+        } else {
+            book_.prefetch_id(u.id);
+        }
+    }
+
+    /// Second stage, once the first has landed: the resting order's
+    /// node and levels.
+    void prefetch_late(const BookUpdate& u) const noexcept {
+        if (u.type != BookUpdate::Type::Add) {
+            book_.prefetch_resting(u.id);
+        }
+    }
+
+    const Book& book() const noexcept { return book_; }
+    const BookBuilderStats& stats() const noexcept { return stats_; }
+
+private:
+    bool known(bool found) noexcept {
+        stats_.unknown_refs += found ? 0 : 1;
+        return found;
+    }
+
+    bool live(std::uint64_t id) noexcept {
+        const bool found = book_.contains(id);
+        stats_.duplicate_ids += found ? 1 : 0;
+        return found;
+    }
+
+    Book book_;
+    BookBuilderStats stats_;
+};
+
+} // namespace lob
@@ -0,0 +1,60 @@
+#pragma once
+/// --------------------------------------------------------
+/// Runtime selection of a pre-instantiated book variant
+///
+/// Names are LEVELS-QUEUE, e.g. "ladder-ring":
+///   LEVELS: map | flat | ladder
+///   QUEUE:  deque | list | ring   (optional, default deque)
+///
+/// visit_book_impl(name, fn) calls fn(std::type_identity<Book>{})
+/// and returns false if the name is not recognised.
+/// --------------------------------------------------------
+
+#include "order_book.hpp"
+
+#include <string_view>
+#include <type_traits>
+
+namespace lob {
+
+inline constexpr std::string_view kBookImplNames =
+    "map-deque, map-list, map-ring, flat-deque, flat-list, flat-ring, "
+    "ladder-deque, ladder-list, ladder-ring";
+
+namespace detail {
+
+template <typename LevelPolicy, typename Fn>
+bool visit_queue_impl(std::string_view queue, Fn&& fn) {
+    if (queue.empty() || queue == "deque") {
+        fn(std::type_identity<BasicOrderBook<LevelPolicy, DequeOrders>>{});
+    } else if (queue == "list") {
+        fn(std::type_identity<BasicOrderBook<LevelPolicy, ListOrders>>{});
+    } else if (queue == "ring") {
+        fn(std::type_identity<BasicOrderBook<LevelPolicy, RingOrders>>{});
+    } else {
+        return false;
+    }
+    return true;
+}
+
+} // namespace detail
+
+template <typename Fn>
+bool visit_book_impl(std::string_view name, Fn&& fn) {
+    const auto dash = name.find('-');
+    const auto levels = name.substr(0, dash);
+    const auto queue = dash == std::string_view::npos ? std::string_view{} : name.substr(dash + 1);
+
+    if (levels == "map") {
+        return detail::visit_queue_impl<MapLevels>(queue, fn);
+    }
+    if (levels == "flat") {
+        return detail::visit_queue_impl<FlatLevels>(queue, fn);
+    }
+    if (levels == "ladder") {
+        return detail::visit_queue_impl<LadderLevels>(queue, fn);
+    }
+    return false;
+}
+
+} // namespace lob
@@ -0,0 +1,211 @@
+#pragma once
+/// --------------------------------------------------------
+/// ClientOrderMap — (session, ClOrdID) -> dense order id
+///
+/// Gateway-side table resolving client order ids to the
+/// engine's 64-bit ids, so the book never sees strings.
+///
+/// • Keys are stored inline: a 32-byte ClientKey holds the
+///   session, the length and up to 27 id bytes, zero padded
+/// • Fixed capacity, allocated once; open addressing with
+///   linear probing and backward-shift deletion
+/// • Each slot is one cache line (key, id, 32-bit hash tag);
+///   the full key is compared (one AVX2 or two SSE2
+///   compares) only on a tag match
+/// • The hash mixes the key's four 64-bit words; no string
+///   hashing, no allocation after construction
+///
+/// The gateway erase()s an id once its order is done
+/// (filled, cancelled, rejected or replaced), so the table
+/// holds live orders only and a finished id may be reused.
+/// --------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace lob {
+
+struct alignas(32) ClientKey {
+    static constexpr std::size_t kMaxLength = 27;
+
+    std::uint32_t session = 0;
+    std::uint8_t length = 0;
+    char id[kMaxLength] = {};
+
+    /// False (key untouched) if the id is empty or longer than kMaxLength.
+    bool assign(std::uint32_t s, std::string_view text) noexcept {
+        if (text.empty() || text.size() > kMaxLength) {
+            return false;
+        }
+        session = s;
+        length = static_cast<std::uint8_t>(text.size());
+        std::memset(id, 0, sizeof(id));
+        std::memcpy(id, text.data(), text.size());
+        return true;
+    }
+
+    std::string_view view() const noexcept { return {id, length}; }
+};
+
+static_assert(sizeof(ClientKey) == 32, "two SSE or one AVX compare per key");
+
+inline bool operator==(const ClientKey& a, const ClientKey& b) noexcept {
+#if defined(__AVX2__)
+    const auto x = _mm256_load_si256(reinterpret_cast<const __m256i*>(&a));
+    const auto y = _mm256_load_si256(reinterpret_cast<const __m256i*>(&b));
+    return _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) == -1;
+#elif defined(__SSE2__) || defined(_M_X64)
+    const auto* pa = reinterpret_cast<const __m128i*>(&a);
+    const auto* pb = reinterpret_cast<const __m128i*>(&b);
+    const auto eq = _mm_and_si128(_mm_cmpeq_epi8(_mm_load_si128(pa), _mm_load_si128(pb)),
+                                  _mm_cmpeq_epi8(_mm_load_si128(pa + 1), _mm_load_si128(pb + 1)));
+    return _mm_movemask_epi8(eq) == 0xFFFF;
+#else
+    return std::memcmp(&a, &b, sizeof(ClientKey)) == 0;
+#endif
+}
+
+/// Nonzero 32-bit hash of a key (0 marks an empty slot).
+inline std::uint32_t hash_tag(const ClientKey& key) noexcept {
+    std::uint64_t w[4];
+    std::memcpy(w, &key, sizeof(w));
+    auto h = (w[0] ^ 0x9E3779B97F4A7C15ull) * 0xBF58476D1CE4E5B9ull;
+    h ^= (w[1] + (h >> 29)) * 0x94D049BB133111EBull;
+    h ^= (w[2] + (h >> 31)) * 0xBF58476D1CE4E5B9ull;
+    h ^= (w[3] + (h >> 27)) * 0x94D049BB133111EBull;
+    h ^= h >> 32;
+    const auto tag = static_cast<std::uint32_t>(h);
+    return tag != 0 ? tag : 1;
+}
+
+class ClientOrderMap {
+public:
+    static constexpr std::uint64_t kNoId = ~std::uint64_t{0};
+    /// Largest capacity: slots are indexed by the top bits of a 32-bit tag.
+    static constexpr std::size_t kMaxCapacity = std::size_t{1} << 30;
+
+    enum class Insert : std::uint8_t { Ok, Duplicate, Full, BadId };
+
+    /// Room for `capacity` live entries (load kept at or below 50%),
+    /// clamped to kMaxCapacity.
+    explicit ClientOrderMap(std::size_t capacity) {
+        capacity = std::min(capacity, kMaxCapacity);
+        std::size_t slots = 16;
+        unsigned bits = 4;
+        while (slots < capacity * 2) {
+            slots *= 2;
+            ++bits;
+        }
+        slots_ = std::make_unique<Slot[]>(slots);
+        mask_ = slots - 1;
+        shift_ = 32 - bits;
+        capacity_ = capacity;
+    }
+
+    Insert insert(std::uint32_t session, std::string_view clordid, std::uint64_t id) noexcept {
+        ClientKey key;
+        if (!key.assign(session, clordid)) {
+            return Insert::BadId;
+        }
+        const auto tag = hash_tag(key);
+        auto i = home(tag);
+        for (; slots_[i].tag != 0; i = (i + 1) & mask_) {
+            if (slots_[i].tag == tag && slots_[i].key == key) {
+                return Insert::Duplicate;
+            }
+        }
+        if (size_ == capacity_) {
+            return Insert::Full;
+        }
+        slots_[i].key = key;
+        slots_[i].id = id;
+        slots_[i].tag = tag;
+        ++size_;
+        return Insert::Ok;
+    }
+
+    /// The dense id, or kNoId.
+    std::uint64_t find(std::uint32_t session, std::string_view clordid) const noexcept {
+        ClientKey key;
+        if (!key.assign(session, clordid)) {
+            return kNoId;
+        }
+        const auto slot = locate(key, hash_tag(key));
+        return slot != kNoSlot ? slots_[slot].id : kNoId;
+    }
+
+    bool erase(std::uint32_t session, std::string_view clordid) noexcept {
+        ClientKey key;
+        if (!key.assign(session, clordid)) {
+            return false;
+        }
+        auto i = locate(key, hash_tag(key));
+        if (i == kNoSlot) {
+            return false;
+        }
+        // Pull later members of the probe run back into the hole.
+        for (auto j = (i + 1) & mask_; slots_[j].tag != 0; j = (j + 1) & mask_) {
+            const auto h = home(slots_[j].tag);
+            if (((j - h) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = slots_[j];
+                i = j;
+            }
+        }
+        slots_[i].tag = 0;
+        --size_;
+        return true;
+    }
+
+    void clear() noexcept {
+        for (std::size_t i = 0; i <= mask_; ++i) {
+            slots_[i].tag = 0;
+        }
+        size_ = 0;
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    std::size_t capacity() const noexcept { return capacity_; }
+
+private:
+    static constexpr std::size_t kNoSlot = ~std::size_t{0};
+
+    /// One cache line: a probe that hits costs a single miss.
+    struct alignas(64) Slot {
+        ClientKey key;
+        std::uint64_t id = 0;
+        std::uint32_t tag = 0; // 0 = empty
+    };
+
+    std::size_t home(std::uint32_t tag) const noexcept {
+        return static_cast<std::size_t>((tag * 0x9E3779B9u) >> shift_);
+    }
+
+    std::size_t locate(const ClientKey& key, std::uint32_t tag) const noexcept {
+        for (auto i = home(tag);; i = (i + 1) & mask_) {
+            if (slots_[i].tag == tag && slots_[i].key == key) {
+                return i;
+            }
+            if (slots_[i].tag == 0) {
+                return kNoSlot;
+            }
+        }
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    std::size_t mask_ = 0;
+    unsigned shift_ = 0;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+};
+
+} // namespace lob
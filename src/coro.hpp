@@ -0,0 +1,192 @@
+#pragma once
+/// --------------------------------------------------------
+/// Coroutine tasks and channels on one thread
+///
+/// • Task — a coroutine started and resumed only by its
+///   Scheduler; it runs until it waits on a channel or yields
+/// • Scheduler — a FIFO of ready coroutines, resumed in turn
+///   on the calling thread; no locks, no atomics
+/// • Channel<T> — bounded queue between two stages. push()
+///   suspends the writer while the queue is full, pop() the
+///   reader while it is empty; a wake-up only marks the other
+///   side ready, so a stage keeps running until it blocks and
+///   hands over a queue-full of items per switch
+/// --------------------------------------------------------
+
+#include <coroutine>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+class Task {
+public:
+    struct promise_type {
+        std::exception_ptr error;
+
+        Task get_return_object() noexcept {
+            return Task(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { error = std::current_exception(); }
+    };
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+    Task& operator=(Task&&) = delete;
+    ~Task() {
+        if (handle_) {
+            handle_.destroy();
+        }
+    }
+
+    std::coroutine_handle<promise_type> handle() const noexcept { return handle_; }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) noexcept : handle_(handle) {}
+
+    std::coroutine_handle<promise_type> handle_;
+};
+
+class Scheduler {
+public:
+    /// Take ownership of a task; it starts on the next run().
+    void spawn(Task task) {
+        post(task.handle());
+        tasks_.push_back(std::move(task));
+    }
+
+    void post(std::coroutine_handle<> h) { ready_.push_back(h); }
+
+    /// Suspend the current coroutine behind everything already ready.
+    auto yield() noexcept {
+        struct Awaiter {
+            Scheduler& scheduler;
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> h) { scheduler.post(h); }
+            void await_resume() const noexcept {}
+        };
+        return Awaiter{*this};
+    }
+
+    /// Resume ready coroutines until none is. True if every task ran to
+    /// completion; false if some are still waiting (a stage blocked on a
+    /// channel nobody will service). A task's exception is rethrown here.
+    bool run() {
+        while (!ready_.empty()) {
+            const auto h = ready_.front();
+            ready_.pop_front();
+            h.resume();
+        }
+        bool done = true;
+        for (const auto& task : tasks_) {
+            if (task.handle().promise().error) {
+                std::rethrow_exception(task.handle().promise().error);
+            }
+            done &= task.handle().done();
+        }
+        return done;
+    }
+
+private:
+    std::deque<std::coroutine_handle<>> ready_;
+    std::vector<Task> tasks_;
+};
+
+/// One writer, one reader, both coroutines on the same Scheduler.
+template <typename T>
+class Channel {
+public:
+    Channel(Scheduler& scheduler, std::size_t capacity) : scheduler_(scheduler) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        slots_.resize(size);
+        mask_ = size - 1;
+    }
+
+    /// co_await push(v): waits while the channel is full. `value` is
+    /// copied in, so it only has to live until the co_await completes.
+    auto push(const T& value) {
+        struct Awaiter {
+            Channel& channel;
+            const T& value;
+            bool stored = false;
+            bool await_ready() {
+                // Store on the fast path, so the value is not copied into
+                // the coroutine frame first.
+                if (channel.count_ <= channel.mask_) {
+                    channel.put(value);
+                    stored = true;
+                }
+                return stored;
+            }
+            void await_suspend(std::coroutine_handle<> h) noexcept { channel.writer_ = h; }
+            void await_resume() {
+                if (!stored) {
+                    channel.put(value);
+                }
+            }
+        };
+        return Awaiter{*this, value};
+    }
+
+    /// co_await pop(out): true with the next item in `out`, false once
+    /// closed and drained.
+    auto pop(T& out) {
+        struct Awaiter {
+            Channel& channel;
+            T& out;
+            bool await_ready() const noexcept { return channel.count_ > 0 || channel.closed_; }
+            void await_suspend(std::coroutine_handle<> h) noexcept { channel.reader_ = h; }
+            bool await_resume() { return channel.take(out); }
+        };
+        return Awaiter{*this, out};
+    }
+
+    /// No more pushes; pop() returns false after the last item.
+    void close() {
+        closed_ = true;
+        wake(reader_);
+    }
+
+private:
+    void put(const T& value) {
+        slots_[(head_ + count_) & mask_] = value;
+        ++count_;
+        wake(reader_);
+    }
+
+    bool take(T& out) {
+        if (count_ == 0) {
+            return false;
+        }
+        out = slots_[head_];
+        head_ = (head_ + 1) & mask_;
+        --count_;
+        wake(writer_);
+        return true;
+    }
+
+    void wake(std::coroutine_handle<>& waiter) {
+        if (waiter) {
+            scheduler_.post(std::exchange(waiter, {}));
+        }
+    }
+
+    Scheduler& scheduler_;
+    std::vector<T> slots_;
+    std::size_t mask_ = 0;
+    std::size_t head_ = 0;
+    std::size_t count_ = 0;
+    bool closed_ = false;
+    std::coroutine_handle<> reader_;
+    std::coroutine_handle<> writer_;
+};
+
+} // namespace lob
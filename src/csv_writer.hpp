@@ -0,0 +1,77 @@
+#pragma once
+/// --------------------------------------------------------
+/// CsvWriter — buffered CSV output via std::to_chars
+///
+/// • Formats integers without iostream locale/format state
+/// • Flushes to the stream in 64 KiB chunks
+/// --------------------------------------------------------
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ostream>
+#include <string_view>
+
+namespace lob {
+
+class CsvWriter {
+public:
+    explicit CsvWriter(std::ostream& os) : os_(os) {}
+    ~CsvWriter() { flush(); }
+
+    CsvWriter(const CsvWriter&) = delete;
+    CsvWriter& operator=(const CsvWriter&) = delete;
+
+    CsvWriter& field(std::string_view text) {
+        separate(text.size());
+        std::memcpy(buf_.data() + len_, text.data(), text.size());
+        len_ += text.size();
+        return *this;
+    }
+
+    template <std::integral Int>
+    CsvWriter& field(Int value) {
+        separate(kMaxIntChars);
+        const auto res = std::to_chars(buf_.data() + len_, buf_.data() + buf_.size(), value);
+        len_ = static_cast<std::size_t>(res.ptr - buf_.data());
+        return *this;
+    }
+
+    void end_row() {
+        reserve(1);
+        buf_[len_++] = '\n';
+        row_start_ = true;
+    }
+
+    void flush() {
+        os_.write(buf_.data(), static_cast<std::streamsize>(len_));
+        len_ = 0;
+    }
+
+private:
+    static constexpr std::size_t kMaxIntChars = 24;
+
+    void separate(std::size_t need) {
+        reserve(need + 1);
+        if (!row_start_) {
+            buf_[len_++] = ',';
+        }
+        row_start_ = false;
+    }
+
+    void reserve(std::size_t need) {
+        if (len_ + need > buf_.size()) {
+            flush();
+        }
+    }
+
+    std::ostream& os_;
+    std::array<char, 1 << 16> buf_;
+    std::size_t len_ = 0;
+    bool row_start_ = true;
+};
+
+} // namespace lob
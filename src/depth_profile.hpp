@@ -0,0 +1,118 @@
+#pragma once
+/// --------------------------------------------------------
+/// Depth profile — cumulative quantity per side by price bin
+///
+/// Built by OrderBook::depth_profile(bin_ticks): each side's
+/// index sums its levels into bins (best bin first), then a
+/// SIMD prefix sum turns them into cumulative depth. Empty
+/// bins are dropped. A bin is labelled by its lowest price.
+///
+/// Export formats:
+///   CSV    — side,price,cum_qty
+///   binary — a 40-byte depth_file::Header, then bid prices,
+///            bid cum_qty, ask prices, ask cum_qty as int64
+///            columns; all little-endian
+/// --------------------------------------------------------
+
+#include "csv_writer.hpp"
+#include "depth_scan.hpp"
+#include "endian.hpp"
+#include "sbe.hpp"
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace lob {
+
+struct DepthSide {
+    std::vector<std::int64_t> prices;  // best bin first
+    std::vector<std::int64_t> cum_qty;
+};
+
+struct DepthProfile {
+    std::int64_t bin_ticks = 1;
+    DepthSide bids;
+    DepthSide asks;
+};
+
+namespace depth_file {
+
+inline constexpr std::string_view kMagic = "LOBDEPTH";
+
+struct Magic : sbe::Chars<8> {};
+struct Version : sbe::Field<std::uint32_t> {};
+struct Reserved : sbe::Field<std::uint32_t> {};
+struct BinTicks : sbe::Field<std::int64_t> {};
+struct BidRows : sbe::Field<std::uint64_t> {};
+struct AskRows : sbe::Field<std::uint64_t> {};
+
+using Header = sbe::Layout<Magic, Version, Reserved, BinTicks, BidRows, AskRows>;
+
+static_assert(Header::block_length == 40, "visualize.py reads a 40-byte header");
+
+} // namespace depth_file
+
+/// Convert per-bin quantities (best first, consecutive bins) into one
+/// side of the profile. `step` is -1 for bids and +1 for asks.
+inline void append_depth_side(std::vector<std::int64_t>& bins, std::int64_t first_bin,
+                              std::int64_t step, std::int64_t bin_ticks, DepthSide& out) {
+    prefix_sum(bins.data(), bins.size());
+    out.prices.clear();
+    out.cum_qty.clear();
+    std::int64_t prev = 0;
+    for (std::size_t k = 0; k < bins.size(); ++k) {
+        if (bins[k] == prev) {
+            continue;
+        }
+        out.prices.push_back((first_bin + step * static_cast<std::int64_t>(k)) * bin_ticks);
+        out.cum_qty.push_back(bins[k]);
+        prev = bins[k];
+    }
+}
+
+inline void write_depth_csv(std::ostream& os, const DepthProfile& profile) {
+    CsvWriter csv(os);
+    csv.field("side").field("price").field("cum_qty").end_row();
+    for (std::size_t i = 0; i < profile.bids.prices.size(); ++i) {
+        csv.field("BID").field(profile.bids.prices[i]).field(profile.bids.cum_qty[i]).end_row();
+    }
+    for (std::size_t i = 0; i < profile.asks.prices.size(); ++i) {
+        csv.field("ASK").field(profile.asks.prices[i]).field(profile.asks.cum_qty[i]).end_row();
+    }
+}
+
+inline void write_depth_binary(std::ostream& os, const DepthProfile& profile) {
+    using namespace depth_file;
+    std::byte header[Header::block_length];
+    sbe::BlockWriter<Header, std::endian::little>(header)
+        .set<Magic>(kMagic)
+        .set<Version>(1)
+        .set<Reserved>(0)
+        .set<BinTicks>(profile.bin_ticks)
+        .set<BidRows>(profile.bids.prices.size())
+        .set<AskRows>(profile.asks.prices.size());
+    os.write(reinterpret_cast<const char*>(header), sizeof(header));
+
+    auto column = [&os](const std::vector<std::int64_t>& values) {
+        if constexpr (std::endian::native == std::endian::little) {
+            os.write(reinterpret_cast<const char*>(values.data()),
+                     static_cast<std::streamsize>(values.size() * sizeof(std::int64_t)));
+        } else {
+            for (const auto v : values) {
+                std::byte le[sizeof(v)];
+                store<std::uint64_t, std::endian::little>(le, static_cast<std::uint64_t>(v));
+                os.write(reinterpret_cast<const char*>(le), sizeof(le));
+            }
+        }
+    };
+    column(profile.bids.prices);
+    column(profile.bids.cum_qty);
+    column(profile.asks.prices);
+    column(profile.asks.cum_qty);
+}
+
+} // namespace lob
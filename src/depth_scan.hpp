@@ -0,0 +1,270 @@
+#pragma once
+/// --------------------------------------------------------
+/// Aggregate-liquidity scan over contiguous level quantities
+///
+/// scan_depth walks q[0..n) from the best level outwards and
+/// reports the total quantity in range plus the cost of
+/// filling `target` of it. Empty levels hold 0 and are
+/// skipped by the level count.
+///
+/// • AVX-512 (F+DQ) / AVX2 kernels sum whole blocks until the
+///   block containing the target, then finish it scalar
+/// • Scalar fallback when neither is enabled at compile time
+///
+/// prefix_sum turns per-bin quantities into cumulative depth
+/// with in-register shift-and-add scans of the same widths.
+/// --------------------------------------------------------
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace lob {
+
+/// Result of a liquidity query against one side of the book.
+struct Liquidity {
+    std::int64_t available = 0; // resting qty at prices up to the limit
+    std::int64_t filled = 0;    // min(size, available)
+    std::int64_t notional = 0;  // sum of price * qty over the fill
+    std::size_t levels = 0;     // price levels the fill touches
+
+    double vwap() const noexcept {
+        return filled > 0 ? static_cast<double>(notional) / static_cast<double>(filled) : 0.0;
+    }
+};
+
+/// Raw kernel output; `weighted` is sum(j * qty_j) over the fill,
+/// where j is the level's distance from the best level.
+struct DepthScan {
+    std::int64_t total = 0;
+    std::int64_t filled = 0;
+    std::int64_t weighted = 0;
+    std::size_t levels = 0;
+};
+
+namespace detail {
+
+template <bool Descending>
+inline std::int64_t level_at(const std::int64_t* q, std::size_t n, std::size_t j) noexcept {
+    return Descending ? q[n - 1 - j] : q[j];
+}
+
+/// Consume levels one at a time from distance j until the target is met.
+/// Returns the distance of the first level not visited.
+template <bool Descending>
+inline std::size_t fill_scalar(const std::int64_t* q, std::size_t n, std::size_t j,
+                               std::int64_t target, DepthScan& out) noexcept {
+    for (; j < n && out.filled < target; ++j) {
+        const auto qty = level_at<Descending>(q, n, j);
+        out.total += qty;
+        if (qty > 0) {
+            const auto take = std::min(qty, target - out.filled);
+            out.filled += take;
+            out.weighted += static_cast<std::int64_t>(j) * take;
+            ++out.levels;
+        }
+    }
+    return j;
+}
+
+/// Levels at distance >= j, as a contiguous range.
+template <bool Descending>
+inline const std::int64_t* remainder(const std::int64_t* q, std::size_t j) noexcept {
+    return Descending ? q : q + j;
+}
+
+inline std::int64_t sum_scalar(const std::int64_t* q, std::size_t n) noexcept {
+    std::int64_t total = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        total += q[i];
+    }
+    return total;
+}
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+
+/// Explicit horizontal sum. In GCC 12, _mm512_reduce_add_epi64 and the
+/// unmasked extract, cast, alignr and permutexvar intrinsics pass an
+/// _mm*_undefined_* source, which -Wall reports as "may be used
+/// uninitialized" at every call site. Their zero-masked forms (all-ones
+/// mask) do not, and compile to the same instructions.
+inline std::int64_t hsum_epi64(__m512i v) noexcept {
+    const auto h = _mm256_add_epi64(_mm512_maskz_extracti64x4_epi64(0xFF, v, 0),
+                                    _mm512_maskz_extracti64x4_epi64(0xFF, v, 1));
+    const auto s = _mm_add_epi64(_mm256_castsi256_si128(h), _mm256_extracti128_si256(h, 1));
+    return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+}
+
+inline std::int64_t sum_simd(const std::int64_t* q, std::size_t n) noexcept {
+    auto acc = _mm512_setzero_si512();
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        acc = _mm512_add_epi64(acc, _mm512_loadu_si512(q + i));
+    }
+    return hsum_epi64(acc) + sum_scalar(q + i, n - i);
+}
+
+template <bool Descending>
+inline std::size_t fill_simd(const std::int64_t* q, std::size_t n,
+                             std::int64_t target, DepthScan& out) noexcept {
+    constexpr std::size_t W = 8;
+    const auto lanes = Descending ? _mm512_set_epi64(0, 1, 2, 3, 4, 5, 6, 7)
+                                  : _mm512_set_epi64(7, 6, 5, 4, 3, 2, 1, 0);
+    std::size_t j = 0;
+    for (; j + W <= n; j += W) {
+        const auto v = _mm512_loadu_si512(Descending ? q + (n - j - W) : q + j);
+        const auto sum = hsum_epi64(v);
+        if (out.filled + sum >= target) {
+            break;
+        }
+        const auto dist = _mm512_add_epi64(lanes, _mm512_set1_epi64(static_cast<std::int64_t>(j)));
+        out.total += sum;
+        out.filled += sum;
+        out.weighted += hsum_epi64(_mm512_mullo_epi64(dist, v));
+        out.levels += static_cast<std::size_t>(std::popcount(
+            static_cast<unsigned>(_mm512_test_epi64_mask(v, v))));
+    }
+    return j;
+}
+
+inline void prefix_sum_simd(std::int64_t* q, std::size_t n) noexcept {
+    const auto zero = _mm512_setzero_si512();
+    const auto last = _mm512_set1_epi64(7);
+    auto carry = zero;
+    std::size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        auto v = _mm512_loadu_si512(q + i);
+        v = _mm512_add_epi64(v, _mm512_maskz_alignr_epi64(0xFF, v, zero, 7));
+        v = _mm512_add_epi64(v, _mm512_maskz_alignr_epi64(0xFF, v, zero, 6));
+        v = _mm512_add_epi64(v, _mm512_maskz_alignr_epi64(0xFF, v, zero, 4));
+        v = _mm512_add_epi64(v, carry);
+        _mm512_storeu_si512(q + i, v);
+        carry = _mm512_maskz_permutexvar_epi64(0xFF, last, v);
+    }
+    auto run = i > 0 ? q[i - 1] : 0;
+    for (; i < n; ++i) {
+        run = static_cast<std::int64_t>(static_cast<std::uint64_t>(run) + static_cast<std::uint64_t>(q[i]));
+        q[i] = run;
+    }
+}
+
+#elif defined(__AVX2__)
+
+inline std::int64_t hsum_epi64(__m256i v) noexcept {
+    const auto s = _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+    return _mm_cvtsi128_si64(s) + _mm_extract_epi64(s, 1);
+}
+
+inline std::int64_t sum_simd(const std::int64_t* q, std::size_t n) noexcept {
+    auto acc = _mm256_setzero_si256();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        acc = _mm256_add_epi64(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q + i)));
+    }
+    return hsum_epi64(acc) + sum_scalar(q + i, n - i);
+}
+
+template <bool Descending>
+inline std::size_t fill_simd(const std::int64_t* q, std::size_t n,
+                             std::int64_t target, DepthScan& out) noexcept {
+    constexpr std::size_t W = 4;
+    const auto lanes = Descending ? _mm256_set_epi64x(0, 1, 2, 3) : _mm256_set_epi64x(3, 2, 1, 0);
+    const auto zero = _mm256_setzero_si256();
+    std::size_t j = 0;
+    for (; j + W <= n; j += W) {
+        const auto v = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(Descending ? q + (n - j - W) : q + j));
+        const auto sum = hsum_epi64(v);
+        if (out.filled + sum >= target) {
+            break;
+        }
+        // AVX2 only multiplies 32x32->64, so a lane >= 2^32 drops to scalar.
+        const auto high = _mm256_srli_epi64(v, 32);
+        if (!_mm256_testz_si256(high, high)) {
+            break;
+        }
+        const auto dist = _mm256_add_epi64(lanes, _mm256_set1_epi64x(static_cast<std::int64_t>(j)));
+        const auto empty = _mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, zero)));
+        out.total += sum;
+        out.filled += sum;
+        out.weighted += hsum_epi64(_mm256_mul_epu32(dist, v));
+        out.levels += W - static_cast<std::size_t>(std::popcount(static_cast<unsigned>(empty)));
+    }
+    return j;
+}
+
+inline void prefix_sum_simd(std::int64_t* q, std::size_t n) noexcept {
+    const auto zero = _mm256_setzero_si256();
+    auto carry = zero;
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(q + i));
+        // Shift by one then two lanes, zero-filling from the bottom.
+        v = _mm256_add_epi64(v, _mm256_blend_epi32(
+            _mm256_permute4x64_epi64(v, _MM_SHUFFLE(2, 1, 0, 0)), zero, 0x03));
+        v = _mm256_add_epi64(v, _mm256_blend_epi32(
+            _mm256_permute4x64_epi64(v, _MM_SHUFFLE(1, 0, 0, 0)), zero, 0x0F));
+        v = _mm256_add_epi64(v, carry);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(q + i), v);
+        carry = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 3, 3, 3));
+    }
+    auto run = i > 0 ? q[i - 1] : 0;
+    for (; i < n; ++i) {
+        run = static_cast<std::int64_t>(static_cast<std::uint64_t>(run) + static_cast<std::uint64_t>(q[i]));
+        q[i] = run;
+    }
+}
+
+#else
+
+inline std::int64_t sum_simd(const std::int64_t* q, std::size_t n) noexcept {
+    return sum_scalar(q, n);
+}
+
+template <bool Descending>
+inline std::size_t fill_simd(const std::int64_t*, std::size_t, std::int64_t, DepthScan&) noexcept {
+    return 0;
+}
+
+inline void prefix_sum_simd(std::int64_t* q, std::size_t n) noexcept {
+    std::int64_t run = 0;
+    for (std::size_t i = 0; i < n; ++i) {
+        run = static_cast<std::int64_t>(static_cast<std::uint64_t>(run) + static_cast<std::uint64_t>(q[i]));
+        q[i] = run;
+    }
+}
+
+#endif
+
+} // namespace detail
+
+/// Scan n contiguous level quantities best-first. Ascending scans start at
+/// q[0]; descending scans start at q[n - 1].
+template <bool Descending>
+inline DepthScan scan_depth(const std::int64_t* q, std::size_t n, std::int64_t target) noexcept {
+    DepthScan out;
+    // Whole blocks below the target, the crossing block level by level,
+    // then a plain sum over whatever is left up to the limit.
+    auto j = detail::fill_simd<Descending>(q, n, target, out);
+    j = detail::fill_scalar<Descending>(q, n, j, target, out);
+    out.total += detail::sum_simd(detail::remainder<Descending>(q, j), n - j);
+    return out;
+}
+
+/// Sum of n contiguous level quantities.
+inline std::int64_t sum_depth(const std::int64_t* q, std::size_t n) noexcept {
+    return detail::sum_simd(q, n);
+}
+
+/// In-place inclusive prefix sum: q[i] becomes q[0] + ... + q[i]
+/// (wrapping on overflow, as the SIMD adds do).
+inline void prefix_sum(std::int64_t* q, std::size_t n) noexcept {
+    detail::prefix_sum_simd(q, n);
+}
+
+} // namespace lob
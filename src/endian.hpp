@@ -0,0 +1,94 @@
+#pragma once
+/// --------------------------------------------------------
+/// Byte-order helpers for wire formats
+///
+/// Loads and stores go through memcpy, so fields need no
+/// alignment; byteswap() compiles to a single bswap/movbe.
+/// --------------------------------------------------------
+
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+#include <stdlib.h>
+#endif
+
+namespace lob {
+
+template <std::unsigned_integral T>
+constexpr T byteswap(T v) noexcept {
+    if constexpr (sizeof(T) == 1) {
+        return v;
+    } else if (std::is_constant_evaluated()) {
+        T out = 0;
+        for (std::size_t i = 0; i < sizeof(T); ++i) {
+            out = static_cast<T>((out << 8) | ((v >> (8 * i)) & 0xFF));
+        }
+        return out;
+    } else {
+#if defined(_MSC_VER)
+        if constexpr (sizeof(T) == 2) {
+            return _byteswap_ushort(v);
+        } else if constexpr (sizeof(T) == 4) {
+            return _byteswap_ulong(v);
+        } else {
+            return _byteswap_uint64(v);
+        }
+#else
+        if constexpr (sizeof(T) == 2) {
+            return __builtin_bswap16(v);
+        } else if constexpr (sizeof(T) == 4) {
+            return __builtin_bswap32(v);
+        } else {
+            return __builtin_bswap64(v);
+        }
+#endif
+    }
+}
+
+/// Value of type T stored in byte order `order` at p.
+template <std::unsigned_integral T, std::endian order>
+inline T load(const void* p) noexcept {
+    T v;
+    std::memcpy(&v, p, sizeof(T));
+    if constexpr (order != std::endian::native) {
+        v = byteswap(v);
+    }
+    return v;
+}
+
+template <std::unsigned_integral T, std::endian order>
+inline void store(void* p, T v) noexcept {
+    if constexpr (order != std::endian::native) {
+        v = byteswap(v);
+    }
+    std::memcpy(p, &v, sizeof(T));
+}
+
+template <std::unsigned_integral T>
+inline T load_be(const void* p) noexcept {
+    return load<T, std::endian::big>(p);
+}
+
+template <std::unsigned_integral T>
+inline void store_be(void* p, T v) noexcept {
+    store<T, std::endian::big>(p, v);
+}
+
+/// 48-bit big-endian (ITCH timestamps).
+inline std::uint64_t load_be48(const void* p) noexcept {
+    const auto* b = static_cast<const std::uint8_t*>(p);
+    return (std::uint64_t{load_be<std::uint16_t>(b)} << 32) | load_be<std::uint32_t>(b + 2);
+}
+
+inline void store_be48(void* p, std::uint64_t v) noexcept {
+    auto* b = static_cast<std::uint8_t*>(p);
+    store_be(b, static_cast<std::uint16_t>(v >> 32));
+    store_be(b + 2, static_cast<std::uint32_t>(v));
+}
+
+} // namespace lob
@@ -0,0 +1,98 @@
+#pragma once
+/// --------------------------------------------------------
+/// Execution reports
+///
+/// One report per change in an order's state, so a client
+/// can follow its orders without rebuilding them from the
+/// trade stream:
+///   • New            — accepted (sent before any fill)
+///   • PartialFill    — filled in part, leaves_qty still open
+///   • Fill           — filled completely
+///   • Cancelled      — removed from the book by cancel
+///   • Rejected       — refused; reason says why
+///   • PendingNew     — held by the throttle, processed later
+///   • CancelRejected — cancel for an unknown order, or when
+///                      the session takes no cancels
+///
+/// Reports are written into an ExecReportBuffer whose
+/// storage is allocated once, up front; the hot path only
+/// copies 64 bytes per report. The owner drains it (reads,
+/// then clear()) between messages. A full buffer drops
+/// reports and counts them rather than growing.
+/// --------------------------------------------------------
+
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace lob {
+
+enum class ExecType : std::uint8_t { New, PartialFill, Fill, Cancelled, Rejected, PendingNew, CancelRejected };
+
+inline constexpr std::size_t kExecTypeCount = 7;
+
+inline const char* to_string(ExecType type) {
+    switch (type) {
+    case ExecType::New:            return "NEW";
+    case ExecType::PartialFill:    return "PARTIAL_FILL";
+    case ExecType::Fill:           return "FILL";
+    case ExecType::Cancelled:      return "CANCELLED";
+    case ExecType::Rejected:       return "REJECTED";
+    case ExecType::PendingNew:     return "PENDING_NEW";
+    case ExecType::CancelRejected: return "CANCEL_REJECTED";
+    }
+    return "?";
+}
+
+struct ExecReport {
+    std::uint64_t exec_id = 0;   // engine-wide sequence
+    std::uint64_t order_id = 0;
+    std::uint64_t contra_id = 0; // the other order of a fill
+    std::int64_t price = 0;      // fill price for fills, else the order's limit
+    std::int64_t last_qty = 0;   // filled qty for fills, cancelled qty for cancels
+    std::int64_t leaves_qty = 0; // still open in the book
+    std::int64_t cum_qty = 0;    // filled so far
+    std::uint32_t account = 0;
+    ExecType type = ExecType::New;
+    Side side = Side::Buy;
+    RejectReason reason = RejectReason::None;
+};
+
+static_assert(sizeof(ExecReport) == 64, "one report per cache line");
+
+class ExecReportBuffer {
+public:
+    explicit ExecReportBuffer(std::size_t capacity)
+        : reports_(std::make_unique<ExecReport[]>(capacity)), capacity_(capacity) {}
+
+    /// False (and counted in dropped()) when the buffer is full.
+    bool push(const ExecReport& report) noexcept {
+        if (size_ == capacity_) {
+            ++dropped_;
+            return false;
+        }
+        reports_[size_++] = report;
+        return true;
+    }
+
+    void clear() noexcept { size_ = 0; }
+
+    const ExecReport* begin() const noexcept { return reports_.get(); }
+    const ExecReport* end() const noexcept { return reports_.get() + size_; }
+    const ExecReport& operator[](std::size_t i) const noexcept { return reports_[i]; }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    std::size_t capacity() const noexcept { return capacity_; }
+    std::uint64_t dropped() const noexcept { return dropped_; }
+
+private:
+    std::unique_ptr<ExecReport[]> reports_;
+    std::size_t capacity_ = 0;
+    std::size_t size_ = 0;
+    std::uint64_t dropped_ = 0;
+};
+
+} // namespace lob
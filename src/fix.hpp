@@ -0,0 +1,800 @@
+#pragma once
+/// --------------------------------------------------------
+/// FIX 4.4 tag=value order entry
+///
+/// FixDecoder reads one message in place; nothing is copied
+/// or allocated:
+///   • framing: 8=FIX.4.4, then 9=BodyLength, whose body
+///     must end exactly where 10=CheckSum begins
+///   • the checksum (byte sum mod 256 of everything before
+///     10=) is summed 16/32 bytes at a time with SAD
+///   • fields are split on SOH found by a SIMD compare over
+///     16/32-byte blocks; one bitmask per block yields every
+///     separator in it
+///   • Price (44) goes through PriceScale straight into
+///     Order::price as ticks, integer only; OrderQty (38),
+///     Side (54) and Account (1) straight into the Order
+///   • string fields (ClOrdID, OrigClOrdID, Symbol) are
+///     views into the input buffer
+///
+/// Decoded types: NewOrderSingle (D), OrderCancelRequest (F)
+/// and OrderCancelReplaceRequest (G); any other valid
+/// message decodes as Other. Only limit orders (40=2, or no
+/// OrdType) are accepted. Raw data fields, which may hold
+/// SOH, are not supported.
+///
+/// FixStreamReader skips a message it cannot decode and
+/// carries on: a garbled frame (bad BeginString, BodyLength
+/// or CheckSum) up to its end or the next BeginString.
+///
+/// FixEncoder writes ExecutionReports (8), an
+/// OrderCancelReject (9) for a cancel or replace that
+/// failed, a session Reject (3) for a message that did not
+/// decode, plus the three client messages (for tests,
+/// samples and benchmarks), with BodyLength and CheckSum
+/// filled in. String values (CompIDs, ClOrdIDs, Text) are
+/// cut to kMaxValue bytes, so a message always fits in
+/// kMaxMessage.
+///
+/// A replace is carried out as a cancel and a new order:
+/// the client sees Canceled (150=4) under the original
+/// ClOrdID and then New (150=0) under the new one, never
+/// Replaced (150=5), and the order loses its priority. The
+/// new order is entered for OrderQty less what the original
+/// filled (MatchingEngine::replace).
+/// --------------------------------------------------------
+
+#include "exec_report.hpp"
+#include "price.hpp"
+#include "types.hpp"
+
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#endif
+
+namespace lob {
+
+namespace fix {
+inline constexpr char kSoh = '\x01';
+inline constexpr std::string_view kBeginString = "8=FIX.4.4\x01";
+inline constexpr std::size_t kTrailerLength = 7;      // "10=NNN" SOH
+inline constexpr std::size_t kMaxBodyLength = 65'535; // larger is treated as corrupt
+
+namespace tag {
+inline constexpr unsigned Account = 1;
+inline constexpr unsigned AvgPx = 6;
+inline constexpr unsigned BodyLength = 9;
+inline constexpr unsigned CheckSum = 10;
+inline constexpr unsigned ClOrdID = 11;
+inline constexpr unsigned CumQty = 14;
+inline constexpr unsigned ExecID = 17;
+inline constexpr unsigned LastPx = 31;
+inline constexpr unsigned LastQty = 32;
+inline constexpr unsigned MsgSeqNum = 34;
+inline constexpr unsigned MsgType = 35;
+inline constexpr unsigned OrderID = 37;
+inline constexpr unsigned OrderQty = 38;
+inline constexpr unsigned OrdStatus = 39;
+inline constexpr unsigned OrdType = 40;
+inline constexpr unsigned OrigClOrdID = 41;
+inline constexpr unsigned Price = 44;
+inline constexpr unsigned RefSeqNum = 45;
+inline constexpr unsigned SenderCompID = 49;
+inline constexpr unsigned SendingTime = 52;
+inline constexpr unsigned Side = 54;
+inline constexpr unsigned Symbol = 55;
+inline constexpr unsigned TargetCompID = 56;
+inline constexpr unsigned Text = 58;
+inline constexpr unsigned TransactTime = 60;
+inline constexpr unsigned CxlRejReason = 102;
+inline constexpr unsigned ExecType = 150;
+inline constexpr unsigned LeavesQty = 151;
+inline constexpr unsigned SessionRejectReason = 373;
+inline constexpr unsigned CxlRejResponseTo = 434;
+} // namespace tag
+} // namespace fix
+
+enum class FixMsgType : std::uint8_t { NewOrderSingle, OrderCancelRequest, OrderCancelReplaceRequest, Other };
+
+enum class FixError : std::uint8_t {
+    None,
+    Incomplete,     // the buffer ends inside the message
+    BadBeginString, // not 8=FIX.4.4
+    BadBodyLength,  // 9= missing, or the body does not end at 10=
+    BadChecksum,
+    Malformed,      // a field that is not TAG=VALUE, or no MsgType first
+    MissingField,   // a field the message type requires
+    BadSide,
+    BadPrice,
+    BadQty,
+    BadOrdType,     // not a limit order
+};
+
+inline const char* to_string(FixError error) {
+    switch (error) {
+    case FixError::None:           return "ok";
+    case FixError::Incomplete:     return "incomplete message";
+    case FixError::BadBeginString: return "not FIX.4.4";
+    case FixError::BadBodyLength:  return "body length mismatch";
+    case FixError::BadChecksum:    return "checksum mismatch";
+    case FixError::Malformed:      return "malformed field";
+    case FixError::MissingField:   return "required field missing";
+    case FixError::BadSide:        return "unknown side";
+    case FixError::BadPrice:       return "invalid price";
+    case FixError::BadQty:         return "invalid quantity";
+    case FixError::BadOrdType:     return "not a limit order";
+    }
+    return "?";
+}
+
+/// A frame that cannot be trusted at all. FIX drops such a message
+/// without a reply; one that framed but did not decode gets a Reject.
+inline bool is_garbled(FixError error) noexcept {
+    return error == FixError::Incomplete || error == FixError::BadBeginString ||
+           error == FixError::BadBodyLength || error == FixError::BadChecksum;
+}
+
+/// A decoded message. The views point into the decoded buffer.
+struct FixMessage {
+    FixMsgType type = FixMsgType::Other;
+    std::uint64_t seq = 0;         // MsgSeqNum
+    std::string_view clordid;      // ClOrdID
+    std::string_view orig_clordid; // OrigClOrdID (F, G)
+    std::string_view symbol;
+    Order order;                   // side, price (ticks), qty, account; id and ts_ns are the caller's
+};
+
+namespace detail {
+
+#if defined(__AVX2__)
+inline constexpr std::size_t kFixBlock = 32;
+
+inline std::uint32_t soh_mask(const char* p) noexcept {
+    const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, _mm256_set1_epi8(fix::kSoh))));
+}
+
+inline std::uint64_t block_sum(const char* p) noexcept {
+    const auto v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    const auto sad = _mm256_sad_epu8(v, _mm256_setzero_si256());
+    return static_cast<std::uint64_t>(_mm256_extract_epi64(sad, 0) + _mm256_extract_epi64(sad, 1) +
+                                      _mm256_extract_epi64(sad, 2) + _mm256_extract_epi64(sad, 3));
+}
+#elif defined(__SSE2__) || defined(_M_X64)
+inline constexpr std::size_t kFixBlock = 16;
+
+inline std::uint32_t soh_mask(const char* p) noexcept {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(v, _mm_set1_epi8(fix::kSoh))));
+}
+
+inline std::uint64_t block_sum(const char* p) noexcept {
+    const auto v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const auto sad = _mm_sad_epu8(v, _mm_setzero_si128());
+    return static_cast<std::uint64_t>(_mm_cvtsi128_si32(sad)) +
+           static_cast<std::uint64_t>(_mm_cvtsi128_si32(_mm_srli_si128(sad, 8)));
+}
+#else
+inline constexpr std::size_t kFixBlock = 16;
+
+inline std::uint32_t soh_mask(const char* p) noexcept {
+    std::uint32_t mask = 0;
+    for (std::size_t i = 0; i < kFixBlock; ++i) {
+        mask |= static_cast<std::uint32_t>(p[i] == fix::kSoh) << i;
+    }
+    return mask;
+}
+
+inline std::uint64_t block_sum(const char* p) noexcept {
+    std::uint64_t sum = 0;
+    for (std::size_t i = 0; i < kFixBlock; ++i) {
+        sum += static_cast<unsigned char>(p[i]);
+    }
+    return sum;
+}
+#endif
+
+/// Byte sum of [p, p + n) mod 256: the FIX checksum.
+inline unsigned fix_checksum(const char* p, std::size_t n) noexcept {
+    std::uint64_t sum = 0;
+    std::size_t i = 0;
+    for (; i + kFixBlock <= n; i += kFixBlock) {
+        sum += block_sum(p + i);
+    }
+    for (; i < n; ++i) {
+        sum += static_cast<unsigned char>(p[i]);
+    }
+    return static_cast<unsigned>(sum & 0xFF);
+}
+
+/// Hands out the SOH positions of [begin, end) in order, one SIMD
+/// compare per block; the last partial block is scanned bytewise.
+class SohScanner {
+public:
+    SohScanner(const char* begin, const char* end) noexcept : block_(begin), end_(end) { load(); }
+
+    /// Next SOH, or nullptr past the last.
+    const char* next() noexcept {
+        while (mask_ == 0) {
+            block_ += kFixBlock;
+            if (block_ >= end_) {
+                return nullptr;
+            }
+            load();
+        }
+        const auto i = std::countr_zero(mask_);
+        mask_ &= mask_ - 1;
+        return block_ + i;
+    }
+
+private:
+    void load() noexcept {
+        if (static_cast<std::size_t>(end_ - block_) >= kFixBlock) {
+            mask_ = soh_mask(block_);
+            return;
+        }
+        mask_ = 0;
+        for (std::size_t i = 0; block_ + i < end_; ++i) {
+            mask_ |= static_cast<std::uint32_t>(block_[i] == fix::kSoh) << i;
+        }
+    }
+
+    const char* block_;
+    const char* end_;
+    std::uint32_t mask_ = 0;
+};
+
+/// Unsigned decimal, no sign or separators.
+template <typename T>
+inline bool parse_uint(std::string_view text, T& out) noexcept {
+    const auto [end, ec] = std::from_chars(text.data(), text.data() + text.size(), out);
+    return ec == std::errc{} && end == text.data() + text.size() && !text.empty();
+}
+
+} // namespace detail
+
+class FixDecoder {
+public:
+    explicit FixDecoder(const PriceScale& scale = {}) : scale_(scale) {}
+
+    /// Decode the message at the front of [data, data + size). On None,
+    /// `length` is its size in bytes; on Incomplete nothing is consumed.
+    /// Any other error leaves `length` at the framed size when the frame
+    /// itself was sound (the message can be skipped), else 0.
+    FixError decode(const char* data, std::size_t size, FixMessage& out, std::size_t& length) const {
+        length = 0;
+        out = FixMessage{};
+        const auto begin_len = fix::kBeginString.size();
+        if (std::memcmp(data, fix::kBeginString.data(), std::min(size, begin_len)) != 0) {
+            return FixError::BadBeginString;
+        }
+        // 8=FIX.4.4 SOH 9=NNN SOH
+        std::size_t pos = begin_len;
+        if (size < pos + 2) {
+            return FixError::Incomplete;
+        }
+        if (data[pos] != '9' || data[pos + 1] != '=') {
+            return FixError::BadBodyLength;
+        }
+        pos += 2;
+        std::size_t body_length = 0;
+        for (;; ++pos) {
+            if (pos == size) {
+                return FixError::Incomplete;
+            }
+            const char c = data[pos];
+            if (c == fix::kSoh) {
+                break;
+            }
+            if (c < '0' || c > '9' || body_length > fix::kMaxBodyLength) {
+                return FixError::BadBodyLength;
+            }
+            body_length = body_length * 10 + static_cast<std::size_t>(c - '0');
+        }
+        const auto body = pos + 1;
+        const auto trailer = body + body_length;
+        if (body_length == 0 || body_length > fix::kMaxBodyLength) {
+            return FixError::BadBodyLength;
+        }
+        if (size < trailer + fix::kTrailerLength) {
+            return FixError::Incomplete;
+        }
+        const char* t = data + trailer;
+        if (t[-1] != fix::kSoh || t[0] != '1' || t[1] != '0' || t[2] != '=' || t[6] != fix::kSoh) {
+            return FixError::BadBodyLength;
+        }
+        unsigned expected = 0;
+        for (int i = 3; i < 6; ++i) {
+            if (t[i] < '0' || t[i] > '9') {
+                return FixError::BadChecksum;
+            }
+            expected = expected * 10 + static_cast<unsigned>(t[i] - '0');
+        }
+        length = trailer + fix::kTrailerLength;
+        if (detail::fix_checksum(data, trailer) != expected) {
+            return FixError::BadChecksum;
+        }
+        return decode_body(data + body, data + trailer, out);
+    }
+
+private:
+    struct Seen {
+        bool clordid = false;
+        bool orig_clordid = false;
+        bool side = false;
+        bool qty = false;
+        bool price = false;
+    };
+
+    FixError decode_body(const char* p, const char* end, FixMessage& out) const {
+        Seen seen;
+        detail::SohScanner scanner(p, end);
+        bool first = true;
+        for (const char* soh = scanner.next(); soh != nullptr; soh = scanner.next()) {
+            unsigned tag = 0;
+            const char* c = p;
+            for (; c < soh && *c >= '0' && *c <= '9'; ++c) {
+                tag = tag * 10 + static_cast<unsigned>(*c - '0');
+            }
+            if (c == p || c == soh || *c != '=') {
+                return FixError::Malformed;
+            }
+            const std::string_view value(c + 1, static_cast<std::size_t>(soh - c - 1));
+            p = soh + 1;
+            if (first != (tag == fix::tag::MsgType)) {
+                return FixError::Malformed;
+            }
+            first = false;
+            const auto error = field(tag, value, out, seen);
+            if (error != FixError::None) {
+                return error;
+            }
+        }
+        if (first) {
+            return FixError::Malformed;
+        }
+        return check_required(out.type, seen);
+    }
+
+    FixError field(unsigned tag, std::string_view value, FixMessage& out, Seen& seen) const {
+        switch (tag) {
+        case fix::tag::MsgType:
+            out.type = value == "D"   ? FixMsgType::NewOrderSingle
+                       : value == "F" ? FixMsgType::OrderCancelRequest
+                       : value == "G" ? FixMsgType::OrderCancelReplaceRequest
+                                      : FixMsgType::Other;
+            break;
+        case fix::tag::MsgSeqNum:
+            if (!detail::parse_uint(value, out.seq)) {
+                return FixError::Malformed;
+            }
+            break;
+        case fix::tag::ClOrdID:
+            out.clordid = value;
+            seen.clordid = !value.empty();
+            break;
+        case fix::tag::OrigClOrdID:
+            out.orig_clordid = value;
+            seen.orig_clordid = !value.empty();
+            break;
+        case fix::tag::Symbol:
+            out.symbol = value;
+            break;
+        case fix::tag::Account:
+            if (!detail::parse_uint(value, out.order.account)) {
+                return FixError::Malformed;
+            }
+            break;
+        case fix::tag::Side:
+            if (value.size() != 1 || (value[0] != '1' && value[0] != '2')) {
+                return FixError::BadSide;
+            }
+            out.order.side = value[0] == '1' ? Side::Buy : Side::Sell;
+            seen.side = true;
+            break;
+        case fix::tag::OrderQty: {
+            std::uint64_t qty = 0;
+            if (!detail::parse_uint(value, qty) || qty == 0 || qty > static_cast<std::uint64_t>(std::numeric_limits<std::int64_t>::max())) {
+                return FixError::BadQty;
+            }
+            out.order.qty = static_cast<std::int64_t>(qty);
+            seen.qty = true;
+            break;
+        }
+        case fix::tag::Price:
+            if (scale_.parse(value, out.order.price) != PriceError::None) {
+                return FixError::BadPrice;
+            }
+            seen.price = true;
+            break;
+        case fix::tag::OrdType:
+            if (value != "2") {
+                return FixError::BadOrdType;
+            }
+            break;
+        default:
+            break;
+        }
+        return FixError::None;
+    }
+
+    static FixError check_required(FixMsgType type, const Seen& seen) noexcept {
+        switch (type) {
+        case FixMsgType::NewOrderSingle:
+            return seen.clordid && seen.side && seen.qty && seen.price ? FixError::None : FixError::MissingField;
+        case FixMsgType::OrderCancelRequest:
+            return seen.clordid && seen.orig_clordid ? FixError::None : FixError::MissingField;
+        case FixMsgType::OrderCancelReplaceRequest:
+            return seen.clordid && seen.orig_clordid && seen.side && seen.qty && seen.price ? FixError::None
+                                                                                             : FixError::MissingField;
+        case FixMsgType::Other:
+            break;
+        }
+        return FixError::None;
+    }
+
+    PriceScale scale_;
+};
+
+/// Reads a stream a chunk at a time and hands out its FIX messages.
+/// Line breaks between messages (as in a FIX log) are skipped.
+class FixStreamReader {
+public:
+    explicit FixStreamReader(std::istream& in, const FixDecoder& decoder, std::size_t chunk = 1 << 16)
+        : in_(in), decoder_(decoder), buf_(chunk) {}
+
+    /// Next message; its views stay valid until the following call. True
+    /// for each message, with error None, or with the reason it did not
+    /// decode: it has been skipped, and `out` holds the fields read before
+    /// the error (a garbled frame is skipped up to the next BeginString).
+    /// False at the end of the input (error Incomplete when it ends inside
+    /// a message).
+    bool next(FixMessage& out, FixError& error) {
+        for (;;) {
+            while (pos_ < len_ && (buf_[pos_] == '\n' || buf_[pos_] == '\r')) {
+                ++pos_;
+            }
+            std::size_t length = 0;
+            error = pos_ < len_ ? decoder_.decode(buf_.data() + pos_, len_ - pos_, out, length)
+                                : FixError::Incomplete;
+            if (error != FixError::Incomplete) {
+                if (length > 0) {
+                    pos_ += length;
+                } else {
+                    resync();
+                }
+                return true;
+            }
+            if (!fill()) {
+                error = pos_ == len_ ? FixError::None : FixError::Incomplete;
+                return false;
+            }
+        }
+    }
+
+private:
+    /// Drop at least one byte, then up to the next BeginString.
+    void resync() {
+        const auto begin = fix::kBeginString;
+        ++pos_;
+        for (;;) {
+            const std::string_view rest(buf_.data() + pos_, len_ - pos_);
+            const auto at = rest.find(begin);
+            if (at != std::string_view::npos) {
+                pos_ += at;
+                return;
+            }
+            pos_ = len_ - std::min(rest.size(), begin.size() - 1); // may start one
+            if (!fill()) {
+                pos_ = len_;
+                return;
+            }
+        }
+    }
+
+    /// Read more input behind what is left; false once none comes.
+    bool fill() {
+        const auto rest = len_ - pos_;
+        std::memmove(buf_.data(), buf_.data() + pos_, rest);
+        pos_ = 0;
+        len_ = rest;
+        if (len_ == buf_.size()) {
+            buf_.resize(buf_.size() * 2); // a message longer than a chunk
+        }
+        in_.read(buf_.data() + len_, static_cast<std::streamsize>(buf_.size() - len_));
+        const auto got = static_cast<std::size_t>(in_.gcount());
+        len_ += got;
+        return got > 0;
+    }
+
+    std::istream& in_;
+    const FixDecoder& decoder_;
+    std::vector<char> buf_;
+    std::size_t pos_ = 0;
+    std::size_t len_ = 0;
+};
+
+/// Writes messages into a caller buffer of kMaxMessage bytes. Each call
+/// stamps the next MsgSeqNum and returns a view of the finished message.
+class FixEncoder {
+public:
+    static constexpr std::size_t kMaxMessage = 1024;
+    static constexpr std::size_t kMaxValue = 64; // longer strings are cut
+
+    FixEncoder(std::string_view sender, std::string_view target, const PriceScale& scale = {})
+        : sender_(sender.substr(0, kMaxValue)), target_(target.substr(0, kMaxValue)), scale_(scale) {}
+
+    /// ExecutionReport for r; OrderCancelReject for a CancelRejected
+    /// report, answering a request of type `request` (F or G). AvgPx is
+    /// not tracked by the engine and is sent as 0.
+    std::string_view execution_report(const ExecReport& r, std::string_view clordid, std::uint64_t time_ns,
+                                      char* out, FixMsgType request = FixMsgType::OrderCancelRequest) {
+        if (r.type == ExecType::CancelRejected) {
+            Writer w = start(out, "9", time_ns);
+            if (r.order_id == std::numeric_limits<std::uint64_t>::max()) { // no such order
+                w.field(fix::tag::OrderID, std::string_view("NONE"));
+            } else {
+                w.field(fix::tag::OrderID, r.order_id);
+            }
+            w.field(fix::tag::ClOrdID, clordid.empty() ? std::string_view("NONE") : clordid);
+            w.field(fix::tag::OrdStatus, '8');
+            w.field(fix::tag::CxlRejResponseTo, request == FixMsgType::OrderCancelReplaceRequest ? '2' : '1');
+            w.field(fix::tag::CxlRejReason, cxl_rej_reason(r.reason));
+            if (r.reason != RejectReason::None) {
+                w.field(fix::tag::Text, std::string_view(to_string(r.reason)));
+            }
+            return finish(out, w);
+        }
+        Writer w = start(out, "8", time_ns);
+        w.field(fix::tag::OrderID, r.order_id);
+        if (!clordid.empty()) {
+            w.field(fix::tag::ClOrdID, clordid);
+        }
+        w.field(fix::tag::ExecID, r.exec_id);
+        w.field(fix::tag::ExecType, exec_type(r.type));
+        w.field(fix::tag::OrdStatus, ord_status(r.type));
+        if (r.account != 0) {
+            w.field(fix::tag::Account, std::uint64_t{r.account});
+        }
+        w.field(fix::tag::Side, r.side == Side::Buy ? '1' : '2');
+        if (r.type == ExecType::PartialFill || r.type == ExecType::Fill) {
+            w.field(fix::tag::LastQty, r.last_qty);
+            w.price(fix::tag::LastPx, r.price, scale_);
+        } else {
+            w.price(fix::tag::Price, r.price, scale_);
+        }
+        w.field(fix::tag::LeavesQty, r.leaves_qty);
+        w.field(fix::tag::CumQty, r.cum_qty);
+        w.field(fix::tag::AvgPx, '0');
+        if (r.type == ExecType::Rejected) {
+            w.field(fix::tag::Text, std::string_view(to_string(r.reason)));
+        }
+        return finish(out, w);
+    }
+
+    /// Session-level Reject of message `ref_seq` (0 if unknown), which
+    /// did not decode.
+    std::string_view session_reject(std::uint64_t ref_seq, FixError error, std::uint64_t time_ns, char* out) {
+        Writer w = start(out, "3", time_ns);
+        w.field(fix::tag::RefSeqNum, ref_seq);
+        w.field(fix::tag::SessionRejectReason, session_reject_reason(error));
+        w.field(fix::tag::Text, std::string_view(to_string(error)));
+        return finish(out, w);
+    }
+
+    /// NewOrderSingle for a limit order.
+    std::string_view new_order(const Order& order, std::string_view clordid, std::uint64_t time_ns, char* out) {
+        Writer w = start(out, "D", time_ns);
+        w.field(fix::tag::ClOrdID, clordid);
+        order_fields(w, order);
+        return finish(out, w);
+    }
+
+    std::string_view cancel_request(std::string_view orig_clordid, std::string_view clordid, Side side,
+                                    std::uint64_t time_ns, char* out) {
+        Writer w = start(out, "F", time_ns);
+        w.field(fix::tag::OrigClOrdID, orig_clordid);
+        w.field(fix::tag::ClOrdID, clordid);
+        w.field(fix::tag::Side, side == Side::Buy ? '1' : '2');
+        return finish(out, w);
+    }
+
+    /// OrderCancelReplaceRequest moving orig_clordid to order's price and qty.
+    std::string_view replace_request(std::string_view orig_clordid, std::string_view clordid, const Order& order,
+                                     std::uint64_t time_ns, char* out) {
+        Writer w = start(out, "G", time_ns);
+        w.field(fix::tag::OrigClOrdID, orig_clordid);
+        w.field(fix::tag::ClOrdID, clordid);
+        order_fields(w, order);
+        return finish(out, w);
+    }
+
+private:
+    // Room in front of the body for 8=FIX.4.4 SOH 9=NNNNN SOH.
+    static constexpr std::size_t kHeaderRoom = 24;
+
+    struct Writer {
+        char* p;
+
+        void raw(std::string_view s) noexcept {
+            std::memcpy(p, s.data(), s.size());
+            p += s.size();
+        }
+
+        void tag(unsigned t) noexcept {
+            p = std::to_chars(p, p + 8, t).ptr;
+            *p++ = '=';
+        }
+
+        void field(unsigned t, std::string_view value) noexcept {
+            tag(t);
+            raw(value.substr(0, kMaxValue));
+            *p++ = fix::kSoh;
+        }
+
+        void field(unsigned t, char value) noexcept {
+            tag(t);
+            *p++ = value;
+            *p++ = fix::kSoh;
+        }
+
+        template <std::integral Int>
+        void field(unsigned t, Int value) noexcept {
+            tag(t);
+            p = std::to_chars(p, p + 24, value).ptr;
+            *p++ = fix::kSoh;
+        }
+
+        void price(unsigned t, std::int64_t ticks, const PriceScale& scale) noexcept {
+            tag(t);
+            p += scale.format(ticks, p);
+            *p++ = fix::kSoh;
+        }
+    };
+
+    Writer start(char* out, std::string_view type, std::uint64_t time_ns) {
+        Writer w{out + kHeaderRoom};
+        w.field(fix::tag::MsgType, type);
+        w.field(fix::tag::SenderCompID, sender_);
+        w.field(fix::tag::TargetCompID, target_);
+        w.field(fix::tag::MsgSeqNum, ++seq_);
+        w.tag(fix::tag::SendingTime);
+        w.p = format_utc(time_ns, w.p);
+        *w.p++ = fix::kSoh;
+        return w;
+    }
+
+    void order_fields(Writer& w, const Order& order) const {
+        if (order.account != 0) {
+            w.field(fix::tag::Account, std::uint64_t{order.account});
+        }
+        w.field(fix::tag::Side, order.side == Side::Buy ? '1' : '2');
+        w.field(fix::tag::OrderQty, order.qty);
+        w.field(fix::tag::OrdType, '2');
+        w.price(fix::tag::Price, order.price, scale_);
+    }
+
+    /// Prepend 8= and 9= in front of the body, append 10=.
+    static std::string_view finish(char* out, Writer& w) {
+        char* body = out + kHeaderRoom;
+        const auto body_length = static_cast<std::size_t>(w.p - body);
+        char digits[8];
+        const auto digits_end = std::to_chars(digits, digits + sizeof(digits), body_length).ptr;
+        const auto n = static_cast<std::size_t>(digits_end - digits);
+        char* begin = body - (fix::kBeginString.size() + 3 + n);
+        Writer h{begin};
+        h.raw(fix::kBeginString);
+        h.raw("9=");
+        h.raw({digits, n});
+        *h.p++ = fix::kSoh;
+
+        const auto sum = detail::fix_checksum(begin, static_cast<std::size_t>(w.p - begin));
+        w.raw("10=");
+        *w.p++ = static_cast<char>('0' + sum / 100);
+        *w.p++ = static_cast<char>('0' + sum / 10 % 10);
+        *w.p++ = static_cast<char>('0' + sum % 10);
+        *w.p++ = fix::kSoh;
+        return {begin, static_cast<std::size_t>(w.p - begin)};
+    }
+
+    /// UTC YYYYMMDD-HH:MM:SS.sss from ns since the epoch.
+    static char* format_utc(std::uint64_t ns, char* p) noexcept {
+        const auto ms = ns / 1'000'000;
+        const auto secs = ms / 1'000;
+        auto days = static_cast<std::int64_t>(secs / 86'400);
+        const auto sod = secs % 86'400;
+        // Civil date from days since 1970-01-01 (Howard Hinnant's algorithm).
+        days += 719'468;
+        const auto era = days / 146'097;
+        const auto doe = days - era * 146'097;
+        const auto yoe = (doe - doe / 1'460 + doe / 36'524 - doe / 146'096) / 365;
+        const auto doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const auto mp = (5 * doy + 2) / 153;
+        const auto day = doy - (153 * mp + 2) / 5 + 1;
+        const auto month = mp < 10 ? mp + 3 : mp - 9;
+        const auto year = yoe + era * 400 + (month <= 2);
+
+        const auto put = [&p](std::uint64_t v, int width) {
+            for (int i = width - 1; i >= 0; --i) {
+                p[i] = static_cast<char>('0' + v % 10);
+                v /= 10;
+            }
+            p += width;
+        };
+        put(static_cast<std::uint64_t>(year), 4);
+        put(static_cast<std::uint64_t>(month), 2);
+        put(static_cast<std::uint64_t>(day), 2);
+        *p++ = '-';
+        put(sod / 3'600, 2);
+        *p++ = ':';
+        put(sod / 60 % 60, 2);
+        *p++ = ':';
+        put(sod % 60, 2);
+        *p++ = '.';
+        put(ms % 1'000, 3);
+        return p;
+    }
+
+    static char exec_type(ExecType type) noexcept {
+        switch (type) {
+        case ExecType::New:         return '0';
+        case ExecType::PartialFill: return 'F';
+        case ExecType::Fill:        return 'F';
+        case ExecType::Cancelled:   return '4';
+        case ExecType::PendingNew:  return 'A';
+        default:                    return '8';
+        }
+    }
+
+    static char cxl_rej_reason(RejectReason reason) noexcept {
+        switch (reason) {
+        case RejectReason::None:             return '1'; // unknown order
+        case RejectReason::TooLate:          return '0'; // too late to cancel
+        case RejectReason::DuplicateClOrdId: return '6';
+        default:                             return '2'; // other
+        }
+    }
+
+    static unsigned session_reject_reason(FixError error) noexcept {
+        switch (error) {
+        case FixError::MissingField: return 1;  // required tag missing
+        case FixError::BadSide:
+        case FixError::BadPrice:
+        case FixError::BadQty:
+        case FixError::BadOrdType:   return 5;  // value incorrect for this tag
+        default:                     return 99; // other
+        }
+    }
+
+    static char ord_status(ExecType type) noexcept {
+        switch (type) {
+        case ExecType::New:         return '0';
+        case ExecType::PartialFill: return '1';
+        case ExecType::Fill:        return '2';
+        case ExecType::Cancelled:   return '4';
+        case ExecType::PendingNew:  return 'A';
+        default:                    return '8';
+        }
+    }
+
+    std::string sender_;
+    std::string target_;
+    PriceScale scale_;
+    std::uint64_t seq_ = 0;
+};
+
+} // namespace lob
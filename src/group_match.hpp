@@ -0,0 +1,67 @@
+#pragma once
+/// --------------------------------------------------------
+/// Interleaved matching across many symbols on one core
+///
+/// With thousands of books, an order's book is rarely in
+/// cache: the engine header, then the best level and the id
+/// slot it points to, are two dependent misses. Orders are
+/// processed in arrival order, but software-pipelined over a
+/// window of K:
+///
+///   order i + 2K   prefetch_state()   engine + book headers
+///   order i + K    prefetch_levels()  levels and id slot
+///   order i        process()          mostly cache hits
+///
+/// so the misses of 2K later orders overlap the matching of
+/// this one. Prefetches are hints only: the trades are the
+/// same as processing one order at a time, for any K.
+/// --------------------------------------------------------
+
+#include "matching_engine.hpp"
+#include "replay.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lob {
+
+struct RoutedOrder {
+    std::uint32_t symbol = 0;
+    bool cancel = false; // cancel order.id
+    Order order;
+};
+
+/// Process orders[0, n) against engines[order.symbol], prefetching `window`
+/// orders ahead (0: none). Trades are appended to `out`, stamped with the
+/// order's ts_ns.
+template <typename Engine>
+void process_interleaved(const std::vector<std::unique_ptr<Engine>>& engines, const RoutedOrder* orders,
+                         std::size_t n, std::size_t window, std::vector<SymbolTrade>& out) {
+    std::vector<Trade> trades;
+    trades.reserve(64);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (window > 0) {
+            if (i + 2 * window < n) {
+                engines[orders[i + 2 * window].symbol]->prefetch_state();
+            }
+            if (i + window < n) {
+                const auto& ahead = orders[i + window];
+                engines[ahead.symbol]->prefetch_levels(ahead.order);
+            }
+        }
+        const auto& routed = orders[i];
+        auto& engine = *engines[routed.symbol];
+        if (routed.cancel) {
+            engine.cancel(routed.order.id);
+            continue;
+        }
+        engine.process(routed.order, trades);
+        for (const auto& t : trades) {
+            out.push_back({routed.order.ts_ns, routed.symbol, t});
+        }
+        trades.clear();
+    }
+}
+
+} // namespace lob
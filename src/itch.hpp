@@ -0,0 +1,396 @@
+#pragma once
+/// --------------------------------------------------------
+/// ITCH 5.0 replay into passive books
+///
+/// Input is the BinaryFILE framing exchanges ship: each
+/// message preceded by its 2-byte big-endian length. Decoded
+/// in place (the file is mapped, never copied), fields read
+/// big-endian with bswap, dispatched through a 256-entry
+/// table on the message type:
+///
+///   A  Add Order               F  Add Order with MPID
+///   E  Order Executed          C  Executed with Price
+///   X  Order Cancel            D  Order Delete
+///   U  Order Replace
+///
+/// Every other type is skipped by its length. Each stock
+/// locate gets its own BookBuilder, which only mirrors the
+/// feed: adds rest without matching, executions and cancels
+/// reduce in place, replaces move the order to a new id and
+/// price. A second cursor walks `window` messages ahead and
+/// prefetches what they will touch (see book_builder.hpp).
+///
+/// Prices are ITCH's 1/10000 units; order ids the feed's
+/// order reference numbers.
+/// --------------------------------------------------------
+
+#include "book_builder.hpp"
+#include "endian.hpp"
+#include "metrics.hpp"
+#include "time_utils.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+/// Message lengths, excluding the 2-byte length prefix.
+namespace itch {
+inline constexpr std::size_t kAddLength = 36;
+inline constexpr std::size_t kAddMpidLength = 40;
+inline constexpr std::size_t kExecutedLength = 31;
+inline constexpr std::size_t kExecutedPriceLength = 36;
+inline constexpr std::size_t kCancelLength = 23;
+inline constexpr std::size_t kDeleteLength = 19;
+inline constexpr std::size_t kReplaceLength = 35;
+inline constexpr std::size_t kSystemEventLength = 12;
+inline constexpr std::size_t kStockDirectoryLength = 39;
+
+// Header shared by every message: type, locate, tracking, timestamp.
+inline constexpr std::size_t kLocate = 1;
+inline constexpr std::size_t kTimestamp = 5;
+inline constexpr std::size_t kOrderRef = 11;
+} // namespace itch
+
+struct ItchStats {
+    std::uint64_t messages = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t unknown_refs = 0;  // execute/cancel/delete/replace of no resting order
+                                     // (or a replace to a reference still resting)
+    std::uint64_t duplicate_ids = 0; // add of an order reference that is still resting
+    std::uint64_t malformed = 0;     // shorter than their type's layout
+    bool truncated = false;          // the file ends inside a message
+    std::array<std::uint64_t, 256> by_type{};
+};
+
+template <typename Book = FlatListOrderBook>
+class ItchReplay {
+public:
+    using builder_type = BookBuilder<Book>;
+
+    /// Time every `sample_every`-th message into latency() (0: none) and
+    /// prefetch `window` messages ahead (0: none).
+    explicit ItchReplay(std::size_t sample_every = 64, std::size_t window = 8)
+        : sample_every_(sample_every), window_(window) {}
+
+    /// Apply every message of a BinaryFILE buffer.
+    void replay(const std::uint8_t* data, std::size_t size) {
+        const double ns_per_tick = sample_every_ > 0 ? 1e9 / tsc_ticks_per_second() : 0.0;
+        std::size_t pos = 0;
+        std::size_t until_sample = sample_every_;
+        // Cursors 2K and K messages ahead of pos.
+        std::size_t early = 0;
+        std::size_t late = 0;
+        for (std::size_t i = 0; i < 2 * window_; ++i) {
+            if (i == window_) {
+                late = early;
+            }
+            early = prefetch_at(data, size, early, true);
+        }
+        while (pos + 2 <= size) {
+            const auto len = load_be<std::uint16_t>(data + pos);
+            if (pos + 2 + len > size) {
+                stats_.truncated = true;
+                break;
+            }
+            const auto* msg = data + pos + 2;
+            pos += 2 + len;
+            if (window_ > 0) {
+                early = prefetch_at(data, size, early, true);
+                late = prefetch_at(data, size, late, false);
+            }
+            if (len == 0) {
+                continue;
+            }
+            ++stats_.messages;
+            ++stats_.by_type[msg[0]];
+            if (until_sample > 0 && --until_sample == 0) {
+                until_sample = sample_every_;
+                const auto start = read_tsc();
+                kHandlers[msg[0]](*this, msg, len);
+                latency_.add(static_cast<std::uint64_t>(static_cast<double>(read_tsc() - start) * ns_per_tick));
+            } else {
+                kHandlers[msg[0]](*this, msg, len);
+            }
+        }
+        stats_.bytes += pos;
+    }
+
+    const ItchStats& stats() const noexcept { return stats_; }
+
+    /// Per-message apply time of the sampled messages.
+    const LatencyStats& latency() const noexcept { return latency_; }
+
+    /// Book of a stock locate, or nullptr if it has seen no adds.
+    const Book* book(std::uint16_t locate) const noexcept {
+        return builders_[locate] ? &builders_[locate]->book() : nullptr;
+    }
+
+    /// fn(locate, book) for every book, in locate order.
+    template <typename Fn>
+    void for_each_book(Fn&& fn) const {
+        for (std::size_t locate = 0; locate < builders_.size(); ++locate) {
+            if (builders_[locate]) {
+                fn(static_cast<std::uint16_t>(locate), builders_[locate]->book());
+            }
+        }
+    }
+
+private:
+    using Handler = void (*)(ItchReplay&, const std::uint8_t*, std::size_t);
+
+    /// Prefetch for the message framed at pos (early or late stage);
+    /// returns the position of the next one.
+    std::size_t prefetch_at(const std::uint8_t* data, std::size_t size, std::size_t pos, bool early) const noexcept {
+        if (pos + 2 > size) {
+            return pos;
+        }
+        const auto len = load_be<std::uint16_t>(data + pos);
+        if (pos + 2 + len > size) {
+            return size;
+        }
+        const auto* msg = data + pos + 2;
+        const auto type = len > 0 ? msg[0] : 0;
+        const bool add = type == 'A' || type == 'F';
+        const bool by_id = type == 'E' || type == 'C' || type == 'X' || type == 'D' || type == 'U';
+        if ((add && len >= itch::kAddLength) || (by_id && len >= itch::kDeleteLength)) {
+            const auto* builder = builders_[load_be<std::uint16_t>(msg + itch::kLocate)].get();
+            if (builder != nullptr) {
+                BookUpdate u;
+                u.type = add ? BookUpdate::Type::Add : BookUpdate::Type::Delete;
+                u.id = load_be<std::uint64_t>(msg + itch::kOrderRef);
+                if (add) {
+                    u.side = msg[19] == 'B' ? Side::Buy : Side::Sell;
+                    u.price = load_be<std::uint32_t>(msg + 32);
+                }
+                if (early) {
+                    builder->prefetch_early(u);
+                } else {
+                    builder->prefetch_late(u);
+                }
+            }
+        }
+        return pos + 2 + len;
+    }
+
+    static void on_skip(ItchReplay&, const std::uint8_t*, std::size_t) noexcept {}
+
+    template <std::size_t kLength>
+    static bool fits(ItchReplay& self, std::size_t len) noexcept {
+        if (len < kLength) {
+            ++self.stats_.malformed;
+            return false;
+        }
+        return true;
+    }
+
+    builder_type& builder_for(const std::uint8_t* msg) {
+        auto& slot = builders_[load_be<std::uint16_t>(msg + itch::kLocate)];
+        if (!slot) {
+            slot = std::make_unique<builder_type>();
+        }
+        return *slot;
+    }
+
+    builder_type* existing_builder(const std::uint8_t* msg) noexcept {
+        auto* builder = builders_[load_be<std::uint16_t>(msg + itch::kLocate)].get();
+        if (builder == nullptr) {
+            ++stats_.unknown_refs;
+        }
+        return builder;
+    }
+
+    /// A (and F, whose extra MPID field follows the same layout).
+    template <std::size_t kLength>
+    static void on_add(ItchReplay& self, const std::uint8_t* msg, std::size_t len) {
+        if (!fits<kLength>(self, len)) {
+            return;
+        }
+        if (!self.builder_for(msg).add(load_be<std::uint64_t>(msg + itch::kOrderRef),
+                                       msg[19] == 'B' ? Side::Buy : Side::Sell, load_be<std::uint32_t>(msg + 32),
+                                       load_be<std::uint32_t>(msg + 20), load_be48(msg + itch::kTimestamp))) {
+            ++self.stats_.duplicate_ids;
+        }
+    }
+
+    /// E and C: executed shares follow the order reference.
+    template <std::size_t kLength>
+    static void on_executed(ItchReplay& self, const std::uint8_t* msg, std::size_t len) {
+        if (fits<kLength>(self, len)) {
+            self.reduce(msg, load_be<std::uint32_t>(msg + 19));
+        }
+    }
+
+    static void on_cancel(ItchReplay& self, const std::uint8_t* msg, std::size_t len) {
+        if (fits<itch::kCancelLength>(self, len)) {
+            self.reduce(msg, load_be<std::uint32_t>(msg + 19));
+        }
+    }
+
+    static void on_delete(ItchReplay& self, const std::uint8_t* msg, std::size_t len) {
+        if (!fits<itch::kDeleteLength>(self, len)) {
+            return;
+        }
+        auto* builder = self.existing_builder(msg);
+        if (builder != nullptr && !builder->remove(load_be<std::uint64_t>(msg + itch::kOrderRef))) {
+            ++self.stats_.unknown_refs;
+        }
+    }
+
+    /// The replacement loses priority: new id, price and size.
+    static void on_replace(ItchReplay& self, const std::uint8_t* msg, std::size_t len) {
+        if (!fits<itch::kReplaceLength>(self, len)) {
+            return;
+        }
+        auto* builder = self.existing_builder(msg);
+        if (builder != nullptr &&
+            !builder->replace(load_be<std::uint64_t>(msg + itch::kOrderRef), load_be<std::uint64_t>(msg + 19),
+                              load_be<std::uint32_t>(msg + 31), load_be<std::uint32_t>(msg + 27),
+                              load_be48(msg + itch::kTimestamp))) {
+            ++self.stats_.unknown_refs;
+        }
+    }
+
+    void reduce(const std::uint8_t* msg, std::int64_t shares) {
+        auto* builder = existing_builder(msg);
+        if (builder != nullptr && !builder->reduce(load_be<std::uint64_t>(msg + itch::kOrderRef), shares)) {
+            ++stats_.unknown_refs;
+        }
+    }
+
+    static constexpr std::array<Handler, 256> make_handlers() {
+        std::array<Handler, 256> table{};
+        for (auto& h : table) {
+            h = &on_skip;
+        }
+        table['A'] = &on_add<itch::kAddLength>;
+        table['F'] = &on_add<itch::kAddMpidLength>;
+        table['E'] = &on_executed<itch::kExecutedLength>;
+        table['C'] = &on_executed<itch::kExecutedPriceLength>;
+        table['X'] = &on_cancel;
+        table['D'] = &on_delete;
+        table['U'] = &on_replace;
+        return table;
+    }
+
+    static constexpr std::array<Handler, 256> kHandlers = make_handlers();
+
+    std::vector<std::unique_ptr<builder_type>> builders_ = std::vector<std::unique_ptr<builder_type>>(65536);
+    ItchStats stats_;
+    LatencyStats latency_;
+    std::size_t sample_every_;
+    std::size_t window_;
+};
+
+/// Synthetic BinaryFILE sample: a system event, one stock directory entry
+/// per stock, then `messages` order events over `stocks` locates (1..N)
+/// referring only to live orders: about 45% adds (a tenth with MPID), 10%
+/// executions, 10% partial cancels, 25% deletes and 10% replaces. Bids
+/// are priced within 0.50 below 100.00 and asks above, in cent steps, so
+/// the books never cross.
+inline void write_itch_sample(std::ostream& out, std::size_t messages, std::uint16_t stocks, std::uint64_t seed) {
+    struct Live {
+        std::uint64_t ref;
+        std::uint32_t shares;
+        bool buy;
+    };
+    stocks = std::max<std::uint16_t>(stocks, 1);
+    std::mt19937_64 rng(seed);
+    std::vector<std::vector<Live>> live(stocks + 1u);
+    std::uint64_t next_ref = 1;
+    std::uint64_t ts = 34'200'000'000'000; // 09:30 in ns since midnight
+    std::uint8_t buf[2 + 64];
+
+    const auto emit = [&](char type, std::uint16_t locate, std::size_t len) {
+        store_be(buf, static_cast<std::uint16_t>(len));
+        std::fill(buf + 2, buf + 2 + len, std::uint8_t{0});
+        buf[2] = static_cast<std::uint8_t>(type);
+        store_be(buf + 2 + itch::kLocate, locate);
+        store_be48(buf + 2 + itch::kTimestamp, ts);
+        ts += 1 + rng() % 2'000;
+        return buf + 2;
+    };
+    const auto flush = [&](std::size_t len) {
+        out.write(reinterpret_cast<const char*>(buf), static_cast<std::streamsize>(2 + len));
+    };
+
+    auto* msg = emit('S', 0, itch::kSystemEventLength);
+    msg[11] = 'O';
+    flush(itch::kSystemEventLength);
+    for (std::uint16_t s = 1; s <= stocks; ++s) {
+        msg = emit('R', s, itch::kStockDirectoryLength);
+        char name[8] = {'S', 'Y', 'M', ' ', ' ', ' ', ' ', ' '};
+        for (unsigned v = s, i = 7; v > 0 && i >= 3; v /= 10, --i) {
+            name[i] = static_cast<char>('0' + v % 10);
+        }
+        std::copy(name, name + 8, msg + 11);
+        flush(itch::kStockDirectoryLength);
+    }
+
+    const auto price = [&](bool buy) {
+        const auto ticks = static_cast<std::uint32_t>(rng() % 51) * 100;
+        return buy ? 1'000'000 - ticks : 1'000'100 + ticks;
+    };
+    for (std::size_t i = 0; i < messages; ++i) {
+        const auto locate = static_cast<std::uint16_t>(1 + rng() % stocks);
+        auto& orders = live[locate];
+        const auto roll = rng() % 100;
+        if (orders.empty() || roll < 45) {
+            const bool mpid = roll % 10 == 0;
+            const auto len = mpid ? itch::kAddMpidLength : itch::kAddLength;
+            msg = emit(mpid ? 'F' : 'A', locate, len);
+            const Live order{next_ref++, static_cast<std::uint32_t>(1 + rng() % 1'000), rng() % 2 == 0};
+            store_be(msg + itch::kOrderRef, order.ref);
+            msg[19] = order.buy ? 'B' : 'S';
+            store_be(msg + 20, order.shares);
+            std::copy_n("SYM     ", 8, msg + 24);
+            store_be(msg + 32, price(order.buy));
+            orders.push_back(order);
+            flush(len);
+            continue;
+        }
+        const auto pick = rng() % orders.size();
+        auto& order = orders[pick];
+        const auto drop = [&] {
+            order = orders.back();
+            orders.pop_back();
+        };
+        if (roll < 65) {
+            const bool executed = roll < 55;
+            const auto len = executed ? itch::kExecutedLength : itch::kCancelLength;
+            msg = emit(executed ? 'E' : 'X', locate, len);
+            const auto shares = static_cast<std::uint32_t>(1 + rng() % order.shares);
+            store_be(msg + itch::kOrderRef, order.ref);
+            store_be(msg + 19, shares);
+            if (executed) {
+                store_be(msg + 23, static_cast<std::uint64_t>(i + 1)); // match number
+            }
+            flush(len);
+            order.shares -= shares;
+            if (order.shares == 0) {
+                drop();
+            }
+        } else if (roll < 90) {
+            msg = emit('D', locate, itch::kDeleteLength);
+            store_be(msg + itch::kOrderRef, order.ref);
+            flush(itch::kDeleteLength);
+            drop();
+        } else {
+            msg = emit('U', locate, itch::kReplaceLength);
+            store_be(msg + itch::kOrderRef, order.ref);
+            order = {next_ref++, static_cast<std::uint32_t>(1 + rng() % 1'000), order.buy};
+            store_be(msg + 19, order.ref);
+            store_be(msg + 27, order.shares);
+            store_be(msg + 31, price(order.buy));
+            flush(itch::kReplaceLength);
+        }
+    }
+}
+
+} // namespace lob
@@ -0,0 +1,732 @@
+#pragma once
+/// --------------------------------------------------------
+/// Columnar journal — compressed trade and order logs
+///
+/// Holds the rows of a CSV log (trades.csv,
+/// exec_reports.csv, ...) column by column, in a fraction
+/// of the space:
+///
+///   file     FileHeader (magic, version, column count),
+///            a ColumnHeader + name per column, then blocks
+///   block    BlockHeader (rows, raw and stored payload
+///            bytes, codec), then the payload: LZ-compressed
+///            (lz.hpp) when that saves a sixteenth or more,
+///            else as is
+///   payload  each column in turn, in 64-bit words: its
+///            kind in this block, then
+///              integer  mode, first value, a base per
+///                       256-row mini-block, their widths,
+///                       then the bit-packed rows
+///                       (bitpack.hpp)
+///              text     a block-local dictionary (count,
+///                       lengths, bytes), then each row's
+///                       entry number as an integer column
+///
+/// An integer column is stored either as values or as the
+/// delta from the previous row, whichever packs smaller
+/// in that block: ids and timestamps end up as deltas, as
+/// do prices that move in small steps. In a mini-block
+/// every value is taken relative to the smallest (frame of
+/// reference), so negative deltas need no zigzag and a
+/// constant run takes 0 bits.
+///
+/// A column declared integer falls back to text for any
+/// block where one of its fields is not an integer, so a
+/// blank or decimal cell costs that block its packing
+/// rather than failing the conversion.
+///
+/// Decoding a column is the bit-unpack kernel per mini-block
+/// (base added on the way out) and, for deltas, prefix_sum
+/// (depth_scan.hpp): both SIMD. Blocks hold up to 64k rows
+/// and decode independently. Everything is little-endian.
+/// --------------------------------------------------------
+
+#include "bitpack.hpp"
+#include "csv_writer.hpp"
+#include "depth_scan.hpp"
+#include "endian.hpp"
+#include "lz.hpp"
+#include "sbe.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lob {
+
+enum class JournalColumnKind : std::uint8_t { Int, Text };
+
+struct JournalColumn {
+    std::string name;
+    JournalColumnKind kind = JournalColumnKind::Int;
+};
+
+struct JournalStats {
+    std::uint64_t rows = 0;
+    std::uint64_t blocks = 0;
+    std::uint64_t raw_bytes = 0; // payloads before LZ
+    std::uint64_t file_bytes = 0;
+};
+
+namespace journal {
+
+inline constexpr std::string_view kMagic = "LOBJRNL1";
+inline constexpr std::uint16_t kVersion = 2; // 2: per-block column kinds
+inline constexpr std::size_t kBlockRows = 65'536;
+
+enum class Codec : std::uint8_t { None, Lz };
+enum class Mode : std::uint8_t { Values, Deltas };
+
+struct Magic : sbe::Chars<8> {};
+struct Version : sbe::Field<std::uint16_t> {};
+struct ColumnCount : sbe::Field<std::uint16_t> {};
+using FileHeader = sbe::Layout<Magic, Version, ColumnCount>;
+
+struct Kind : sbe::Field<JournalColumnKind> {};
+struct NameLength : sbe::Field<std::uint8_t> {};
+using ColumnHeader = sbe::Layout<Kind, NameLength>;
+
+struct Rows : sbe::Field<std::uint32_t> {};
+struct RawBytes : sbe::Field<std::uint32_t> {};
+struct StoredBytes : sbe::Field<std::uint32_t> {};
+struct BlockCodec : sbe::Field<Codec> {};
+using BlockHeader = sbe::Layout<Rows, RawBytes, StoredBytes, BlockCodec>;
+
+template <typename L>
+using Writer = sbe::BlockWriter<L, std::endian::little>;
+template <typename L>
+using Reader = sbe::BlockReader<L, std::endian::little>;
+
+constexpr std::size_t words_for(std::size_t bytes) noexcept {
+    return (bytes + 7) / 8;
+}
+
+constexpr std::size_t mini_blocks(std::size_t rows) noexcept {
+    return (rows + kPackBlock - 1) / kPackBlock;
+}
+
+/// Per mini-block base (minimum) and width of u[0, minis * 256).
+inline std::size_t frame(const std::uint64_t* u, std::size_t minis, std::uint64_t* bases, std::uint8_t* widths) {
+    std::size_t bits = 0;
+    for (std::size_t m = 0; m < minis; ++m) {
+        const auto* p = u + m * kPackBlock;
+        auto lo = static_cast<std::int64_t>(p[0]);
+        auto hi = lo;
+        for (std::size_t k = 1; k < kPackBlock; ++k) {
+            lo = std::min(lo, static_cast<std::int64_t>(p[k]));
+            hi = std::max(hi, static_cast<std::int64_t>(p[k]));
+        }
+        bases[m] = static_cast<std::uint64_t>(lo);
+        widths[m] = static_cast<std::uint8_t>(pack_width(static_cast<std::uint64_t>(hi) - bases[m]));
+        bits += widths[m];
+    }
+    return bits;
+}
+
+/// Append one integer column of `rows` values to the payload.
+inline void encode_ints(const std::int64_t* v, std::size_t rows, bool allow_deltas, std::vector<std::uint64_t>& out) {
+    const auto minis = mini_blocks(rows);
+    const auto padded = minis * kPackBlock;
+    // Rows past the end repeat the last mini-block's first value (or
+    // delta), which keeps its range.
+    std::vector<std::uint64_t> values(padded);
+    std::vector<std::uint64_t> deltas(padded);
+    for (std::size_t i = 0; i < rows; ++i) {
+        values[i] = static_cast<std::uint64_t>(v[i]);
+        deltas[i] = i == 0 ? 0 : values[i] - values[i - 1];
+    }
+    const auto pad_from = rows > 0 ? (rows - 1) / kPackBlock * kPackBlock : 0;
+    for (std::size_t i = rows; i < padded; ++i) {
+        values[i] = values[pad_from];
+        deltas[i] = deltas[pad_from];
+    }
+    std::vector<std::uint64_t> bases(minis);
+    std::vector<std::uint8_t> widths(minis);
+    std::vector<std::uint64_t> delta_bases(minis);
+    std::vector<std::uint8_t> delta_widths(minis);
+    const auto value_bits = frame(values.data(), minis, bases.data(), widths.data());
+    const auto delta_bits = allow_deltas ? frame(deltas.data(), minis, delta_bases.data(), delta_widths.data())
+                                         : value_bits;
+    const bool use_deltas = delta_bits < value_bits;
+    if (use_deltas) {
+        values.swap(deltas);
+        bases.swap(delta_bases);
+        widths.swap(delta_widths);
+    }
+
+    out.push_back(static_cast<std::uint64_t>(use_deltas ? Mode::Deltas : Mode::Values));
+    out.push_back(rows > 0 ? static_cast<std::uint64_t>(v[0]) : 0);
+    out.insert(out.end(), bases.begin(), bases.end());
+    const auto width_at = out.size();
+    out.resize(out.size() + words_for(minis));
+    std::memcpy(out.data() + width_at, widths.data(), minis);
+    for (std::size_t m = 0; m < minis; ++m) {
+        const auto at = out.size();
+        out.resize(at + 4 * std::size_t{widths[m]});
+        pack(values.data() + m * kPackBlock, bases[m], widths[m], out.data() + at);
+    }
+}
+
+/// Bounds-checked walk over a decoded payload.
+class Cursor {
+public:
+    Cursor(const std::uint64_t* p, std::size_t words) : p_(p), end_(p + words) {}
+
+    const std::uint64_t* take(std::size_t words) noexcept {
+        if (static_cast<std::size_t>(end_ - p_) < words) {
+            return nullptr;
+        }
+        const auto* at = p_;
+        p_ += words;
+        return at;
+    }
+
+private:
+    const std::uint64_t* p_;
+    const std::uint64_t* end_;
+};
+
+/// Decode one integer column into out[0, rows) (out is resized to whole
+/// mini-blocks).
+inline bool decode_ints(Cursor& in, std::size_t rows, std::vector<std::int64_t>& out) {
+    const auto minis = mini_blocks(rows);
+    const auto* head = in.take(2 + minis + words_for(minis));
+    if (head == nullptr || head[0] > static_cast<std::uint64_t>(Mode::Deltas)) {
+        return false;
+    }
+    const auto* bases = head + 2;
+    const auto* widths = reinterpret_cast<const std::uint8_t*>(bases + minis);
+    out.resize(minis * kPackBlock);
+    auto* dst = reinterpret_cast<std::uint64_t*>(out.data());
+    for (std::size_t m = 0; m < minis; ++m) {
+        const unsigned width = widths[m];
+        const auto* packed = width <= 64 ? in.take(4 * std::size_t{width}) : nullptr;
+        if (packed == nullptr) {
+            return false;
+        }
+        unpack(packed, bases[m], width, dst + m * kPackBlock);
+    }
+    if (static_cast<Mode>(head[0]) == Mode::Deltas && rows > 0) {
+        out[0] = static_cast<std::int64_t>(head[1]);
+        prefix_sum(out.data(), rows);
+    }
+    return true;
+}
+
+/// Little-endian words on any host.
+inline void to_little(std::uint64_t* words, std::size_t n) noexcept {
+    if constexpr (std::endian::native == std::endian::big) {
+        for (std::size_t i = 0; i < n; ++i) {
+            words[i] = byteswap(words[i]);
+        }
+    }
+}
+
+struct TransparentHash {
+    using is_transparent = void;
+    std::size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+};
+
+} // namespace journal
+
+/// Appends rows a field at a time, as CsvWriter does; each full block
+/// of rows is encoded and written. Text in an integer column turns it to
+/// text for the rest of the block (its integers kept as their decimal
+/// text); integers in a text column are stored the same way.
+class JournalWriter {
+public:
+    JournalWriter(std::ostream& out, std::vector<JournalColumn> columns, bool compress = true)
+        : out_(out), columns_(std::move(columns)), compress_(compress), ints_(columns_.size()),
+          dicts_(columns_.size()), entries_(columns_.size()) {
+        for (const auto& c : columns_) {
+            kinds_.push_back(c.kind);
+        }
+        using namespace journal;
+        std::byte header[FileHeader::block_length];
+        Writer<FileHeader>(header)
+            .set<Magic>(kMagic)
+            .set<Version>(kVersion)
+            .set<ColumnCount>(static_cast<std::uint16_t>(columns_.size()));
+        write(header, sizeof(header));
+        for (const auto& c : columns_) {
+            std::byte column[ColumnHeader::block_length];
+            const auto name = std::string_view(c.name).substr(0, 255);
+            Writer<ColumnHeader>(column).set<Kind>(c.kind).set<NameLength>(static_cast<std::uint8_t>(name.size()));
+            write(column, sizeof(column));
+            write(name.data(), name.size());
+        }
+        for (auto& v : ints_) {
+            v.reserve(kBlockRows);
+        }
+    }
+
+    ~JournalWriter() { close(); }
+
+    JournalWriter(const JournalWriter&) = delete;
+    JournalWriter& operator=(const JournalWriter&) = delete;
+
+    JournalWriter& field(std::int64_t value) {
+        if (kinds_[next_] == JournalColumnKind::Text) {
+            char buf[24];
+            const auto end = std::to_chars(buf, buf + sizeof(buf), value).ptr;
+            return field(std::string_view(buf, static_cast<std::size_t>(end - buf)));
+        }
+        ints_[next_++].push_back(value);
+        return *this;
+    }
+
+    JournalWriter& field(std::string_view text) {
+        if (kinds_[next_] == JournalColumnKind::Int) {
+            to_text(next_);
+        }
+        ints_[next_].push_back(entry(next_, text));
+        ++next_;
+        return *this;
+    }
+
+    void end_row() {
+        next_ = 0;
+        if (++rows_ == journal::kBlockRows) {
+            flush();
+        }
+    }
+
+    /// Drop the rows not yet written, and write nothing more: for a caller
+    /// that has failed part way (the output is incomplete; discard it).
+    void abandon() {
+        for (std::size_t c = 0; c < columns_.size(); ++c) {
+            ints_[c].clear();
+            dicts_[c].clear();
+            entries_[c].clear();
+            kinds_[c] = columns_[c].kind;
+        }
+        next_ = 0;
+        rows_ = 0;
+        closed_ = true;
+    }
+
+    /// Write the last, partial block. False if the stream failed.
+    bool close() {
+        if (!closed_) {
+            flush();
+            out_.flush();
+            closed_ = true;
+        }
+        return static_cast<bool>(out_);
+    }
+
+    const std::vector<JournalColumn>& columns() const noexcept { return columns_; }
+    const JournalStats& stats() const noexcept { return stats_; }
+
+private:
+    std::uint32_t entry(std::size_t c, std::string_view text) {
+        auto& dict = dicts_[c];
+        auto it = dict.find(text);
+        if (it == dict.end()) {
+            it = dict.emplace(std::string(text), static_cast<std::uint32_t>(entries_[c].size())).first;
+            entries_[c].push_back(it->first);
+        }
+        return it->second;
+    }
+
+    /// Turn column c to text for this block.
+    void to_text(std::size_t c) {
+        kinds_[c] = JournalColumnKind::Text;
+        for (auto& v : ints_[c]) {
+            char buf[24];
+            const auto end = std::to_chars(buf, buf + sizeof(buf), v).ptr;
+            v = entry(c, std::string_view(buf, static_cast<std::size_t>(end - buf)));
+        }
+    }
+
+    void write(const void* p, std::size_t n) {
+        out_.write(static_cast<const char*>(p), static_cast<std::streamsize>(n));
+        stats_.file_bytes += n;
+    }
+
+    void flush() {
+        using namespace journal;
+        if (rows_ == 0) {
+            return;
+        }
+        payload_.clear();
+        for (std::size_t c = 0; c < columns_.size(); ++c) {
+            const auto kind = kinds_[c];
+            payload_.push_back(static_cast<std::uint64_t>(kind));
+            if (kind == JournalColumnKind::Text) {
+                const auto& entries = entries_[c];
+                payload_.push_back(entries.size());
+                std::vector<std::uint32_t> lengths;
+                std::string bytes;
+                for (const auto& e : entries) {
+                    lengths.push_back(static_cast<std::uint32_t>(e.size()));
+                    bytes += e;
+                }
+                append(lengths.data(), lengths.size() * sizeof(std::uint32_t));
+                append(bytes.data(), bytes.size());
+                dicts_[c].clear();
+                entries_[c].clear();
+            }
+            encode_ints(ints_[c].data(), rows_, kind == JournalColumnKind::Int, payload_);
+            ints_[c].clear();
+            kinds_[c] = columns_[c].kind;
+        }
+        to_little(payload_.data(), payload_.size());
+
+        const auto raw = payload_.size() * sizeof(std::uint64_t);
+        const auto* stored = reinterpret_cast<const std::uint8_t*>(payload_.data());
+        auto stored_bytes = raw;
+        auto codec = Codec::None;
+        if (compress_) {
+            packed_.resize(lz_bound(raw));
+            // LZ costs decode time; keep it only where it pays.
+            const auto n = lz_compress(stored, raw, packed_.data());
+            if (n <= raw - raw / 16) {
+                stored = packed_.data();
+                stored_bytes = n;
+                codec = Codec::Lz;
+            }
+        }
+        std::byte header[BlockHeader::block_length];
+        Writer<BlockHeader>(header)
+            .set<Rows>(static_cast<std::uint32_t>(rows_))
+            .set<RawBytes>(static_cast<std::uint32_t>(raw))
+            .set<StoredBytes>(static_cast<std::uint32_t>(stored_bytes))
+            .set<BlockCodec>(codec);
+        write(header, sizeof(header));
+        write(stored, stored_bytes);
+        stats_.rows += rows_;
+        ++stats_.blocks;
+        stats_.raw_bytes += raw;
+        rows_ = 0;
+    }
+
+    /// Bytes, zero-padded to whole words.
+    void append(const void* p, std::size_t n) {
+        const auto at = payload_.size();
+        payload_.resize(at + journal::words_for(n));
+        if (n > 0) {
+            std::memcpy(payload_.data() + at, p, n);
+        }
+    }
+
+    std::ostream& out_;
+    std::vector<JournalColumn> columns_;
+    bool compress_;
+    std::vector<JournalColumnKind> kinds_; // per column, in the current block
+    std::vector<std::vector<std::int64_t>> ints_; // per column; text: entry numbers
+    std::vector<std::unordered_map<std::string, std::uint32_t, journal::TransparentHash, std::equal_to<>>> dicts_;
+    std::vector<std::vector<std::string_view>> entries_; // keys of dicts_ in entry order
+    std::vector<std::uint64_t> payload_;
+    std::vector<std::uint8_t> packed_;
+    std::size_t next_ = 0;
+    std::size_t rows_ = 0;
+    bool closed_ = false;
+    JournalStats stats_;
+};
+
+/// One decoded block. values[c] holds column c's rows (entry numbers
+/// into text[c] where kinds[c] is Text), padded to whole mini-blocks;
+/// the text views point into `payload`.
+struct JournalBlock {
+    std::size_t rows = 0;
+    std::vector<JournalColumnKind> kinds;
+    std::vector<std::vector<std::int64_t>> values;
+    std::vector<std::vector<std::string_view>> text;
+    std::vector<std::uint64_t> payload;
+};
+
+class JournalReader {
+public:
+    /// Read the file header of data[0, size), which must outlive the reader.
+    bool open(const std::uint8_t* data, std::size_t size, std::string& error) {
+        using namespace journal;
+        data_ = data;
+        size_ = size;
+        pos_ = 0;
+        columns_.clear();
+        if (size < FileHeader::block_length) {
+            error = "not a journal (too short)";
+            return false;
+        }
+        const Reader<FileHeader> header(reinterpret_cast<const std::byte*>(data));
+        if (header.get<Magic>() != kMagic || header.get<Version>() != kVersion) {
+            error = "not a journal (bad magic or version)";
+            return false;
+        }
+        pos_ = FileHeader::block_length;
+        for (std::size_t c = 0; c < header.get<ColumnCount>(); ++c) {
+            if (size_ - pos_ < ColumnHeader::block_length) {
+                error = "truncated column list";
+                return false;
+            }
+            const Reader<ColumnHeader> column(reinterpret_cast<const std::byte*>(data_ + pos_));
+            pos_ += ColumnHeader::block_length;
+            const auto kind = column.get<Kind>();
+            const std::size_t length = column.get<NameLength>();
+            if (kind > JournalColumnKind::Text || size_ - pos_ < length) {
+                error = "bad column header";
+                return false;
+            }
+            columns_.push_back({std::string(reinterpret_cast<const char*>(data_ + pos_), length), kind});
+            pos_ += length;
+        }
+        return true;
+    }
+
+    const std::vector<JournalColumn>& columns() const noexcept { return columns_; }
+
+    /// Decode the next block. False at the end (error left empty) or on
+    /// a corrupt block.
+    bool next(JournalBlock& block, std::string& error) {
+        using namespace journal;
+        if (pos_ == size_) {
+            return false;
+        }
+        if (size_ - pos_ < BlockHeader::block_length) {
+            error = "truncated block header";
+            return false;
+        }
+        const Reader<BlockHeader> header(reinterpret_cast<const std::byte*>(data_ + pos_));
+        pos_ += BlockHeader::block_length;
+        const std::size_t rows = header.get<Rows>();
+        const std::size_t raw = header.get<RawBytes>();
+        const std::size_t stored = header.get<StoredBytes>();
+        const auto codec = header.get<BlockCodec>();
+        if (rows > kBlockRows || raw % sizeof(std::uint64_t) != 0 || size_ - pos_ < stored ||
+            (codec == Codec::None && stored != raw) || codec > Codec::Lz) {
+            error = "bad block header";
+            return false;
+        }
+        block.payload.resize(raw / sizeof(std::uint64_t));
+        auto* bytes = reinterpret_cast<std::uint8_t*>(block.payload.data());
+        if (codec == Codec::Lz) {
+            if (!lz_decompress(data_ + pos_, stored, bytes, raw)) {
+                error = "corrupt compressed block";
+                return false;
+            }
+        } else if (raw > 0) {
+            std::memcpy(bytes, data_ + pos_, raw);
+        }
+        pos_ += stored;
+        to_little(block.payload.data(), block.payload.size());
+
+        block.rows = rows;
+        block.values.resize(columns_.size());
+        block.text.resize(columns_.size());
+        block.kinds.resize(columns_.size());
+        Cursor in(block.payload.data(), block.payload.size());
+        for (std::size_t c = 0; c < columns_.size(); ++c) {
+            const auto* kind = in.take(1);
+            if (kind == nullptr || *kind > static_cast<std::uint64_t>(JournalColumnKind::Text)) {
+                error = "corrupt column " + columns_[c].name;
+                return false;
+            }
+            block.kinds[c] = static_cast<JournalColumnKind>(*kind);
+            auto& text = block.text[c];
+            text.clear();
+            if (block.kinds[c] == JournalColumnKind::Text && !decode_text(in, text)) {
+                error = "corrupt text column " + columns_[c].name;
+                return false;
+            }
+            auto& values = block.values[c];
+            if (!decode_ints(in, rows, values)) {
+                error = "corrupt column " + columns_[c].name;
+                return false;
+            }
+            if (block.kinds[c] == JournalColumnKind::Text) {
+                const auto count = static_cast<std::uint64_t>(text.size());
+                bool ok = true;
+                for (std::size_t i = 0; i < rows; ++i) {
+                    ok &= static_cast<std::uint64_t>(values[i]) < count;
+                }
+                if (!ok) {
+                    error = "bad text entry in column " + columns_[c].name;
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    static bool decode_text(journal::Cursor& in, std::vector<std::string_view>& out) {
+        using journal::words_for;
+        const auto* count = in.take(1);
+        if (count == nullptr || *count > journal::kBlockRows) {
+            return false;
+        }
+        const auto n = static_cast<std::size_t>(*count);
+        const auto* lengths_at = in.take(words_for(n * sizeof(std::uint32_t)));
+        if (lengths_at == nullptr) {
+            return false;
+        }
+        std::vector<std::uint32_t> lengths(n);
+        if (n > 0) {
+            std::memcpy(lengths.data(), lengths_at, n * sizeof(std::uint32_t));
+        }
+        std::size_t total = 0;
+        for (const auto len : lengths) {
+            total += len;
+        }
+        const auto* bytes = reinterpret_cast<const char*>(in.take(words_for(total)));
+        if (bytes == nullptr) {
+            return false;
+        }
+        for (const auto len : lengths) {
+            out.emplace_back(bytes, len);
+            bytes += len;
+        }
+        return true;
+    }
+
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t pos_ = 0;
+    std::vector<JournalColumn> columns_;
+};
+
+namespace journal {
+
+/// Next CSV line of [p, end) split on commas into `fields` (views into
+/// the input); false at the end.
+inline bool split_line(const char*& p, const char* end, std::vector<std::string_view>& fields) {
+    if (p == end) {
+        return false;
+    }
+    const auto* eol = static_cast<const char*>(std::memchr(p, '\n', static_cast<std::size_t>(end - p)));
+    const auto* line_end = eol != nullptr ? eol : end;
+    fields.clear();
+    for (const char* f = p;;) {
+        const auto* comma = static_cast<const char*>(std::memchr(f, ',', static_cast<std::size_t>(line_end - f)));
+        if (comma == nullptr) {
+            fields.emplace_back(f, static_cast<std::size_t>(line_end - f));
+            break;
+        }
+        fields.emplace_back(f, static_cast<std::size_t>(comma - f));
+        f = comma + 1;
+    }
+    p = eol != nullptr ? eol + 1 : end;
+    return true;
+}
+
+/// An integer that formats back to the same text (no sign, leading
+/// zeros or spaces to lose).
+inline bool parse_canonical(std::string_view text, std::int64_t& out) noexcept {
+    const auto* end = text.data() + text.size();
+    const auto [ptr, ec] = std::from_chars(text.data(), end, out);
+    if (ec != std::errc{} || ptr != end) {
+        return false;
+    }
+    const auto digits = text.substr(text[0] == '-' ? 1 : 0);
+    if (digits.size() > 1 && digits[0] == '0') {
+        return false;
+    }
+    return !(text[0] == '-' && out == 0);
+}
+
+} // namespace journal
+
+/// CSV (header row, comma-separated, no quoting) to a journal. A column
+/// is declared integer if its first value is a canonical integer (one
+/// that prints back the same), else text; a block where it holds
+/// anything else stores it as text, so the CSV converts back byte for
+/// byte. The one exception: a last line without a newline gets one.
+/// On error the writer is abandoned and the output is incomplete.
+inline bool csv_to_journal(const char* data, std::size_t size, std::ostream& out, JournalStats& stats,
+                           std::string& error, bool compress = true) {
+    const char* p = data;
+    const char* end = data + size;
+    std::vector<std::string_view> fields;
+    if (!journal::split_line(p, end, fields)) {
+        error = "empty CSV";
+        return false;
+    }
+    std::vector<JournalColumn> columns;
+    for (const auto f : fields) {
+        columns.push_back({std::string(f), JournalColumnKind::Int});
+    }
+    const auto header_end = p;
+    if (journal::split_line(p, end, fields) && fields.size() == columns.size()) {
+        std::int64_t v = 0;
+        for (std::size_t c = 0; c < columns.size(); ++c) {
+            if (!journal::parse_canonical(fields[c], v)) {
+                columns[c].kind = JournalColumnKind::Text;
+            }
+        }
+    }
+    p = header_end;
+
+    JournalWriter writer(out, std::move(columns), compress);
+    const auto& cols = writer.columns();
+    std::size_t line = 1;
+    while (journal::split_line(p, end, fields)) {
+        ++line;
+        if (fields.size() != cols.size()) {
+            error = "line " + std::to_string(line) + ": expected " + std::to_string(cols.size()) + " fields";
+            writer.abandon();
+            return false;
+        }
+        for (std::size_t c = 0; c < cols.size(); ++c) {
+            std::int64_t v = 0;
+            if (cols[c].kind == JournalColumnKind::Int && journal::parse_canonical(fields[c], v)) {
+                writer.field(v);
+            } else {
+                writer.field(fields[c]);
+            }
+        }
+        writer.end_row();
+    }
+    if (!writer.close()) {
+        error = "write failed";
+        return false;
+    }
+    stats = writer.stats();
+    return true;
+}
+
+/// The journal in data[0, size) back to CSV.
+inline bool journal_to_csv(const std::uint8_t* data, std::size_t size, std::ostream& out, JournalStats& stats,
+                           std::string& error) {
+    JournalReader reader;
+    if (!reader.open(data, size, error)) {
+        return false;
+    }
+    const auto& cols = reader.columns();
+    CsvWriter csv(out);
+    for (const auto& c : cols) {
+        csv.field(std::string_view(c.name));
+    }
+    csv.end_row();
+    JournalBlock block;
+    stats = {};
+    while (reader.next(block, error)) {
+        for (std::size_t i = 0; i < block.rows; ++i) {
+            for (std::size_t c = 0; c < cols.size(); ++c) {
+                const auto v = block.values[c][i];
+                if (block.kinds[c] == JournalColumnKind::Text) {
+                    csv.field(block.text[c][static_cast<std::size_t>(v)]);
+                } else {
+                    csv.field(v);
+                }
+            }
+            csv.end_row();
+        }
+        stats.rows += block.rows;
+        ++stats.blocks;
+        stats.raw_bytes += block.payload.size() * sizeof(std::uint64_t);
+    }
+    stats.file_bytes = size;
+    return error.empty();
+}
+
+} // namespace lob
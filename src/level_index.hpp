@@ -0,0 +1,599 @@
+#pragma once
+/// --------------------------------------------------------
+/// Price-level index policies (one index per book side)
+///
+/// A level policy exposes index<Level, Side>, which keeps the
+/// side's levels ordered best-first and provides:
+///   empty / size / best_price / best / pop_best
+///   at(price)    — get or create the level at price
+///   find(price)  — existing level or nullptr
+///   erase(price) — drop a level that has become empty
+///   for_each(fn) — visit (price, level) best-first until
+///                  fn returns false
+///   sync(price, level) — level.total_qty changed
+///   prefetch(price) — hint the best level, and the level at
+///                     price where it is found without a search
+///   liquidity(limit, size) — see depth_scan.hpp
+///   bin_depth(bin, bins) — quantity per price bin, best bin
+///                          first (see depth_profile.hpp)
+///
+/// • MapLevels    — std::map, the original layout
+/// • FlatLevels   — sorted parallel vectors, best at the back
+/// • LadderLevels — dense array indexed by tick offset, with a
+///                  contiguous quantity mirror for SIMD scans;
+///                  spans at most kMaxLevels ticks, and prices
+///                  beyond that go to a MapLevelIndex overflow
+///
+/// Emptied levels are recycled rather than destroyed, so a
+/// price that flickers at the touch reuses its queue storage:
+/// the map parks extracted nodes on a free list, the flat index
+/// keeps husks past its live range (moved with swap()), and the
+/// ladder never destroys a level. Level types must provide an
+/// allocation-free swap().
+/// --------------------------------------------------------
+
+#include "depth_scan.hpp"
+#include "prefetch.hpp"
+#include "types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+/// True when price a has priority over price b on side S.
+template <Side S>
+constexpr bool is_better(std::int64_t a, std::int64_t b) noexcept {
+    if constexpr (S == Side::Buy) {
+        return a > b;
+    } else {
+        return a < b;
+    }
+}
+
+/// Floor division, so negative prices land in the right bin.
+constexpr std::int64_t floor_div(std::int64_t a, std::int64_t b) noexcept {
+    const auto q = a / b;
+    return (a % b != 0 && (a < 0) != (b < 0)) ? q - 1 : q;
+}
+
+/// Upper bound on emptied levels kept for reuse per side.
+inline constexpr std::size_t kMaxSpareLevels = 64;
+
+template <Side S>
+using PriceCompare = std::conditional_t<S == Side::Buy, std::greater<>, std::less<>>;
+
+/// Reference liquidity walk over any index exposing for_each.
+template <Side S, typename Index>
+Liquidity walk_liquidity(const Index& index, std::int64_t limit, std::int64_t size) {
+    Liquidity out;
+    index.for_each([&](std::int64_t price, const auto& level) {
+        if (is_better<S>(limit, price)) {
+            return false;
+        }
+        out.available += level.total_qty;
+        if (out.filled < size) {
+            const auto take = std::min(level.total_qty, size - out.filled);
+            out.filled += take;
+            out.notional += price * take;
+            ++out.levels;
+        }
+        return true;
+    });
+    return out;
+}
+
+/// Reference binning over any index exposing for_each.
+template <Side S, typename Index>
+void walk_bins(const Index& index, std::int64_t bin, std::vector<std::int64_t>& bins) {
+    bins.clear();
+    if (index.empty()) {
+        return;
+    }
+    const auto first = floor_div(index.best_price(), bin);
+    index.for_each([&](std::int64_t price, const auto& level) {
+        const auto dist = S == Side::Buy ? first - floor_div(price, bin) : floor_div(price, bin) - first;
+        const auto k = static_cast<std::size_t>(dist);
+        if (k >= bins.size()) {
+            bins.resize(k + 1, 0);
+        }
+        bins[k] += level.total_qty;
+        return true;
+    });
+}
+
+template <typename Level, Side S>
+class MapLevelIndex {
+public:
+    bool         empty()      const noexcept { return levels_.empty(); }
+    std::size_t  size()       const noexcept { return levels_.size(); }
+    std::int64_t best_price() const noexcept { return levels_.begin()->first; }
+    Level&       best()             noexcept { return levels_.begin()->second; }
+
+    void pop_best() {
+        retire(levels_.begin());
+    }
+
+    Level& at(std::int64_t price) {
+        auto it = levels_.lower_bound(price);
+        if (it != levels_.end() && it->first == price) {
+            return it->second;
+        }
+        if (spare_.empty()) {
+            return levels_.try_emplace(it, price)->second;
+        }
+        auto node = std::move(spare_.back());
+        spare_.pop_back();
+        node.key() = price;
+        return levels_.insert(it, std::move(node))->second;
+    }
+
+    const Level* find(std::int64_t price) const {
+        auto it = levels_.find(price);
+        return it == levels_.end() ? nullptr : &it->second;
+    }
+
+    Level* find(std::int64_t price) {
+        return const_cast<Level*>(std::as_const(*this).find(price));
+    }
+
+    void erase(std::int64_t price) {
+        auto it = levels_.find(price);
+        if (it != levels_.end()) {
+            retire(it);
+        }
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& [price, level] : levels_) {
+            if (!fn(price, level)) {
+                return;
+            }
+        }
+    }
+
+    void sync(std::int64_t, const Level&) noexcept {}
+
+    void prefetch(std::int64_t) const noexcept {
+        if (!levels_.empty()) {
+            lob::prefetch(&*levels_.begin());
+        }
+    }
+
+    Liquidity liquidity(std::int64_t limit, std::int64_t size) const {
+        return walk_liquidity<S>(*this, limit, size);
+    }
+
+    void bin_depth(std::int64_t bin, std::vector<std::int64_t>& bins) const {
+        walk_bins<S>(*this, bin, bins);
+    }
+
+private:
+    using map_type = std::map<std::int64_t, Level, PriceCompare<S>>;
+
+    void retire(typename map_type::iterator it) {
+        if (spare_.size() < kMaxSpareLevels) {
+            spare_.push_back(levels_.extract(it));
+        } else {
+            levels_.erase(it);
+        }
+    }
+
+    map_type levels_;
+    std::vector<typename map_type::node_type> spare_;
+};
+
+template <typename Level, Side S>
+class FlatLevelIndex {
+public:
+    bool         empty()      const noexcept { return prices_.empty(); }
+    std::size_t  size()       const noexcept { return prices_.size(); }
+    std::int64_t best_price() const noexcept { return prices_.back(); }
+
+    Level&       best()             noexcept { return levels_[prices_.size() - 1]; }
+
+    void pop_best() {
+        prices_.pop_back();
+        trim_spares();
+    }
+
+    Level& at(std::int64_t price) {
+        const auto live = prices_.size();
+        if (levels_.size() == live) {
+            levels_.emplace_back();
+        }
+        // Most activity is at the top of book, so check the back first.
+        if (live == 0 || is_better<S>(price, prices_.back())) {
+            prices_.push_back(price);
+            return levels_[live];
+        }
+        const auto idx = position(price);
+        if (idx < live && prices_[idx] == price) {
+            return levels_[idx];
+        }
+        // Rotate the first spare into place; swaps keep queue storage.
+        const auto offset = static_cast<std::ptrdiff_t>(idx);
+        prices_.insert(prices_.begin() + offset, price);
+        std::rotate(levels_.begin() + offset, levels_.begin() + static_cast<std::ptrdiff_t>(live),
+                    levels_.begin() + static_cast<std::ptrdiff_t>(live) + 1);
+        return levels_[idx];
+    }
+
+    const Level* find(std::int64_t price) const {
+        const auto idx = position(price);
+        return idx < prices_.size() && prices_[idx] == price ? &levels_[idx] : nullptr;
+    }
+
+    Level* find(std::int64_t price) {
+        return const_cast<Level*>(std::as_const(*this).find(price));
+    }
+
+    void erase(std::int64_t price) {
+        const auto idx = position(price);
+        if (idx == prices_.size() || prices_[idx] != price) {
+            return;
+        }
+        const auto offset = static_cast<std::ptrdiff_t>(idx);
+        std::rotate(levels_.begin() + offset, levels_.begin() + offset + 1,
+                    levels_.begin() + static_cast<std::ptrdiff_t>(prices_.size()));
+        prices_.erase(prices_.begin() + offset);
+        trim_spares();
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (std::size_t i = prices_.size(); i > 0; --i) {
+            if (!fn(prices_[i - 1], levels_[i - 1])) {
+                return;
+            }
+        }
+    }
+
+    void sync(std::int64_t, const Level&) noexcept {}
+
+    void prefetch(std::int64_t) const noexcept {
+        if (!prices_.empty()) {
+            lob::prefetch(&prices_.back());
+            lob::prefetch(&levels_[prices_.size() - 1]);
+        }
+    }
+
+    Liquidity liquidity(std::int64_t limit, std::int64_t size) const {
+        return walk_liquidity<S>(*this, limit, size);
+    }
+
+    void bin_depth(std::int64_t bin, std::vector<std::int64_t>& bins) const {
+        walk_bins<S>(*this, bin, bins);
+    }
+
+private:
+    // Prices are stored worst-first so the best level sits at the back.
+    std::size_t position(std::int64_t price) const {
+        const auto pos = std::lower_bound(prices_.begin(), prices_.end(), price,
+            [](std::int64_t a, std::int64_t b) { return is_better<S>(b, a); });
+        return static_cast<std::size_t>(pos - prices_.begin());
+    }
+
+    void trim_spares() {
+        if (levels_.size() > prices_.size() + kMaxSpareLevels) {
+            levels_.pop_back();
+        }
+    }
+
+    std::vector<std::int64_t> prices_;
+    std::vector<Level> levels_;   // [0, prices_.size()) live, then spares
+};
+
+template <typename Level, Side S>
+class LadderLevelIndex {
+public:
+    /// Widest price range the ladder allocates, in ticks. Prices it cannot
+    /// reach without growing past this go to a sparse overflow index.
+    static constexpr std::size_t kMaxLevels = std::size_t{1} << 18;
+
+    bool         empty()      const noexcept { return live_ == 0 && overflow_.empty(); }
+    std::size_t  size()       const noexcept { return live_ + overflow_.size(); }
+
+    std::int64_t best_price() const noexcept {
+        return overflow_best() ? overflow_.best_price() : ladder_best_price();
+    }
+
+    Level& best() noexcept {
+        return overflow_best() ? overflow_.best() : levels_[best_];
+    }
+
+    void pop_best() {
+        if (overflow_best()) {
+            overflow_.pop_best();
+        } else {
+            release(best_);
+        }
+    }
+
+    Level& at(std::int64_t price) {
+        if (!covers(price) && !grow(price)) {
+            return overflow_.at(price);
+        }
+        return occupy(price);
+    }
+
+    const Level* find(std::int64_t price) const {
+        if (!covers(price)) {
+            return overflow_.empty() ? nullptr : overflow_.find(price);
+        }
+        const auto idx = static_cast<std::size_t>(price - base_);
+        return occupied_[idx] ? &levels_[idx] : nullptr;
+    }
+
+    Level* find(std::int64_t price) {
+        return const_cast<Level*>(std::as_const(*this).find(price));
+    }
+
+    void erase(std::int64_t price) {
+        if (!covers(price)) {
+            overflow_.erase(price);
+        } else if (occupied_[static_cast<std::size_t>(price - base_)]) {
+            release(static_cast<std::size_t>(price - base_));
+        }
+    }
+
+    /// Overflow levels lie wholly outside the window: those beyond its
+    /// best edge come first, then the ladder, then the rest.
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        bool more = true;
+        overflow_.for_each([&](std::int64_t price, const Level& level) {
+            if (!beyond(price)) {
+                return false;
+            }
+            more = fn(price, level);
+            return more;
+        });
+        std::size_t seen = 0;
+        for (auto idx = best_; more && seen < live_; idx = worse(idx)) {
+            if (!occupied_[idx]) {
+                continue;
+            }
+            ++seen;
+            more = fn(base_ + static_cast<std::int64_t>(idx), levels_[idx]);
+        }
+        if (!more) {
+            return;
+        }
+        overflow_.for_each([&](std::int64_t price, const Level& level) {
+            return beyond(price) || fn(price, level);
+        });
+    }
+
+    void sync(std::int64_t price, const Level& level) noexcept {
+        if (covers(price)) {
+            qty_[static_cast<std::size_t>(price - base_)] = level.total_qty;
+        }
+    }
+
+    void prefetch(std::int64_t price) const noexcept {
+        if (live_ > 0) {
+            lob::prefetch(&levels_[best_]);
+        }
+        if (covers(price)) {
+            const auto idx = static_cast<std::size_t>(price - base_);
+            lob::prefetch(&levels_[idx]);
+            lob::prefetch(&occupied_[idx]);
+        }
+    }
+
+    /// Scans the contiguous quantity mirror with the SIMD depth kernel
+    /// (a plain walk while any level is in overflow).
+    Liquidity liquidity(std::int64_t limit, std::int64_t size) const {
+        if (!overflow_.empty()) {
+            return walk_liquidity<S>(*this, limit, size);
+        }
+        Liquidity out;
+        if (live_ == 0 || is_better<S>(limit, best_price())) {
+            return out;
+        }
+        const auto last = static_cast<std::int64_t>(levels_.size()) - 1;
+        const auto edge = static_cast<std::size_t>(std::clamp<std::int64_t>(limit - base_, 0, last));
+
+        DepthScan scan;
+        if constexpr (S == Side::Buy) {
+            scan = scan_depth<true>(qty_.data() + edge, best_ - edge + 1, size);
+        } else {
+            scan = scan_depth<false>(qty_.data() + best_, edge - best_ + 1, size);
+        }
+        out.available = scan.total;
+        out.filled = scan.filled;
+        out.notional = best_price() * scan.filled + (S == Side::Buy ? -scan.weighted : scan.weighted);
+        out.levels = scan.levels;
+        return out;
+    }
+
+    /// Bins are contiguous runs of the quantity mirror, summed with SIMD
+    /// (a plain walk while any level is in overflow).
+    void bin_depth(std::int64_t bin, std::vector<std::int64_t>& bins) const {
+        if (!overflow_.empty()) {
+            walk_bins<S>(*this, bin, bins);
+            return;
+        }
+        bins.clear();
+        if (live_ == 0) {
+            return;
+        }
+        const auto begin = qty_.begin() + static_cast<std::ptrdiff_t>(best_);
+        if constexpr (S == Side::Buy) {
+            if (bin == 1) {
+                bins.assign(std::make_reverse_iterator(begin + 1), qty_.rend());
+            } else {
+                auto hi = static_cast<std::int64_t>(best_) + 1;
+                for (auto k = floor_div(best_price(), bin); hi > 0; --k) {
+                    const auto lo = std::max<std::int64_t>(k * bin - base_, 0);
+                    bins.push_back(sum_depth(qty_.data() + lo, static_cast<std::size_t>(hi - lo)));
+                    hi = lo;
+                }
+            }
+        } else {
+            if (bin == 1) {
+                bins.assign(begin, qty_.end());
+            } else {
+                const auto end = static_cast<std::int64_t>(qty_.size());
+                auto lo = static_cast<std::int64_t>(best_);
+                for (auto k = floor_div(best_price(), bin); lo < end; ++k) {
+                    const auto hi = std::min<std::int64_t>((k + 1) * bin - base_, end);
+                    bins.push_back(sum_depth(qty_.data() + lo, static_cast<std::size_t>(hi - lo)));
+                    lo = hi;
+                }
+            }
+        }
+        while (!bins.empty() && bins.back() == 0) {
+            bins.pop_back();
+        }
+    }
+
+private:
+    static constexpr std::size_t kInitialLevels = 1024;
+
+    static constexpr std::size_t worse(std::size_t idx) noexcept {
+        return S == Side::Buy ? idx - 1 : idx + 1;
+    }
+
+    std::int64_t ladder_best_price() const noexcept { return base_ + static_cast<std::int64_t>(best_); }
+
+    /// True when the overflow index holds the side's best price.
+    bool overflow_best() const noexcept {
+        return !overflow_.empty() && (live_ == 0 || is_better<S>(overflow_.best_price(), ladder_best_price()));
+    }
+
+    bool covers(std::int64_t price) const noexcept {
+        return price >= base_ && price < base_ + static_cast<std::int64_t>(levels_.size());
+    }
+
+    /// True for a price outside the window on its better side.
+    bool beyond(std::int64_t price) const noexcept {
+        return S == Side::Buy ? price >= base_ + static_cast<std::int64_t>(levels_.size()) : price < base_;
+    }
+
+    Level& occupy(std::int64_t price) {
+        const auto idx = static_cast<std::size_t>(price - base_);
+        if (!occupied_[idx]) {
+            occupied_[idx] = 1;
+            if (live_ == 0 || is_better<S>(price, ladder_best_price())) {
+                best_ = idx;
+            }
+            ++live_;
+        }
+        return levels_[idx];
+    }
+
+    void release(std::size_t idx) {
+        occupied_[idx] = 0;
+        qty_[idx] = 0;
+        --live_;
+        if (idx != best_ || live_ == 0) {
+            return;
+        }
+        do {
+            best_ = worse(best_);
+        } while (!occupied_[best_]);
+    }
+
+    /// Re-allocate so the ladder spans price with headroom on both sides,
+    /// or re-centre an empty one on it. False, leaving the ladder as is,
+    /// when that would span more than kMaxLevels.
+    bool grow(std::int64_t price) {
+        const auto old_size = static_cast<std::int64_t>(levels_.size());
+        if (live_ == 0 && old_size > 0) {
+            base_ = price - old_size / 2;
+            absorb_overflow();
+            return true;
+        }
+        if (old_size > 0) {
+            // Span needed to cover both the old range and price.
+            const auto need = static_cast<std::uint64_t>(std::max(price + 1, base_ + old_size)) -
+                              static_cast<std::uint64_t>(std::min(price, base_));
+            if (need > kMaxLevels) {
+                return false;
+            }
+        }
+        const auto slack = std::max<std::int64_t>(old_size, kInitialLevels) / 2;
+        auto lo = price - slack;
+        auto hi = price + slack;
+        if (old_size > 0) {
+            // Keep the old range and price, trimming headroom to the cap.
+            const auto max_span = static_cast<std::int64_t>(kMaxLevels);
+            lo = std::max(std::min(lo, base_), std::max(price + 1, base_ + old_size) - max_span);
+            hi = std::min(std::max(hi, base_ + old_size), lo + max_span);
+        }
+
+        std::vector<Level> levels(static_cast<std::size_t>(hi - lo));
+        std::vector<std::uint8_t> occupied(levels.size(), 0);
+        std::vector<std::int64_t> qty(levels.size(), 0);
+        const auto shift = static_cast<std::size_t>(base_ - lo);
+        for (std::size_t i = 0; i < levels_.size(); ++i) {
+            if (occupied_[i]) {
+                levels[i + shift] = std::move(levels_[i]);
+                occupied[i + shift] = 1;
+                qty[i + shift] = qty_[i];
+            }
+        }
+        if (old_size > 0) {
+            best_ += shift;
+        }
+        levels_ = std::move(levels);
+        occupied_ = std::move(occupied);
+        qty_ = std::move(qty);
+        base_ = lo;
+        absorb_overflow();
+        return true;
+    }
+
+    /// Move overflow levels the window now covers into the ladder.
+    void absorb_overflow() {
+        if (overflow_.empty()) {
+            return;
+        }
+        std::vector<std::int64_t> prices;
+        overflow_.for_each([&](std::int64_t price, const Level&) {
+            if (covers(price)) {
+                prices.push_back(price);
+            }
+            return true;
+        });
+        for (const auto price : prices) {
+            auto& level = occupy(price);
+            using std::swap;
+            swap(level, *overflow_.find(price));
+            qty_[static_cast<std::size_t>(price - base_)] = level.total_qty;
+            overflow_.erase(price);
+        }
+    }
+
+    std::vector<Level> levels_;            // levels_[i] holds price base_ + i
+    std::vector<std::uint8_t> occupied_;
+    std::vector<std::int64_t> qty_;        // mirror of levels_[i].total_qty, 0 when empty
+    std::int64_t base_ = 0;
+    std::size_t best_ = 0;
+    std::size_t live_ = 0;                 // occupied ladder levels
+    MapLevelIndex<Level, S> overflow_;     // prices the window cannot reach
+};
+
+struct MapLevels {
+    template <typename Level, Side S> using index = MapLevelIndex<Level, S>;
+};
+
+struct FlatLevels {
+    template <typename Level, Side S> using index = FlatLevelIndex<Level, S>;
+};
+
+struct LadderLevels {
+    template <typename Level, Side S> using index = LadderLevelIndex<Level, S>;
+};
+
+} // namespace lob
@@ -0,0 +1,213 @@
+#pragma once
+/// --------------------------------------------------------
+/// LZ block compression in the LZ4 block format
+///
+/// A block is a run of sequences, each:
+///   token     literal length (high nibble), match length
+///             - 4 (low nibble); 15 means more length bytes
+///             follow, 255 at a time
+///   literals
+///   offset    2 bytes, little-endian, back into the output
+///   [match length bytes]
+/// The last sequence is literals only. As in LZ4, the last
+/// 5 bytes are always literals and no match starts within
+/// the last 12, so a block decodes with stock LZ4 too.
+///
+/// The compressor is greedy: one hash table of 4-byte
+/// prefixes (16k entries), no chains, and it skips ahead
+/// faster the longer it goes without a match. The
+/// decompressor checks every length and offset against
+/// both buffers, so corrupt input fails instead of
+/// overrunning; long matches are copied 8 bytes at a time.
+/// --------------------------------------------------------
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace lob {
+
+/// Largest lz_compress() output for n input bytes.
+constexpr std::size_t lz_bound(std::size_t n) noexcept {
+    return n + n / 255 + 16;
+}
+
+namespace detail {
+
+inline constexpr std::size_t kLzMinMatch = 4;
+inline constexpr std::size_t kLzLastLiterals = 5;
+inline constexpr std::size_t kLzMatchLimit = 12;
+inline constexpr std::size_t kLzMaxOffset = 65'535;
+inline constexpr unsigned kLzHashBits = 14;
+
+inline std::uint32_t read32(const std::uint8_t* p) noexcept {
+    std::uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+inline std::uint64_t read64(const std::uint8_t* p) noexcept {
+    std::uint64_t v;
+    std::memcpy(&v, p, 8);
+    return v;
+}
+
+inline std::uint32_t lz_hash(std::uint32_t v) noexcept {
+    return (v * 2'654'435'761u) >> (32 - kLzHashBits);
+}
+
+/// Length bytes past a nibble of 15.
+inline std::uint8_t* put_length(std::uint8_t* op, std::size_t len) noexcept {
+    for (; len >= 255; len -= 255) {
+        *op++ = 255;
+    }
+    *op++ = static_cast<std::uint8_t>(len);
+    return op;
+}
+
+/// Common prefix length of a and b, up to `limit` bytes of b.
+inline std::size_t match_length(const std::uint8_t* a, const std::uint8_t* b, const std::uint8_t* limit) noexcept {
+    const auto* start = b;
+    while (b + 8 <= limit) {
+        const auto diff = read64(a) ^ read64(b);
+        if (diff != 0) {
+            return static_cast<std::size_t>(b - start) + (std::countr_zero(diff) >> 3);
+        }
+        a += 8;
+        b += 8;
+    }
+    while (b < limit && *a == *b) {
+        ++a;
+        ++b;
+    }
+    return static_cast<std::size_t>(b - start);
+}
+
+} // namespace detail
+
+/// Compress src[0, n) into dst (at least lz_bound(n) bytes); returns the
+/// compressed size.
+inline std::size_t lz_compress(const std::uint8_t* src, std::size_t n, std::uint8_t* dst) {
+    using namespace detail;
+    std::array<std::uint32_t, std::size_t{1} << kLzHashBits> table;
+    table.fill(0); // position + 1; 0 is empty
+
+    std::uint8_t* op = dst;
+    const auto emit = [&](const std::uint8_t* literals, std::size_t lit_len, std::size_t offset,
+                          std::size_t match_len) {
+        auto* token = op++;
+        *token = static_cast<std::uint8_t>(std::min<std::size_t>(lit_len, 15) << 4);
+        if (lit_len >= 15) {
+            op = put_length(op, lit_len - 15);
+        }
+        if (lit_len > 0) {
+            std::memcpy(op, literals, lit_len);
+            op += lit_len;
+        }
+        if (match_len == 0) {
+            return;
+        }
+        *op++ = static_cast<std::uint8_t>(offset);
+        *op++ = static_cast<std::uint8_t>(offset >> 8);
+        const auto extra = match_len - kLzMinMatch;
+        *token |= static_cast<std::uint8_t>(std::min<std::size_t>(extra, 15));
+        if (extra >= 15) {
+            op = put_length(op, extra - 15);
+        }
+    };
+
+    std::size_t anchor = 0;
+    if (n > kLzMatchLimit) {
+        const auto search_end = n - kLzMatchLimit;
+        const auto* match_end = src + n - kLzLastLiterals;
+        std::size_t ip = 0;
+        while (ip < search_end) {
+            const auto seq = read32(src + ip);
+            auto& slot = table[lz_hash(seq)];
+            const auto ref = static_cast<std::size_t>(slot) - 1;
+            slot = static_cast<std::uint32_t>(ip + 1);
+            if (ref < ip && ip - ref <= kLzMaxOffset && read32(src + ref) == seq) {
+                const auto len = kLzMinMatch + match_length(src + ref + kLzMinMatch, src + ip + kLzMinMatch, match_end);
+                emit(src + anchor, ip - anchor, ip - ref, len);
+                ip += len;
+                anchor = ip;
+                if (ip - 2 < search_end) {
+                    table[lz_hash(read32(src + ip - 2))] = static_cast<std::uint32_t>(ip - 2 + 1);
+                }
+                continue;
+            }
+            ip += 1 + ((ip - anchor) >> 6);
+        }
+    }
+    emit(src + anchor, n - anchor, 0, 0);
+    return static_cast<std::size_t>(op - dst);
+}
+
+/// Decompress src[0, n) into exactly dst[0, out_size); false if the input
+/// is corrupt or does not decode to out_size bytes.
+inline bool lz_decompress(const std::uint8_t* src, std::size_t n, std::uint8_t* dst, std::size_t out_size) noexcept {
+    using namespace detail;
+    const auto* ip = src;
+    const auto* end = src + n;
+    auto* op = dst;
+    auto* out_end = dst + out_size;
+    const auto length = [&](std::size_t len) -> std::size_t {
+        if (len != 15) {
+            return len;
+        }
+        for (;;) {
+            if (ip == end) {
+                return out_size + 1; // fails the bounds checks below
+            }
+            const auto b = *ip++;
+            len += b;
+            if (b != 255) {
+                return len;
+            }
+        }
+    };
+    while (ip < end) {
+        const auto token = *ip++;
+        const auto lit_len = length(token >> 4);
+        if (lit_len > static_cast<std::size_t>(end - ip) || lit_len > static_cast<std::size_t>(out_end - op)) {
+            return false;
+        }
+        if (lit_len > 0) {
+            std::memcpy(op, ip, lit_len);
+            ip += lit_len;
+            op += lit_len;
+        }
+        if (ip == end) {
+            break;
+        }
+        if (end - ip < 2) {
+            return false;
+        }
+        const std::size_t offset = ip[0] | (std::size_t{ip[1]} << 8);
+        ip += 2;
+        const auto match_len = length(token & 15) + kLzMinMatch;
+        if (offset == 0 || offset > static_cast<std::size_t>(op - dst) ||
+            match_len > static_cast<std::size_t>(out_end - op)) {
+            return false;
+        }
+        const auto* ref = op - offset;
+        if (offset >= 8 && static_cast<std::size_t>(out_end - op) >= match_len + 8) {
+            // 8-byte steps may run up to 7 bytes past the match; they are
+            // overwritten by what follows.
+            for (std::size_t i = 0; i < match_len; i += 8) {
+                std::memcpy(op + i, ref + i, 8);
+            }
+        } else {
+            for (std::size_t i = 0; i < match_len; ++i) {
+                op[i] = ref[i];
+            }
+        }
+        op += match_len;
+    }
+    return op == out_end;
+}
+
+} // namespace lob
@@ -1,28 +1,80 @@
+#include "book_impl.hpp"
+#include "client_order_map.hpp"
+#include "csv_writer.hpp"
+#include "fix.hpp"
+#include "itch.hpp"
+#include "journal.hpp"
+#include "mapped_file.hpp"
 #include "matching_engine.hpp"
+#include "price.hpp"
+#include "replay.hpp"
 #include "sim.hpp"
+#include "sweep.hpp"
 #include "types.hpp"
+#include "wire.hpp"
 
+#include <algorithm>
+#include <array>
+#include <charconv>
 #include <chrono>
 #include <cmath>
+#include <filesystem>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
+#include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
+#include <thread>
 
 namespace {
 
+enum class StdinFormat { Text, Fix, Sbe };
+
 struct Args {
     std::size_t simulate = 100000;
     bool use_stdin = false;
+    StdinFormat stdin_format = StdinFormat::Text;
     bool keep_trades = false;
     bool print_book = false;
     std::size_t book_depth = 10;
-    std::int64_t base_price = 10000; // 100.00
-    std::int64_t price_range = 50;   // 0.50
+    lob::PriceScale scale;           // cents unless --tick-size
+    std::string base_text = "100.00"; // prices as given, converted to ticks
+    std::string range_text = "0.50";  // once the tick size is known
+    std::string notional_text;
+    std::string fat_finger_text;
+    std::int64_t base_price = 0;     // ticks
+    std::int64_t price_range = 0;
     std::int64_t max_qty = 100;
     std::uint64_t seed = 1;
     double buy_ratio = 0.5;
     std::string dump_data_dir;
+    std::string book_impl; // default map-deque, flat-list for --itch
+    std::int64_t depth_bin = 1;
+    bool depth_binary = false;
+    std::size_t auction = 0; // orders collected in the opening auction
+    std::int64_t band_bps = 0;
+    std::int64_t breaker_bps = 0;
+    bool band_halts = false;
+    std::uint32_t accounts = 0; // 0 = no pre-trade risk stage
+    lob::RiskLimits limits;
+    lob::ThrottleConfig throttle;
+    bool exec_reports = false;
+    std::size_t clordid_capacity = 262'144;
+    std::string replay_file;
+    std::string workload_out;
+    std::size_t symbols = 100;
+    unsigned threads = 0; // 0 = hardware threads
+    bool scaling = false;
+    std::string sweep_spec;
+    std::string itch_file;
+    std::string itch_out;
+    std::string fix_out;
+    std::string sbe_out;
+    std::string journal_in;
+    std::string journal_out;
+    bool journal_unpack = false;
 };
 
 void print_usage() {
@@ -32,7 +84,16 @@ void print_usage() {
               << "  lob_engine --stdin [options]\n\n"
               << "Options:\n"
               << "  --simulate N         Number of simulated orders (default 100000)\n"
-              << "  --stdin              Read orders from stdin: SIDE PRICE QTY\n"
+              << "  --stdin              Read orders from stdin: SIDE PRICE QTY [CLORDID], C ID or CC CLORDID\n"
+              << "  --stdin-format FMT   text | fix: FIX 4.4 NewOrderSingle, OrderCancelRequest and\n"
+              << "                       OrderCancelReplaceRequest by ClOrdID | sbe: binary NewOrder and\n"
+              << "                       CancelOrder messages (wire.hpp) (default text)\n"
+              << "  --write-fix FILE     Write the --simulate N orders as FIX NewOrderSingles and exit\n"
+              << "  --write-sbe FILE     Write the --simulate N orders as binary NewOrders and exit\n"
+              << "  --journal-pack CSV FILE   Convert a CSV log (trades.csv, ...) to a compressed journal\n"
+              << "                            and exit\n"
+              << "  --journal-unpack FILE CSV Convert a journal back to CSV and exit\n"
+              << "  --tick-size PRICE    Instrument tick size; sets the price decimals (default 0.01)\n"
               << "  --base PRICE         Base price (default 100.00)\n"
               << "  --range PRICE        Max price delta (default 0.50)\n"
               << "  --max-qty N           Max quantity per order (default 100)\n"
@@ -42,12 +103,54 @@ void print_usage() {
               << "  --print-book          Print top of book after run\n"
               << "  --book-depth N        Depth for book print (default 10)\n"
               << "  --dump-data DIR       Dump CSV data to DIR for visualization\n"
+              << "  --depth-bin TICKS     Price bin width for the depth profile (default 1)\n"
+              << "  --depth-format FMT    Depth profile format: csv | bin (default csv)\n"
+              << "  --auction N           Collect the first N orders in an opening call auction\n"
+              << "  --price-band BPS      Reject orders priced beyond BPS of the last trade (default off)\n"
+              << "  --band-action ACT     On a price-band breach: reject | halt (default reject)\n"
+              << "  --circuit-breaker BPS Halt when a trade prints beyond BPS of the open (default off)\n"
+              << "  --accounts N          Spread orders over N accounts with pre-trade risk checks\n"
+              << "  --max-order-qty N     Risk: max quantity per order\n"
+              << "  --max-notional VALUE  Risk: max price * qty per order\n"
+              << "  --max-position N      Risk: max worst-case position per account\n"
+              << "  --max-open-orders N   Risk: max resting orders per account\n"
+              << "  --fat-finger PRICE    Risk: max distance beyond the opposite best price\n"
+              << "  --throttle RATE       Max messages/s per account (default off)\n"
+              << "  --throttle-burst N    Burst allowance per account (default 1)\n"
+              << "  --throttle-total RATE Max messages/s over all accounts (default off)\n"
+              << "  --throttle-queue      Queue throttled messages instead of rejecting them\n"
+              << "  --exec-reports        Emit execution reports (counted; written with --dump-data,\n"
+              << "                        also as FIX to exec_reports.fix for --stdin-format fix and\n"
+              << "                        binary to exec_reports.sbe for --stdin-format sbe)\n"
+              << "  --clordid-capacity N  Client order ids held for --stdin (default 262144;\n"
+              << "                        orders past it are rejected)\n"
+              << "  --replay FILE         Replay a multi-symbol workload (TS SYMBOL SIDE PRICE QTY | TS SYMBOL C ID)\n"
+              << "                        in parallel by symbol\n"
+              << "  --sweep GRID          Run one simulation per grid point, concurrently, e.g.\n"
+              << "                        \"seed=1..8 buy-ratio=0.4,0.6 range=0.25,0.50 max-qty=50,100\"\n"
+              << "                        (--dump-data writes sweep.csv)\n"
+              << "  --threads N           Replay/sweep worker threads (default: hardware threads)\n"
+              << "  --scaling             Replay with 1..N threads and report the speedup\n"
+              << "  --write-workload FILE Write a synthetic workload of --simulate N events and exit\n"
+              << "  --symbols N           Symbols in a written workload (default 100)\n"
+              << "  --itch FILE           Build passive books from an ITCH 5.0 BinaryFILE, one per stock locate\n"
+              << "  --write-itch FILE     Write a synthetic ITCH sample of --simulate N order events over\n"
+              << "                        --symbols stocks and exit\n"
+              << "  --book-impl NAME      Book data structures (default map-deque; flat-list for --itch):\n"
+              << "                        " << lob::kBookImplNames << "\n"
               << "  --help                Show this help\n";
 }
 
-std::int64_t parse_price_ticks(const std::string& text) {
-    const double price = std::stod(text);
-    return static_cast<std::int64_t>(std::llround(price * 100.0));
+bool parse_price_option(const lob::PriceScale& scale, const std::string& text, std::int64_t& ticks) {
+    if (text.empty()) {
+        return true;
+    }
+    const auto error = scale.parse(text, ticks);
+    if (error != lob::PriceError::None) {
+        std::cerr << "Invalid price " << text << ": " << lob::to_string(error) << "\n";
+        return false;
+    }
+    return true;
 }
 
 bool parse_args(int argc, char** argv, Args& args) {
@@ -65,12 +168,47 @@ bool parse_args(int argc, char** argv, Args& args) {
             args.use_stdin = true;
             continue;
         }
+        if (arg == "--stdin-format" && i + 1 < argc) {
+            const std::string format = argv[++i];
+            if (format == "text") {
+                args.stdin_format = StdinFormat::Text;
+            } else if (format == "fix") {
+                args.stdin_format = StdinFormat::Fix;
+            } else if (format == "sbe") {
+                args.stdin_format = StdinFormat::Sbe;
+            } else {
+                std::cerr << "Unknown stdin format: " << format << "\n";
+                return false;
+            }
+            continue;
+        }
+        if (arg == "--write-fix" && i + 1 < argc) {
+            args.fix_out = argv[++i];
+            continue;
+        }
+        if (arg == "--write-sbe" && i + 1 < argc) {
+            args.sbe_out = argv[++i];
+            continue;
+        }
+        if ((arg == "--journal-pack" || arg == "--journal-unpack") && i + 2 < argc) {
+            args.journal_unpack = arg == "--journal-unpack";
+            args.journal_in = argv[++i];
+            args.journal_out = argv[++i];
+            continue;
+        }
+        if (arg == "--tick-size" && i + 1 < argc) {
+            if (!lob::PriceScale::from_tick_size(argv[++i], args.scale)) {
+                std::cerr << "Invalid tick size: " << argv[i] << "\n";
+                return false;
+            }
+            continue;
+        }
         if (arg == "--base" && i + 1 < argc) {
-            args.base_price = parse_price_ticks(argv[++i]);
+            args.base_text = argv[++i];
             continue;
         }
         if (arg == "--range" && i + 1 < argc) {
-            args.price_range = parse_price_ticks(argv[++i]);
+            args.range_text = argv[++i];
             continue;
         }
         if (arg == "--max-qty" && i + 1 < argc) {
@@ -102,16 +240,143 @@ bool parse_args(int argc, char** argv, Args& args) {
             args.keep_trades = true; // need trades for CSV
             continue;
         }
+        if (arg == "--depth-bin" && i + 1 < argc) {
+            args.depth_bin = std::max<std::int64_t>(1, std::stoll(argv[++i]));
+            continue;
+        }
+        if (arg == "--depth-format" && i + 1 < argc) {
+            const std::string format = argv[++i];
+            if (format != "csv" && format != "bin") {
+                std::cerr << "Unknown depth format: " << format << "\n";
+                return false;
+            }
+            args.depth_binary = format == "bin";
+            continue;
+        }
+        if (arg == "--auction" && i + 1 < argc) {
+            args.auction = static_cast<std::size_t>(std::stoull(argv[++i]));
+            continue;
+        }
+        if (arg == "--price-band" && i + 1 < argc) {
+            args.band_bps = std::max<std::int64_t>(0, std::stoll(argv[++i]));
+            continue;
+        }
+        if (arg == "--band-action" && i + 1 < argc) {
+            const std::string action = argv[++i];
+            if (action != "reject" && action != "halt") {
+                std::cerr << "Unknown band action: " << action << "\n";
+                return false;
+            }
+            args.band_halts = action == "halt";
+            continue;
+        }
+        if (arg == "--circuit-breaker" && i + 1 < argc) {
+            args.breaker_bps = std::max<std::int64_t>(0, std::stoll(argv[++i]));
+            continue;
+        }
+        if (arg == "--accounts" && i + 1 < argc) {
+            args.accounts = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            continue;
+        }
+        if (arg == "--max-order-qty" && i + 1 < argc) {
+            args.limits.max_order_qty = std::stoll(argv[++i]);
+            continue;
+        }
+        if (arg == "--max-notional" && i + 1 < argc) {
+            args.notional_text = argv[++i];
+            continue;
+        }
+        if (arg == "--max-position" && i + 1 < argc) {
+            args.limits.max_position = std::stoll(argv[++i]);
+            continue;
+        }
+        if (arg == "--max-open-orders" && i + 1 < argc) {
+            args.limits.max_open_orders = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            continue;
+        }
+        if (arg == "--fat-finger" && i + 1 < argc) {
+            args.fat_finger_text = argv[++i];
+            continue;
+        }
+        if (arg == "--throttle" && i + 1 < argc) {
+            args.throttle.account_rate = std::stod(argv[++i]);
+            continue;
+        }
+        if (arg == "--throttle-burst" && i + 1 < argc) {
+            args.throttle.account_burst = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+            args.throttle.total_burst = args.throttle.account_burst;
+            continue;
+        }
+        if (arg == "--throttle-total" && i + 1 < argc) {
+            args.throttle.total_rate = std::stod(argv[++i]);
+            continue;
+        }
+        if (arg == "--throttle-queue") {
+            args.throttle.action = lob::ThrottleAction::Queue;
+            continue;
+        }
+        if (arg == "--exec-reports") {
+            args.exec_reports = true;
+            continue;
+        }
+        if (arg == "--clordid-capacity" && i + 1 < argc) {
+            args.clordid_capacity = std::max<std::size_t>(1, std::stoull(argv[++i]));
+            continue;
+        }
+        if (arg == "--replay" && i + 1 < argc) {
+            args.replay_file = argv[++i];
+            continue;
+        }
+        if (arg == "--itch" && i + 1 < argc) {
+            args.itch_file = argv[++i];
+            continue;
+        }
+        if (arg == "--write-itch" && i + 1 < argc) {
+            args.itch_out = argv[++i];
+            continue;
+        }
+        if (arg == "--sweep" && i + 1 < argc) {
+            args.sweep_spec = argv[++i];
+            continue;
+        }
+        if (arg == "--threads" && i + 1 < argc) {
+            args.threads = static_cast<unsigned>(std::stoul(argv[++i]));
+            continue;
+        }
+        if (arg == "--scaling") {
+            args.scaling = true;
+            continue;
+        }
+        if (arg == "--write-workload" && i + 1 < argc) {
+            args.workload_out = argv[++i];
+            continue;
+        }
+        if (arg == "--symbols" && i + 1 < argc) {
+            args.symbols = std::max<std::size_t>(1, std::stoull(argv[++i]));
+            continue;
+        }
+        if (arg == "--book-impl" && i + 1 < argc) {
+            args.book_impl = argv[++i];
+            if (!lob::visit_book_impl(args.book_impl, [](auto) {})) {
+                std::cerr << "Unknown book implementation: " << args.book_impl << "\n";
+                return false;
+            }
+            continue;
+        }
 
         std::cerr << "Unknown argument: " << arg << "\n";
         print_usage();
         return false;
     }
 
-    return true;
+    return parse_price_option(args.scale, args.base_text, args.base_price) &&
+           parse_price_option(args.scale, args.range_text, args.price_range) &&
+           parse_price_option(args.scale, args.notional_text, args.limits.max_notional) &&
+           parse_price_option(args.scale, args.fat_finger_text, args.limits.max_price_distance);
 }
 
-bool parse_order_line(const std::string& line, lob::Order& order) {
+bool parse_order_line(const std::string& line, const lob::PriceScale& scale, lob::Order& order,
+                      std::string& clordid) {
     std::istringstream iss(line);
     std::string side_text;
     std::string price_text;
@@ -119,6 +384,9 @@ bool parse_order_line(const std::string& line, lob::Order& order) {
     if (!(iss >> side_text >> price_text >> qty)) {
         return false;
     }
+    if (!(iss >> clordid)) {
+        clordid.clear();
+    }
 
     if (side_text == "B" || side_text == "BUY" || side_text == "Buy" || side_text == "buy") {
         order.side = lob::Side::Buy;
@@ -128,69 +396,728 @@ bool parse_order_line(const std::string& line, lob::Order& order) {
         return false;
     }
 
-    order.price = parse_price_ticks(price_text);
+    if (scale.parse(price_text, order.price) != lob::PriceError::None) {
+        return false;
+    }
     order.qty = qty;
     order.ts_ns = lob::now_ns();
     return true;
 }
 
-} // namespace
+bool parse_cancel_line(const std::string& line, std::uint64_t& id) {
+    std::istringstream iss(line);
+    std::string tag;
+    if (!(iss >> tag) || (tag != "C" && tag != "CANCEL" && tag != "Cancel" && tag != "cancel")) {
+        return false;
+    }
+    return static_cast<bool>(iss >> id);
+}
 
-int main(int argc, char** argv) {
-    Args args;
-    if (!parse_args(argc, argv, args)) {
+/// The reject for a ClOrdID the map did not take, or None.
+lob::RejectReason clordid_reject(lob::ClientOrderMap::Insert inserted) {
+    switch (inserted) {
+    case lob::ClientOrderMap::Insert::Ok:        return lob::RejectReason::None;
+    case lob::ClientOrderMap::Insert::Duplicate: return lob::RejectReason::DuplicateClOrdId;
+    case lob::ClientOrderMap::Insert::Full:      return lob::RejectReason::ClOrdIdLimit;
+    case lob::ClientOrderMap::Insert::BadId:     return lob::RejectReason::InvalidClOrdId;
+    }
+    return lob::RejectReason::InvalidClOrdId;
+}
+
+/// The stdin session's ClOrdIDs (session 0). The map resolves them to
+/// engine ids; each order's key is also kept by engine id, so that its
+/// last report (fill, cancel or reject) erases it and the id is free to
+/// use again.
+struct ClientIds {
+    lob::ClientOrderMap map;
+    std::vector<lob::ClientKey> by_id; // empty: no ClOrdID, or released
+
+    explicit ClientIds(std::size_t capacity) : map(capacity) {}
+
+    /// Map clordid to engine id `id`; the reject if it cannot be taken.
+    lob::RejectReason take(std::string_view clordid, std::uint64_t id) {
+        const auto reject = clordid_reject(map.insert(0, clordid, id));
+        if (reject == lob::RejectReason::None) {
+            if (id >= by_id.size()) {
+                by_id.resize(id + 1);
+            }
+            by_id[id].assign(0, clordid);
+        }
+        return reject;
+    }
+
+    std::uint64_t find(std::string_view clordid) const { return map.find(0, clordid); }
+
+    std::string_view name(std::uint64_t id) const {
+        return id < by_id.size() ? by_id[id].view() : std::string_view{};
+    }
+
+    /// Erase the ClOrdID of engine id `id`, if it has one.
+    void release(std::uint64_t id) {
+        if (id < by_id.size() && by_id[id].length != 0) {
+            map.erase(0, by_id[id].view());
+            by_id[id] = {};
+        }
+    }
+};
+
+/// "CC CLORDID": cancel by client order id.
+bool parse_client_cancel_line(const std::string& line, std::string& clordid) {
+    std::istringstream iss(line);
+    std::string tag;
+    return (iss >> tag) && tag == "CC" && static_cast<bool>(iss >> clordid);
+}
+
+template <typename Book>
+void print_book_stats(const Book& book) {
+    for (const auto side : {lob::Side::Buy, lob::Side::Sell}) {
+        const auto totals = book.side_stats(side);
+        const auto top = book.top_stats(side);
+        std::cout << lob::side_to_string(side) << ": qty=" << totals.qty
+                  << " orders=" << totals.orders
+                  << " levels=" << totals.levels
+                  << " top_orders=" << top.orders
+                  << " top_avg_size=" << top.avg_size() << "\n";
+    }
+    std::cout << "Top-of-book imbalance: " << book.imbalance() << "\n";
+}
+
+template <typename Engine>
+void run_auction(Engine& engine, std::vector<lob::Trade>& trades) {
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = engine.uncross(trades);
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    if (!result.crossed) {
+        std::cout << "Opening auction: no cross\n";
+        return;
+    }
+    std::cout << "Opening auction: price=" << result.price
+              << " volume=" << result.volume
+              << " surplus=" << result.surplus
+              << " (" << elapsed.count() << "us)\n";
+}
+
+struct RejectCounts {
+    std::array<std::size_t, lob::kRejectReasonCount> by_reason{};
+    std::size_t halted_at = 0; // message count when the session halted
+
+    void add(lob::RejectReason reason) {
+        if (reason != lob::RejectReason::Queued) {
+            ++by_reason[static_cast<std::size_t>(reason)];
+        }
+    }
+
+    std::size_t total() const {
+        std::size_t sum = 0;
+        for (std::size_t r = 1; r < by_reason.size(); ++r) {
+            sum += by_reason[r];
+        }
+        return sum;
+    }
+
+    void report(std::ostream& os) const {
+        const char* sep = " (";
+        for (std::size_t r = 1; r < by_reason.size(); ++r) {
+            if (by_reason[r] > 0) {
+                os << sep << lob::to_string(static_cast<lob::RejectReason>(r)) << " " << by_reason[r];
+                sep = ", ";
+            }
+        }
+        if (sep[0] == ',') {
+            os << ")";
+        }
+    }
+};
+
+/// Drains the engine's report buffer after each message: counts by type,
+/// appends to a CSV when one is open, and releases the ClOrdID of each
+/// order that is done.
+struct ExecReportLog {
+    std::array<std::size_t, lob::kExecTypeCount> by_type{};
+    std::unique_ptr<std::ofstream> file;
+    std::unique_ptr<lob::CsvWriter> csv;
+    // FIX ExecutionReports, one per line, each with its order's ClOrdID;
+    // a cancel reject, or the reject of an order never named (refused by
+    // the gateway), answers the request being handled.
+    std::unique_ptr<std::ofstream> fix_file;
+    std::unique_ptr<lob::FixEncoder> fix;
+    ClientIds* client_ids = nullptr;
+    std::string request_clordid;
+    lob::FixMsgType request_type = lob::FixMsgType::Other;
+    std::unique_ptr<std::ofstream> sbe_file; // wire::ExecutionReports
+
+    void open(const std::string& path) {
+        file = std::make_unique<std::ofstream>(path);
+        csv = std::make_unique<lob::CsvWriter>(*file);
+        *file << "exec_id,order_id,type,side,account,price,last_qty,leaves_qty,cum_qty,contra_id,reason\n";
+    }
+
+    void open_fix(const std::string& path, const lob::PriceScale& scale) {
+        fix_file = std::make_unique<std::ofstream>(path, std::ios::binary);
+        fix = std::make_unique<lob::FixEncoder>("LOB", "CLIENT", scale);
+    }
+
+    void open_sbe(const std::string& path) {
+        sbe_file = std::make_unique<std::ofstream>(path, std::ios::binary);
+    }
+
+    void name_request(lob::FixMsgType type, std::string_view clordid) {
+        if (fix) {
+            request_type = type;
+            request_clordid.assign(clordid);
+        }
+    }
+
+    /// Session-level Reject of a message that did not decode.
+    void session_reject(std::uint64_t seq, lob::FixError error) {
+        if (fix) {
+            char out[lob::FixEncoder::kMaxMessage];
+            const auto msg = fix->session_reject(seq, error, lob::wall_clock_ns(), out);
+            fix_file->write(msg.data(), static_cast<std::streamsize>(msg.size()));
+            fix_file->put('\n');
+        }
+    }
+
+    void drain(lob::ExecReportBuffer& buffer) {
+        for (const auto& r : buffer) {
+            ++by_type[static_cast<std::size_t>(r.type)];
+            if (csv) {
+                csv->field(r.exec_id).field(r.order_id).field(lob::to_string(r.type))
+                    .field(r.side == lob::Side::Buy ? "BUY" : "SELL").field(r.account).field(r.price)
+                    .field(r.last_qty).field(r.leaves_qty).field(r.cum_qty).field(r.contra_id)
+                    .field(lob::to_string(r.reason));
+                csv->end_row();
+            }
+            if (fix) {
+                char out[lob::FixEncoder::kMaxMessage];
+                const auto named = client_ids ? client_ids->name(r.order_id) : std::string_view{};
+                const auto answers_request = r.type == lob::ExecType::CancelRejected ||
+                                             (r.type == lob::ExecType::Rejected && named.empty());
+                const auto msg = fix->execution_report(r, answers_request ? request_clordid : named,
+                                                       lob::wall_clock_ns(), out, request_type);
+                fix_file->write(msg.data(), static_cast<std::streamsize>(msg.size()));
+                fix_file->put('\n');
+            }
+            if (sbe_file) {
+                std::byte out[lob::wire::kMaxMessage];
+                const auto msg = lob::wire::encode(r, out);
+                sbe_file->write(msg.data(), static_cast<std::streamsize>(msg.size()));
+            }
+            if (client_ids && (r.type == lob::ExecType::Fill || r.type == lob::ExecType::Cancelled ||
+                               r.type == lob::ExecType::Rejected)) {
+                client_ids->release(r.order_id);
+            }
+        }
+        buffer.clear();
+    }
+
+    void report(std::ostream& os, std::uint64_t dropped) const {
+        os << "Execution reports:";
+        const char* sep = " ";
+        for (std::size_t t = 0; t < by_type.size(); ++t) {
+            if (by_type[t] > 0) {
+                os << sep << lob::to_string(static_cast<lob::ExecType>(t)) << " " << by_type[t];
+                sep = ", ";
+            }
+        }
+        if (dropped > 0) {
+            os << " (dropped " << dropped << ")";
+        }
+        os << "\n";
+    }
+};
+
+lob::SimConfig sim_config(const Args& args) {
+    lob::SimConfig cfg;
+    cfg.count = args.simulate;
+    cfg.base_price = args.base_price;
+    cfg.price_range = args.price_range;
+    cfg.max_qty = args.max_qty;
+    cfg.seed = args.seed;
+    cfg.buy_ratio = args.buy_ratio;
+    cfg.accounts = args.accounts;
+    return cfg;
+}
+
+/// The --simulate order stream as FIX NewOrderSingles, one per line, each
+/// ClOrdID the order's id.
+void write_fix_orders(std::ostream& out, const Args& args) {
+    lob::FixEncoder encoder("CLIENT", "LOB", args.scale);
+    char buf[lob::FixEncoder::kMaxMessage];
+    const auto time_ns = lob::wall_clock_ns();
+    lob::run_simulation(sim_config(args), [&](const lob::Order& order) {
+        char clordid[24];
+        const auto end = std::to_chars(clordid, clordid + sizeof(clordid), order.id).ptr;
+        const auto msg = encoder.new_order(order, {clordid, static_cast<std::size_t>(end - clordid)}, time_ns, buf);
+        out.write(msg.data(), static_cast<std::streamsize>(msg.size()));
+        out.put('\n');
+    });
+}
+
+void write_sbe_orders(std::ostream& out, const Args& args) {
+    std::byte buf[lob::wire::kMaxMessage];
+    lob::run_simulation(sim_config(args), [&](const lob::Order& order) {
+        const auto msg = lob::wire::encode_new_order(order, buf);
+        out.write(msg.data(), static_cast<std::streamsize>(msg.size()));
+    });
+}
+
+/// --journal-pack / --journal-unpack. The output is written to a
+/// temporary file and renamed into place only once it is complete.
+int convert_journal(const Args& args) {
+    lob::MappedFile in;
+    std::string error;
+    if (!in.open(args.journal_in, error)) {
+        std::cerr << error << "\n";
         return 1;
     }
+    const auto temp = args.journal_out + ".tmp";
+    std::ofstream out(temp, std::ios::binary);
+    if (!out) {
+        std::cerr << "Cannot open " << temp << "\n";
+        return 1;
+    }
+    lob::JournalStats stats;
+    const auto start = std::chrono::steady_clock::now();
+    const bool ok = args.journal_unpack
+                        ? lob::journal_to_csv(in.data(), in.size(), out, stats, error)
+                        : lob::csv_to_journal(reinterpret_cast<const char*>(in.data()), in.size(), out, stats, error);
+    const auto written = static_cast<std::uint64_t>(out.tellp());
+    out.close();
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    std::error_code ec;
+    if (ok && out) {
+        std::filesystem::rename(temp, args.journal_out, ec);
+    }
+    if (!ok || !out || ec) {
+        std::filesystem::remove(temp, ec);
+        std::cerr << args.journal_in << ": " << (!error.empty() ? error : "cannot write " + args.journal_out)
+                  << "\n";
+        return 1;
+    }
+    const auto csv_bytes = args.journal_unpack ? written : in.size();
+    const auto secs = elapsed.count();
+    std::cout << (args.journal_unpack ? "Unpacked " : "Packed ") << stats.rows << " rows in " << stats.blocks
+              << " blocks: CSV " << csv_bytes << " bytes, journal " << stats.file_bytes << " bytes ("
+              << std::fixed << std::setprecision(1)
+              << static_cast<double>(csv_bytes) / static_cast<double>(std::max<std::uint64_t>(stats.file_bytes, 1))
+              << "x) in " << std::setprecision(3) << secs << "s ("
+              << static_cast<std::uint64_t>(static_cast<double>(csv_bytes) / secs / (1 << 20)) << " MiB/s of CSV)\n";
+    return 0;
+}
+
+std::uint64_t checksum(const std::vector<lob::SymbolTrade>& trades) {
+    std::uint64_t sum = 0;
+    for (const auto& t : trades) {
+        sum = sum * 1'000'003 + t.ts + t.symbol + t.trade.maker_id * 7 + static_cast<std::uint64_t>(t.trade.qty);
+    }
+    return sum;
+}
+
+template <typename Book>
+int run_replay(const Args& args) {
+    lob::Workload workload;
+    {
+        std::ifstream in(args.replay_file);
+        if (!in) {
+            std::cerr << "Cannot open " << args.replay_file << "\n";
+            return 1;
+        }
+        std::string error;
+        if (!lob::read_workload(in, args.scale, workload, error)) {
+            std::cerr << "Invalid workload " << error << "\n";
+            return 1;
+        }
+    }
+    std::size_t largest = 0;
+    for (const auto& events : workload.events) {
+        largest = std::max(largest, events.size());
+    }
+    std::cout << "Workload: " << workload.total << " events, " << workload.symbols.size()
+              << " symbols (largest " << largest << " events)\n";
 
+    const auto max_threads = args.threads > 0 ? args.threads : std::max(1u, std::thread::hardware_concurrency());
+    const auto first = args.scaling ? 1u : max_threads;
+    double base_secs = 0.0;
+    std::uint64_t base_sum = 0;
+    std::vector<lob::SymbolTrade> merged;
+    if (args.scaling) {
+        std::cout << "threads | seconds | Mevents/s | speedup | steals | trades\n";
+    }
+    for (auto threads = first; threads <= max_threads; ++threads) {
+        const auto result = lob::replay_parallel<Book>(workload, threads);
+        merged = lob::merge_by_time(result.trades);
+        const auto sum = checksum(merged);
+        if (threads == first) {
+            base_secs = result.seconds;
+            base_sum = sum;
+        }
+        const auto rate = static_cast<double>(workload.total) / result.seconds * 1e-6;
+        if (args.scaling) {
+            std::cout << std::setw(7) << threads << " | " << std::setw(7) << std::fixed << std::setprecision(3)
+                      << result.seconds << " | " << std::setw(9) << std::setprecision(2) << rate << " | "
+                      << std::setw(7) << base_secs / result.seconds << " | " << std::setw(6) << result.steals
+                      << " | " << merged.size() << (sum == base_sum ? "" : " (DIFFERS)") << "\n";
+        } else {
+            std::cout << "Replayed on " << threads << " threads in " << result.seconds << "s (" << rate
+                      << " M events/s, " << result.steals << " steals), " << merged.size() << " trades\n";
+        }
+        if (sum != base_sum) {
+            std::cerr << "Trade stream differs with " << threads << " threads\n";
+            return 1;
+        }
+    }
+
+    if (!args.dump_data_dir.empty()) {
+        std::ofstream f(args.dump_data_dir + "/replay_trades.csv");
+        lob::CsvWriter csv(f);
+        csv.field("ts").field("symbol").field("taker_id").field("maker_id").field("price").field("qty").end_row();
+        for (const auto& t : merged) {
+            csv.field(t.ts).field(workload.symbols[t.symbol]).field(t.trade.taker_id).field(t.trade.maker_id)
+                .field(t.trade.price).field(t.trade.qty).end_row();
+        }
+        std::cout << "Data dumped to " << args.dump_data_dir << "/\n";
+    }
+    return 0;
+}
+
+template <typename Book>
+int run_itch(const Args& args) {
+    lob::MappedFile file;
+    std::string error;
+    if (!file.open(args.itch_file, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    lob::ItchReplay<Book> replay;
+    const auto start = std::chrono::steady_clock::now();
+    replay.replay(file.data(), file.size());
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    const auto& stats = replay.stats();
+    const auto secs = elapsed.count();
+    std::cout << "ITCH: " << stats.messages << " messages, " << stats.bytes / (1 << 20) << " MiB"
+              << (file.mapped() ? " (mapped)" : " (read)") << " in " << secs << "s ("
+              << static_cast<std::uint64_t>(static_cast<double>(stats.messages) / secs) << " msg/s, "
+              << static_cast<std::uint64_t>(static_cast<double>(stats.bytes) / secs / (1 << 20)) << " MiB/s)\n";
+    std::cout << "By type:";
+    for (std::size_t t = 0; t < stats.by_type.size(); ++t) {
+        if (stats.by_type[t] > 0) {
+            std::cout << " " << static_cast<char>(t) << "=" << stats.by_type[t];
+        }
+    }
+    std::cout << "\n";
+
+    std::size_t books = 0;
+    lob::SideStats bids;
+    lob::SideStats asks;
+    replay.for_each_book([&](std::uint16_t, const Book& book) {
+        ++books;
+        for (const auto side : {lob::Side::Buy, lob::Side::Sell}) {
+            const auto s = book.side_stats(side);
+            auto& total = side == lob::Side::Buy ? bids : asks;
+            total.qty += s.qty;
+            total.orders += s.orders;
+            total.levels += s.levels;
+        }
+    });
+    std::cout << "Books: " << books << ", resting bids " << bids.orders << " (" << bids.levels << " levels), asks "
+              << asks.orders << " (" << asks.levels << " levels)\n";
+    if (stats.unknown_refs > 0 || stats.duplicate_ids > 0 || stats.malformed > 0 || stats.truncated) {
+        std::cout << "Unknown order refs " << stats.unknown_refs << ", duplicate adds " << stats.duplicate_ids
+                  << ", malformed " << stats.malformed
+                  << (stats.truncated ? ", file truncated" : "") << "\n";
+    }
+    std::cout << "Book update (sampled) ";
+    replay.latency().report(std::cout);
+
+    if (args.print_book) {
+        replay.for_each_book([&](std::uint16_t locate, const Book& book) {
+            if (locate == 1) {
+                std::cout << "Stock locate 1 (prices in 1/10000):\n";
+                book.dump(std::cout, args.book_depth);
+            }
+        });
+    }
+    return 0;
+}
+
+template <typename Book>
+int run_sweep(const Args& args) {
+    const auto base = sim_config(args);
+    lob::SweepGrid grid;
+    std::string error;
+    if (!lob::parse_sweep_grid(args.sweep_spec, base, args.scale, grid, error)) {
+        std::cerr << "Invalid --sweep: " << error << "\n";
+        return 1;
+    }
+    const auto points = lob::expand(grid, base);
+    const auto sweep = lob::run_sweep<Book>(points, args.threads);
+
+    std::uint64_t orders = 0;
+    std::cout << "seed | buy_ratio | range | max_qty | msg/s | p50 | p99 | trades | bid_levels | ask_levels\n";
+    for (const auto& r : sweep.results) {
+        orders += r.cfg.count;
+        std::cout << r.cfg.seed << " | " << r.cfg.buy_ratio << " | " << args.scale.to_string(r.cfg.price_range)
+                  << " | " << r.cfg.max_qty << " | "
+                  << static_cast<std::uint64_t>(static_cast<double>(r.cfg.count) / r.seconds) << " | "
+                  << r.latency.p50 << " | " << r.latency.p99 << " | " << r.trades << " | " << r.bids.levels
+                  << " | " << r.asks.levels << "\n";
+    }
+    std::cout << "Swept " << points.size() << " points (" << orders << " orders) in " << sweep.seconds << "s on "
+              << (args.threads > 0 ? args.threads : std::max(1u, std::thread::hardware_concurrency()))
+              << " threads (" << sweep.steals << " steals)\n";
+
+    if (!args.dump_data_dir.empty()) {
+        std::ofstream f(args.dump_data_dir + "/sweep.csv");
+        lob::write_sweep_csv(f, sweep, args.scale);
+        std::cout << "Data dumped to " << args.dump_data_dir << "/\n";
+    }
+    return 0;
+}
+
+template <typename Book>
+int run(const Args& args) {
     lob::LatencyStats latency;
     if (!args.use_stdin) {
         latency.reserve(args.simulate);
     }
 
-    lob::MatchingEngine engine(latency);
+    lob::SessionConfig session;
+    session.reference_price = args.use_stdin ? 0 : args.base_price;
+    session.band_bps = args.band_bps;
+    session.breaker_bps = args.breaker_bps;
+    session.band_action = args.band_halts ? lob::BandAction::Halt : lob::BandAction::Reject;
+
+    lob::BasicMatchingEngine<Book> engine(latency, session);
+    if (args.accounts > 0) {
+        engine.risk().assign(args.accounts, args.limits);
+    }
+    if (args.throttle.account_rate > 0.0 || args.throttle.total_rate > 0.0) {
+        auto throttle = args.throttle;
+        if (args.accounts > 0) {
+            throttle.accounts = args.accounts;
+        }
+        engine.throttle().configure(throttle, lob::tsc_ticks_per_second());
+    }
+    // Reports are drained after every message; an uncross writes up to
+    // two per order at once. Stdin always takes them: they release
+    // finished orders' ClOrdIDs.
+    const bool reports = args.exec_reports || args.use_stdin;
+    lob::ExecReportBuffer report_buffer(reports ? (1 << 16) + 2 * args.auction : 0);
+    ExecReportLog report_log;
+    std::optional<ClientIds> client_ids; // stdin, from the first ClOrdID
+    if (reports) {
+        engine.attach_reports(&report_buffer);
+    }
+    if (args.exec_reports) {
+        if (!args.dump_data_dir.empty()) {
+            report_log.open(args.dump_data_dir + "/exec_reports.csv");
+            if (args.stdin_format == StdinFormat::Fix) {
+                report_log.open_fix(args.dump_data_dir + "/exec_reports.fix", args.scale);
+            } else if (args.stdin_format == StdinFormat::Sbe) {
+                report_log.open_sbe(args.dump_data_dir + "/exec_reports.sbe");
+            }
+        }
+    }
+    RejectCounts rejects;
+    auto on_result = [&](lob::RejectReason reason, std::size_t processed) {
+        report_log.drain(report_buffer);
+        rejects.add(reason);
+        if (rejects.halted_at == 0 && engine.session().state() == lob::SessionState::Halted) {
+            rejects.halted_at = processed;
+        }
+    };
     std::vector<lob::Trade> trades;
     trades.reserve(64);
+    if (args.auction > 0) {
+        engine.begin_auction();
+    }
 
     std::size_t processed = 0;
     const auto start = std::chrono::steady_clock::now();
 
-    if (args.use_stdin) {
+    const auto auction_due = [&] {
+        if (processed == args.auction) {
+            run_auction(engine, trades);
+            report_log.drain(report_buffer);
+        }
+    };
+    const auto submit_cancel = [&](std::uint64_t id) {
+        const auto qty = engine.cancel(id);
+        report_log.drain(report_buffer);
+        ++processed;
+        auction_due();
+        return qty;
+    };
+    const auto submit_order = [&](const lob::Order& order) {
+        const auto reason = engine.process(order, trades);
+        ++processed;
+        on_result(reason, processed);
+        auction_due();
+        if (!args.keep_trades) {
+            trades.clear();
+        }
+    };
+    // A message the gateway refused (a bad ClOrdID): a reject, counted,
+    // in place of the order or the replace.
+    const auto submit_reject = [&](const lob::Order& order, lob::RejectReason reason) {
+        engine.reject(order, reason);
+        ++processed;
+        on_result(reason, processed);
+        auction_due();
+    };
+    // Cancel/replace of order `id`; false if it was refused (the original
+    // is gone or has filled the new quantity).
+    const auto submit_replace = [&](std::uint64_t id, const lob::Order& order) {
+        auto reason = lob::RejectReason::None;
+        const bool replaced = engine.replace(id, order, trades, reason);
+        ++processed;
+        on_result(reason, processed);
+        auction_due();
+        if (!args.keep_trades) {
+            trades.clear();
+        }
+        return replaced;
+    };
+    const auto submit_replace_reject = [&](std::uint64_t id, lob::RejectReason reason) {
+        engine.reject_cancel(id, reason);
+        ++processed;
+        on_result(reason, processed);
+        auction_due();
+    };
+    std::size_t fix_rejected = 0; // session Rejects sent
+    std::size_t fix_garbled = 0;  // frames dropped unanswered
+
+    if (args.use_stdin && args.stdin_format == StdinFormat::Fix) {
+        // Session 0; a replace is a cancel and a new order under the new
+        // ClOrdID, for the quantity the original has not filled.
+        // A message that does not decode gets a session Reject and a garbled
+        // frame is dropped; a ClOrdID the map cannot take rejects its order
+        // or replace. None of them ends the session.
+        auto& clordids = client_ids.emplace(args.clordid_capacity);
+        report_log.client_ids = &clordids;
+        const lob::FixDecoder decoder(args.scale);
+        lob::FixStreamReader reader(std::cin, decoder);
+        lob::FixMessage msg;
+        auto error = lob::FixError::None;
+        while (reader.next(msg, error)) {
+            if (error != lob::FixError::None) {
+                if (lob::is_garbled(error)) {
+                    ++fix_garbled;
+                } else {
+                    report_log.session_reject(msg.seq, error);
+                    ++fix_rejected;
+                }
+                continue;
+            }
+            if (msg.type == lob::FixMsgType::Other) {
+                continue;
+            }
+            report_log.name_request(msg.type, msg.clordid);
+            if (msg.type == lob::FixMsgType::OrderCancelRequest) {
+                submit_cancel(clordids.find(msg.orig_clordid));
+                continue;
+            }
+
+            auto& order = msg.order;
+            order.id = static_cast<std::uint64_t>(processed + 1);
+            order.ts_ns = lob::now_ns();
+            // Taken before a replace cancels, so a bad new ClOrdID leaves the
+            // original order in place; given back if the replace is refused.
+            const auto reject = clordids.take(msg.clordid, order.id);
+            if (msg.type == lob::FixMsgType::OrderCancelReplaceRequest) {
+                const auto orig = clordids.find(msg.orig_clordid);
+                if (reject != lob::RejectReason::None) {
+                    submit_replace_reject(orig, reject);
+                } else if (!submit_replace(orig, order)) {
+                    clordids.release(order.id);
+                }
+                continue;
+            }
+            if (reject != lob::RejectReason::None) {
+                submit_reject(order, reject);
+                continue;
+            }
+            submit_order(order);
+        }
+        if (error != lob::FixError::None) { // cut off inside the last message
+            ++fix_garbled;
+        }
+    } else if (args.use_stdin && args.stdin_format == StdinFormat::Sbe) {
+        // Reports and trades in the input are output messages; skipped.
+        lob::wire::Reader reader(std::cin);
+        lob::sbe::Frame frame;
+        auto error = lob::sbe::Error::None;
+        while (reader.next(frame, error)) {
+            if (frame.is<lob::wire::CancelOrder>()) {
+                submit_cancel(frame.get<lob::wire::CancelOrder>().get<lob::wire::OrderId>());
+                continue;
+            }
+            if (!frame.is<lob::wire::NewOrder>()) {
+                continue;
+            }
+            lob::Order order;
+            if (!lob::wire::read_order(frame.get<lob::wire::NewOrder>(), order)) {
+                std::cerr << "Invalid NewOrder after " << processed << " orders\n";
+                return 1;
+            }
+            order.id = static_cast<std::uint64_t>(processed + 1);
+            order.ts_ns = lob::now_ns();
+            submit_order(order);
+        }
+        if (error != lob::sbe::Error::None) {
+            std::cerr << "Invalid SBE message after " << processed << " orders: " << lob::sbe::to_string(error)
+                      << "\n";
+            return 1;
+        }
+    } else if (args.use_stdin) {
+        std::string clordid;
         std::string line;
         while (std::getline(std::cin, line)) {
             if (line.empty()) {
                 continue;
             }
 
+            std::uint64_t cancel_id = 0;
+            bool is_cancel = parse_cancel_line(line, cancel_id);
+            if (!is_cancel && parse_client_cancel_line(line, clordid)) {
+                is_cancel = true;
+                cancel_id = client_ids ? client_ids->find(clordid) : lob::ClientOrderMap::kNoId;
+            }
+            if (is_cancel) {
+                submit_cancel(cancel_id);
+                continue;
+            }
+
             lob::Order order;
             order.id = static_cast<std::uint64_t>(processed + 1);
-            if (!parse_order_line(line, order)) {
+            if (!parse_order_line(line, args.scale, order, clordid)) {
                 std::cerr << "Invalid order line: " << line << "\n";
                 return 1;
             }
-
-            engine.process(order, trades);
-            ++processed;
-            if (!args.keep_trades) {
-                trades.clear();
+            if (!clordid.empty()) {
+                if (!client_ids) {
+                    report_log.client_ids = &client_ids.emplace(args.clordid_capacity);
+                }
+                const auto reject = client_ids->take(clordid, order.id);
+                if (reject != lob::RejectReason::None) {
+                    submit_reject(order, reject);
+                    continue;
+                }
             }
+            submit_order(order);
         }
     } else {
-        lob::SimConfig cfg;
-        cfg.count = args.simulate;
-        cfg.base_price = args.base_price;
-        cfg.price_range = args.price_range;
-        cfg.max_qty = args.max_qty;
-        cfg.seed = args.seed;
-        cfg.buy_ratio = args.buy_ratio;
-
-        lob::run_simulation(cfg, [&](const lob::Order& order) {
-            engine.process(order, trades);
-            ++processed;
-            if (!args.keep_trades) {
-                trades.clear();
-            }
-        });
+        lob::run_simulation(sim_config(args), submit_order);
+    }
+
+    engine.drain_throttled(trades);
+    if (engine.in_auction()) {
+        run_auction(engine, trades);
     }
+    report_log.drain(report_buffer);
 
     const auto end = std::chrono::steady_clock::now();
     const std::chrono::duration<double> elapsed = end - start;
@@ -201,10 +1128,39 @@ int main(int argc, char** argv) {
     std::cout << "Processed " << processed << " orders in " << secs << "s ("
               << static_cast<std::uint64_t>(msg_per_sec) << " msg/s)\n";
 
+    if (fix_rejected + fix_garbled > 0) {
+        std::cout << "FIX: rejected " << fix_rejected << " invalid messages, dropped " << fix_garbled
+                  << " garbled\n";
+    }
+
     latency.report(std::cout);
 
+    if (engine.throttle().active()) {
+        const auto& c = engine.throttle().counters();
+        std::cout << "Throttle: admitted " << c.admitted
+                  << ", rejected " << c.rejected
+                  << ", queued " << c.queued
+                  << " (released " << c.released
+                  << ", still pending " << engine.throttle().queued() << ")\n";
+    }
+
+    if (args.exec_reports) {
+        report_log.report(std::cout, report_buffer.dropped());
+    }
+
+    if (rejects.total() > 0 || rejects.halted_at > 0) {
+        std::cout << "Session " << lob::to_string(engine.session().state())
+                  << ": rejected " << rejects.total();
+        rejects.report(std::cout);
+        if (rejects.halted_at > 0) {
+            std::cout << ", halted after message " << rejects.halted_at;
+        }
+        std::cout << "\n";
+    }
+
     if (args.print_book) {
         engine.book().dump(std::cout, args.book_depth);
+        print_book_stats(engine.book());
     }
 
     if (!args.dump_data_dir.empty()) {
@@ -220,6 +1176,15 @@ int main(int argc, char** argv) {
                   << "," << t.price << "," << t.qty << "\n";
             }
         }
+        // ...and as binary TradeReports for binary input
+        if (args.use_stdin && args.stdin_format == StdinFormat::Sbe) {
+            std::ofstream f(dir + "/trades.sbe", std::ios::binary);
+            std::byte out[lob::wire::kMaxMessage];
+            for (const auto& t : trades) {
+                const auto msg = lob::wire::encode(t, out);
+                f.write(msg.data(), static_cast<std::streamsize>(msg.size()));
+            }
+        }
 
         // Write latency CSV
         {
@@ -233,8 +1198,82 @@ int main(int argc, char** argv) {
             engine.book().dump_csv(f);
         }
 
+        // Write the price scale, so prices in ticks can be read back
+        {
+            std::ofstream f(dir + "/scale.csv");
+            f << "tick_size,decimals\n" << args.scale.to_string(1) << "," << args.scale.decimals() << "\n";
+        }
+
+        // Write depth profile
+        {
+            const auto profile = engine.book().depth_profile(args.depth_bin);
+            if (args.depth_binary) {
+                std::ofstream f(dir + "/depth.bin", std::ios::binary);
+                lob::write_depth_binary(f, profile);
+            } else {
+                std::ofstream f(dir + "/depth.csv");
+                lob::write_depth_csv(f, profile);
+            }
+        }
+
         std::cout << "Data dumped to " << dir << "/\n";
     }
 
     return 0;
 }
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Args args;
+    if (!parse_args(argc, argv, args)) {
+        return 1;
+    }
+
+    if (!args.itch_out.empty()) {
+        std::ofstream out(args.itch_out, std::ios::binary);
+        lob::write_itch_sample(out, args.simulate, static_cast<std::uint16_t>(std::min<std::size_t>(args.symbols, 65'535)),
+                               args.seed);
+        std::cout << "Wrote " << args.simulate << " ITCH order events over " << args.symbols << " stocks to "
+                  << args.itch_out << "\n";
+        return 0;
+    }
+
+    if (!args.fix_out.empty()) {
+        std::ofstream out(args.fix_out, std::ios::binary);
+        write_fix_orders(out, args);
+        std::cout << "Wrote " << args.simulate << " FIX orders to " << args.fix_out << "\n";
+        return 0;
+    }
+    if (!args.sbe_out.empty()) {
+        std::ofstream out(args.sbe_out, std::ios::binary);
+        write_sbe_orders(out, args);
+        std::cout << "Wrote " << args.simulate << " binary orders to " << args.sbe_out << "\n";
+        return 0;
+    }
+
+    if (!args.journal_in.empty()) {
+        return convert_journal(args);
+    }
+
+    if (!args.workload_out.empty()) {
+        std::ofstream out(args.workload_out);
+        lob::generate_workload(out, sim_config(args), args.symbols, args.scale);
+        std::cout << "Wrote " << args.simulate << " events over " << args.symbols << " symbols to "
+                  << args.workload_out << "\n";
+        return 0;
+    }
+
+    int rc = 1;
+    const auto book_impl = !args.book_impl.empty() ? args.book_impl
+                           : !args.itch_file.empty() ? "flat-list"
+                                                     : "map-deque";
+    lob::visit_book_impl(book_impl, [&](auto book) {
+        using Book = typename decltype(book)::type;
+        rc = !args.itch_file.empty()   ? run_itch<Book>(args)
+             : !args.replay_file.empty() ? run_replay<Book>(args)
+             : !args.sweep_spec.empty() ? run_sweep<Book>(args)
+             : run<Book>(args);
+    });
+    return rc;
+}
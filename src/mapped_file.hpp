@@ -0,0 +1,126 @@
+#pragma once
+/// --------------------------------------------------------
+/// MappedFile — read-only memory map of a whole file
+///
+/// mmap on POSIX, a file mapping on Windows. Where neither
+/// works (a pipe, an empty file) the file is read into an
+/// owned buffer instead, so callers always get one
+/// contiguous span.
+/// --------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace lob {
+
+class MappedFile {
+public:
+    MappedFile() = default;
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    ~MappedFile() { close(); }
+
+    /// False (with a message in error) if the file cannot be read.
+    bool open(const std::string& path, std::string& error) {
+        close();
+        if (map(path)) {
+            return true;
+        }
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            error = "cannot open " + path;
+            return false;
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        data_ = reinterpret_cast<const std::uint8_t*>(buffer_.data());
+        size_ = buffer_.size();
+        return true;
+    }
+
+    const std::uint8_t* data() const noexcept { return data_; }
+    std::size_t size() const noexcept { return size_; }
+    bool mapped() const noexcept { return mapping_ != nullptr; }
+
+    void close() noexcept {
+        if (mapping_ != nullptr) {
+#if defined(_WIN32)
+            UnmapViewOfFile(mapping_);
+#else
+            munmap(mapping_, size_);
+#endif
+            mapping_ = nullptr;
+        }
+        buffer_.clear();
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+private:
+    bool map(const std::string& path) {
+#if defined(_WIN32)
+        const HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                        FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        if (file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+        LARGE_INTEGER size{};
+        const HANDLE mapping = GetFileSizeEx(file, &size) && size.QuadPart > 0
+                                   ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr)
+                                   : nullptr;
+        CloseHandle(file);
+        if (mapping == nullptr) {
+            return false;
+        }
+        mapping_ = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+        CloseHandle(mapping);
+        size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return false;
+        }
+        struct stat st {};
+        if (fstat(fd, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) {
+            return false;
+        }
+        madvise(p, size_, MADV_SEQUENTIAL);
+        mapping_ = p;
+#endif
+        if (mapping_ == nullptr) {
+            size_ = 0;
+            return false;
+        }
+        data_ = static_cast<const std::uint8_t*>(mapping_);
+        return true;
+    }
+
+    void* mapping_ = nullptr;
+    std::vector<char> buffer_;
+    const std::uint8_t* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace lob
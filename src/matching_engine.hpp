@@ -1,36 +1,316 @@
 #pragma once
 
+#include "exec_report.hpp"
 #include "metrics.hpp"
 #include "order_book.hpp"
+#include "prefetch.hpp"
+#include "risk.hpp"
+#include "session.hpp"
+#include "throttle.hpp"
 #include "time_utils.hpp"
 
 #include <vector>
 
 namespace lob {
 
-class MatchingEngine {
+template <typename Book>
+class BasicMatchingEngine {
 public:
-    explicit MatchingEngine(LatencyStats& latency) : latency_(latency) {}
+    explicit BasicMatchingEngine(LatencyStats& latency, const SessionConfig& session = {})
+        : latency_(latency), session_(session) {}
 
-    void process(Order order, std::vector<Trade>& trades) {
+    /// Match and rest an order as the throttle, session and risk stage
+    /// allow. Rejected orders leave the book untouched; Queued orders are
+    /// processed once their throttle slot comes due.
+    RejectReason process(Order order, std::vector<Trade>& trades) {
+        if (throttle_.active()) {
+            const auto now = read_tsc();
+            if (throttle_.queued() > 0) {
+                release_throttled(now, trades);
+            }
+            switch (throttle_.admit(order, now)) {
+            case ThrottleVerdict::Admit:
+                break;
+            case ThrottleVerdict::Queue:
+                report(order, ExecType::PendingNew, RejectReason::Queued);
+                return RejectReason::Queued;
+            case ThrottleVerdict::Reject:
+                report(order, ExecType::Rejected, RejectReason::Throttled);
+                return RejectReason::Throttled;
+            }
+        }
+        return execute(std::move(order), trades);
+    }
+
+    /// Refuse an order the gateway could not accept (a duplicate or bad
+    /// client order id): only its Rejected report is written.
+    RejectReason reject(const Order& order, RejectReason reason) {
+        report(order, ExecType::Rejected, reason);
+        return reason;
+    }
+
+    /// The same for a cancel or replace request: a CancelRejected report
+    /// for order `id` (the original order, if known).
+    void reject_cancel(std::uint64_t id, RejectReason reason) {
+        if (reports_ != nullptr) {
+            cancel_rejected(id, reason);
+        }
+    }
+
+    /// Process queued messages whose throttle slot has come due.
+    std::size_t release_throttled(std::vector<Trade>& trades) {
+        return release_throttled(read_tsc(), trades);
+    }
+
+    /// Process every queued message, in order, without waiting for its
+    /// slot (at the end of a run), so each gets a terminal report.
+    std::size_t drain_throttled(std::vector<Trade>& trades) {
+        return throttle_.release_all([&](const Order& order) { execute(order, trades); });
+    }
+
+    /// Cancel a resting order, or one still held in the throttle queue.
+
+    std::int64_t cancel(std::uint64_t id) {
+        if (!session_.accepts_cancels()) {
+            if (reports_ != nullptr) {
+                cancel_rejected(id, RejectReason::Closed);
+            }
+            return 0;
+        }
         const auto start = now_ns();
+        Order removed;
+        const auto rested = book_.cancel(id, removed);
+        if (rested && risk_.active()) {
+            risk_.on_cancel(removed);
+        }
+        // A queued order never reached the risk stage.
+        const auto found = rested || (throttle_.queued() > 0 && throttle_.cancel(id, removed));
+        if (reports_ != nullptr) {
+            if (found) {
+                push({0, id, 0, removed.price, removed.qty, 0, removed.cum_qty, removed.account,
+                      ExecType::Cancelled, removed.side, RejectReason::None});
+            } else {
+                cancel_rejected(id, RejectReason::None);
+            }
+        }
+        latency_.add(now_ns() - start);
+        return found ? removed.qty : 0;
+    }
 
-        book_.match(order, trades);
-        if (order.qty > 0) {
-            book_.add(std::move(order));
+    /// Cancel/replace: order `id` leaves the book and `order` (its new id,
+    /// price and total quantity) is processed in its place, with what the
+    /// original has filled carried over: order.qty is cut by it and
+    /// cum_qty starts from it. `reason` is the new order's result. False,
+    /// with a CancelRejected report and nothing changed, if `id` is not
+    /// resting (reason None) or has already filled order.qty or more
+    /// (TooLate), or the session takes no cancels (Closed).
+    bool replace(std::uint64_t id, Order order, std::vector<Trade>& trades, RejectReason& reason) {
+        Order original;
+        if (!session_.accepts_cancels() || !book_.find(id, original) || order.qty <= original.cum_qty) {
+            reason = !session_.accepts_cancels() ? RejectReason::Closed
+                     : original.id == id         ? RejectReason::TooLate
+                                                 : RejectReason::None;
+            if (reports_ != nullptr) {
+                cancel_rejected(id, reason);
+            }
+            return false;
         }
+        cancel(id);
+        order.qty -= original.cum_qty;
+        order.cum_qty = original.cum_qty;
+        reason = process(std::move(order), trades);
+        return true;
+    }
 
-        const auto end = now_ns();
-        latency_.add(end - start);
+    /// Start a call auction: orders rest without matching until uncross().
+    void begin_auction() {
+        session_.start_auction();
     }
 
-    const OrderBook& book() const {
+    /// Execute the auction at its equilibrium price (ties broken towards
+    /// the session reference) and resume continuous matching from it.
+    AuctionResult uncross(std::vector<Trade>& trades) {
+        const auto first = trades.size();
+        const auto result = book_.uncross(trades, session_.reference_price());
+        if (risk_.active()) {
+            for (auto i = first; i < trades.size(); ++i) {
+                risk_.on_trade(trades[i], Side::Buy, true);
+            }
+        }
+        if (reports_ != nullptr) {
+            for (auto i = first; i < trades.size(); ++i) {
+                report_fills(trades[i], Side::Buy);
+            }
+        }
+        session_.open(result.crossed ? result.price : 0);
+        return result;
+    }
+
+    bool in_auction() const {
+        return session_.state() == SessionState::Auction || session_.state() == SessionState::PreOpen;
+    }
+
+    const TradingSession& session() const {
+        return session_;
+    }
+
+    TradingSession& session() {
+        return session_;
+    }
+
+    /// Configure rates here; unconfigured, the throttle is skipped.
+    Throttle& throttle() {
+        return throttle_;
+    }
+
+    const Throttle& throttle() const {
+        return throttle_;
+    }
+
+    /// Configure accounts here; with none the risk stage is skipped.
+    PreTradeRisk& risk() {
+        return risk_;
+    }
+
+    const PreTradeRisk& risk() const {
+        return risk_;
+    }
+
+    const Book& book() const {
         return book_;
     }
 
+    /// Cache hints for interleaving many engines (group_match.hpp):
+    /// prefetch_state() pulls in the engine and book headers; once those
+    /// have arrived, prefetch_levels(order) the book lines the order
+    /// (or a cancel of order.id) touches.
+    void prefetch_state() const noexcept {
+        prefetch_range(this, sizeof(*this));
+    }
+
+    void prefetch_levels(const Order& order) const noexcept {
+        book_.prefetch(order);
+    }
+
+    /// Write execution reports for every order event into `reports`
+    /// (nullptr to stop). The caller drains the buffer between messages.
+    void attach_reports(ExecReportBuffer* reports) {
+        reports_ = reports;
+    }
+
 private:
-    OrderBook book_;
+    RejectReason execute(Order order, std::vector<Trade>& trades) {
+        const auto start = now_ns();
+
+        auto reject = session_.check(order);
+        if (reject == RejectReason::None && !Book::fits(order)) {
+            reject = RejectReason::OutOfRange;
+        }
+        if (reject == RejectReason::None && risk_.active()) {
+            reject = risk_.check(order, book_.best_bid(), book_.best_ask());
+        }
+        if (reject != RejectReason::None) {
+            report(order, ExecType::Rejected, reject);
+        } else {
+            report(order, ExecType::New, RejectReason::None);
+            bool halted = false;
+            if (session_.matching()) {
+                // Trade no further than the circuit breaker allows: an order
+                // that would go past it stops there and halts the session.
+                const auto first = trades.size();
+                const auto limit = order.price;
+                order.price = session_.trade_limit(order.side, limit);
+                book_.match(order, trades);
+                const bool capped = order.price != limit;
+                order.price = limit;
+                if (trades.size() != first) {
+                    session_.on_trade(trades.back().price);
+                    if (risk_.active()) {
+                        for (auto i = first; i < trades.size(); ++i) {
+                            risk_.on_trade(trades[i], order.side, false);
+                        }
+                    }
+                    if (reports_ != nullptr) {
+                        for (auto i = first; i < trades.size(); ++i) {
+                            report_fills(trades[i], order.side);
+                        }
+                    }
+                }
+                if (capped && order.qty > 0 && crosses(order)) {
+                    session_.halt();
+                }
+                halted = session_.state() == SessionState::Halted;
+            }
+            if (order.qty > 0) {
+                if (halted) {
+                    // Not rested into a halted (and possibly crossed) book.
+                    if (reports_ != nullptr) {
+                        push({0, order.id, 0, order.price, order.qty, 0, order.cum_qty, order.account,
+                              ExecType::Cancelled, order.side, RejectReason::Halted});
+                    }
+                } else {
+                    if (risk_.active()) {
+                        risk_.on_rest(order);
+                    }
+                    book_.add(std::move(order));
+                }
+            }
+        }
+
+        const auto end = now_ns();
+        latency_.add(end - start);
+        return reject;
+    }
+
+    /// Whether the order's limit reaches the best opposite price.
+    bool crosses(const Order& order) const {
+        if (order.side == Side::Buy) {
+            const auto ask = book_.best_ask();
+            return ask != 0 && ask <= order.price;
+        }
+        const auto bid = book_.best_bid();
+        return bid != 0 && bid >= order.price;
+    }
+
+    std::size_t release_throttled(std::uint64_t now, std::vector<Trade>& trades) {
+        return throttle_.release_due(now, [&](const Order& order) { execute(order, trades); });
+    }
+
+    void push(ExecReport r) {
+        r.exec_id = ++exec_seq_;
+        reports_->push(r);
+    }
+
+    /// Order-level report: New, Rejected or PendingNew.
+    void report(const Order& order, ExecType type, RejectReason reason) {
+        if (reports_ != nullptr) {
+            const auto leaves = type == ExecType::Rejected ? 0 : order.qty;
+            push({0, order.id, 0, order.price, 0, leaves, order.cum_qty, order.account, type, order.side, reason});
+        }
+    }
+
+    void cancel_rejected(std::uint64_t id, RejectReason reason) {
+        push({0, id, 0, 0, 0, 0, 0, 0, ExecType::CancelRejected, Side::Buy, reason});
+    }
+
+    /// One report per side of a trade, taker first.
+    void report_fills(const Trade& t, Side taker_side) {
+        const auto maker_side = taker_side == Side::Buy ? Side::Sell : Side::Buy;
+        push({0, t.taker_id, t.maker_id, t.price, t.qty, t.taker_leaves, t.taker_cum, t.taker_account,
+              t.taker_leaves == 0 ? ExecType::Fill : ExecType::PartialFill, taker_side, RejectReason::None});
+        push({0, t.maker_id, t.taker_id, t.price, t.qty, t.maker_leaves, t.maker_cum, t.maker_account,
+              t.maker_leaves == 0 ? ExecType::Fill : ExecType::PartialFill, maker_side, RejectReason::None});
+    }
+
+    Book book_;
     LatencyStats& latency_;
+    TradingSession session_;
+    PreTradeRisk risk_;
+    Throttle throttle_;
+    ExecReportBuffer* reports_ = nullptr;
+    std::uint64_t exec_seq_ = 0;
 };
 
+using MatchingEngine = BasicMatchingEngine<OrderBook>;
+
 } // namespace lob
@@ -8,6 +8,16 @@
 
 namespace lob {
 
+struct LatencySummary {
+    std::size_t count = 0;
+    std::uint64_t min = 0;
+    std::uint64_t avg = 0;
+    std::uint64_t p50 = 0;
+    std::uint64_t p90 = 0;
+    std::uint64_t p99 = 0;
+    std::uint64_t max = 0;
+};
+
 class LatencyStats {
 public:
     void reserve(std::size_t count) {
@@ -36,26 +46,38 @@ public:
         }
     }
 
-    void report(std::ostream& os) const {
+    LatencySummary summary() const {
+        LatencySummary s;
         if (samples_.empty()) {
-            os << "Latency: no samples\n";
-            return;
+            return s;
         }
 
         auto sorted = samples_;
         std::sort(sorted.begin(), sorted.end());
 
-        const auto p50 = percentile(sorted, 0.50);
-        const auto p90 = percentile(sorted, 0.90);
-        const auto p99 = percentile(sorted, 0.99);
-        const auto avg = static_cast<long double>(sum_) / static_cast<long double>(samples_.size());
+        s.count = samples_.size();
+        s.min = min_;
+        s.avg = static_cast<std::uint64_t>(sum_ / static_cast<long double>(samples_.size()));
+        s.p50 = percentile(sorted, 0.50);
+        s.p90 = percentile(sorted, 0.90);
+        s.p99 = percentile(sorted, 0.99);
+        s.max = max_;
+        return s;
+    }
+
+    void report(std::ostream& os) const {
+        if (samples_.empty()) {
+            os << "Latency: no samples\n";
+            return;
+        }
 
-        os << "Latency (ns): min=" << min_
-           << " avg=" << static_cast<std::uint64_t>(avg)
-           << " p50=" << p50
-           << " p90=" << p90
-           << " p99=" << p99
-           << " max=" << max_ << "\n";
+        const auto s = summary();
+        os << "Latency (ns): min=" << s.min
+           << " avg=" << s.avg
+           << " p50=" << s.p50
+           << " p90=" << s.p90
+           << " p99=" << s.p99
+           << " max=" << s.max << "\n";
     }
 
 private:
@@ -0,0 +1,201 @@
+#pragma once
+/// --------------------------------------------------------
+/// MulticastRing<T> — single-producer, multi-consumer
+/// sequenced ring (disruptor style)
+///
+/// • One power-of-two slot array shared by every consumer:
+///   an event is written once and read in place by all
+/// • The producer publishes a sequence number; each consumer
+///   keeps its own cursor (one cache line each)
+/// • A consumer reads up to the minimum of what it is gated
+///   on: the producer, or the consumers named at
+///   registration (e.g. market data after the journal)
+/// • The producer waits for the slowest consumer to free a
+///   slot before reusing it
+/// • Batching on both sides: a claim may cover many slots,
+///   and a poll hands over everything available with one
+///   cursor store
+///
+/// Consumers are registered before publishing starts; each
+/// is polled from one thread. Waiting spins briefly, then
+/// yields, so oversubscribed cores still make progress.
+/// --------------------------------------------------------
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+namespace lob {
+
+namespace detail {
+
+inline void cpu_relax() noexcept {
+#if defined(_MSC_VER) || defined(__x86_64__) || defined(__i386__)
+    _mm_pause();
+#endif
+}
+
+/// Spin a little, then give the core away.
+struct Backoff {
+    unsigned spins = 0;
+
+    void wait() noexcept {
+        if (++spins < 64) {
+            cpu_relax();
+        } else {
+            std::this_thread::yield();
+        }
+    }
+};
+
+} // namespace detail
+
+template <typename T>
+class MulticastRing {
+public:
+    using sequence = std::int64_t;
+
+    explicit MulticastRing(std::size_t capacity) {
+        std::size_t size = 2;
+        while (size < capacity) {
+            size *= 2;
+        }
+        slots_ = std::make_unique<T[]>(size);
+        mask_ = size - 1;
+    }
+
+    std::size_t capacity() const noexcept { return mask_ + 1; }
+
+    /// Register a consumer reading after the consumers in `after` (none:
+    /// straight after the producer). Returns its id.
+    std::size_t add_consumer(std::initializer_list<std::size_t> after = {}) {
+        auto consumer = std::make_unique<Consumer>();
+        if (after.size() == 0) {
+            consumer->gates.push_back(&published_);
+        }
+        for (const auto upstream : after) {
+            consumer->gates.push_back(&consumers_.at(upstream)->cursor);
+        }
+        consumers_.push_back(std::move(consumer));
+        return consumers_.size() - 1;
+    }
+
+    std::size_t consumers() const noexcept { return consumers_.size(); }
+
+    // ---- producer ----
+
+    /// Claim n (<= capacity) consecutive slots, waiting for consumers to
+    /// free them. Returns the first sequence; fill with operator[] and
+    /// publish(first + n - 1).
+    sequence claim(std::size_t n = 1) {
+        const auto first = next_;
+        next_ += static_cast<sequence>(n);
+        const auto wrap = next_ - 1 - static_cast<sequence>(capacity());
+        if (wrap > gate_cache_) {
+            detail::Backoff backoff;
+            while ((gate_cache_ = slowest_consumer()) < wrap) {
+                backoff.wait();
+            }
+        }
+        return first;
+    }
+
+    T& operator[](sequence seq) noexcept { return slots_[static_cast<std::size_t>(seq) & mask_]; }
+
+    /// Make every claimed sequence up to `last` visible to consumers.
+    void publish(sequence last) noexcept { published_.value.store(last, std::memory_order_release); }
+
+    /// Copy n events in and publish them, in capacity-sized chunks.
+    void publish(const T* events, std::size_t n) {
+        while (n > 0) {
+            const auto chunk = std::min(n, capacity());
+            const auto first = claim(chunk);
+            for (std::size_t i = 0; i < chunk; ++i) {
+                (*this)[first + static_cast<sequence>(i)] = events[i];
+            }
+            publish(first + static_cast<sequence>(chunk) - 1);
+            events += chunk;
+            n -= chunk;
+        }
+    }
+
+    /// Last published sequence (-1 before the first).
+    sequence published() const noexcept { return published_.value.load(std::memory_order_acquire); }
+
+    // ---- consumers ----
+
+    /// Hand every event available to consumer `id` to fn(event, seq), in
+    /// order, then release them. Returns the number handled (0 if none
+    /// were ready; does not wait).
+    template <typename Fn>
+    std::size_t poll(std::size_t id, Fn&& fn) {
+        auto& c = *consumers_[id];
+        const auto from = c.cursor.value.load(std::memory_order_relaxed) + 1;
+        if (c.available < from) {
+            c.available = gate_of(c);
+            if (c.available < from) {
+                return 0;
+            }
+        }
+        const auto to = c.available;
+        for (auto seq = from; seq <= to; ++seq) {
+            fn(static_cast<const T&>((*this)[seq]), seq);
+        }
+        c.cursor.value.store(to, std::memory_order_release);
+        return static_cast<std::size_t>(to - from + 1);
+    }
+
+    /// Last sequence consumer `id` has released.
+    sequence cursor(std::size_t id) const noexcept {
+        return consumers_[id]->cursor.value.load(std::memory_order_acquire);
+    }
+
+private:
+    struct alignas(64) Sequence {
+        std::atomic<sequence> value{-1};
+    };
+
+    struct alignas(64) Consumer {
+        Sequence cursor;
+        std::vector<const Sequence*> gates;
+        sequence available = -1; // cached minimum of the gates
+    };
+
+    static sequence gate_of(const Consumer& c) noexcept {
+        auto lowest = std::numeric_limits<sequence>::max();
+        for (const auto* gate : c.gates) {
+            lowest = std::min(lowest, gate->value.load(std::memory_order_acquire));
+        }
+        return lowest;
+    }
+
+    sequence slowest_consumer() const noexcept {
+        auto lowest = next_ - 1;
+        for (const auto& c : consumers_) {
+            lowest = std::min(lowest, c->cursor.value.load(std::memory_order_acquire));
+        }
+        return lowest;
+    }
+
+    std::unique_ptr<T[]> slots_;
+    std::size_t mask_ = 0;
+    Sequence published_;
+    // Producer-only state, kept off the published_ line.
+    alignas(64) sequence next_ = 0;
+    sequence gate_cache_ = -1;
+    std::vector<std::unique_ptr<Consumer>> consumers_;
+};
+
+} // namespace lob
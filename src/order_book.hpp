@@ -1,36 +1,764 @@
 #pragma once
 
+#include "allocation.hpp"
+#include "auction.hpp"
+#include "csv_writer.hpp"
+#include "depth_profile.hpp"
+#include "level_index.hpp"
+#include "order_id_map.hpp"
+#include "order_queue.hpp"
+#include "order_storage.hpp"
+#include "queue_position.hpp"
 #include "types.hpp"
 
-#include <deque>
-#include <functional>
-#include <map>
+#include <algorithm>
+#include <bit>
 #include <ostream>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace lob {
 
-class OrderBook {
+/// Aggregates of one price level, maintained incrementally.
+struct LevelStats {
+    std::int64_t qty = 0;
+    std::size_t orders = 0;
+    std::uint64_t oldest_ts_ns = 0; // arrival time of the order at the front
+
+    double avg_size() const noexcept {
+        return orders > 0 ? static_cast<double>(qty) / static_cast<double>(orders) : 0.0;
+    }
+};
+
+/// Aggregates of one side of the book, maintained incrementally.
+struct SideStats {
+    std::int64_t qty = 0;
+    std::size_t orders = 0;
+    std::size_t levels = 0;
+};
+
+/// Opt-in book features. Derive and override to enable; the defaults
+/// cost nothing on the matching path.
+struct BookOptions {
+    /// Maintain a per-level Fenwick tree for O(log n) queue_position().
+    static constexpr bool track_queue_positions = false;
+
+    /// How a level is shared when an incoming order cannot clear it
+    /// (see allocation.hpp).
+    using allocation = FifoAllocation;
+
+    /// Resting order record (see order_storage.hpp).
+    using storage = WideStorage;
+};
+
+struct TrackQueuePositions : BookOptions {
+    static constexpr bool track_queue_positions = true;
+};
+
+struct ProRataOptions : BookOptions {
+    using allocation = ProRataAllocation;
+};
+
+struct TopOrderProRataOptions : BookOptions {
+    using allocation = TopOrderProRataAllocation;
+};
+
+struct CompactOptions : BookOptions {
+    using storage = CompactStorage;
+};
+
+/// Limit order book parameterised by how price levels are indexed
+/// (see level_index.hpp), how orders queue within a level
+/// (see order_queue.hpp) and which optional features are on.
+template <typename LevelPolicy, typename QueuePolicy, typename Options = BookOptions>
+class BasicOrderBook {
 public:
+    static constexpr bool kTrackPositions = Options::track_queue_positions;
+    using allocation_policy = typename Options::allocation;
+    using storage_policy = typename Options::storage;
+
+    using stored_type = std::conditional_t<kTrackPositions, Positioned<typename storage_policy::order_type>,
+                                           typename storage_policy::order_type>;
+    using queue_type = typename QueuePolicy::template queue<stored_type>;
+    using pool_type = typename QueuePolicy::template pool<stored_type>;
+
+    struct NoPositions {};
+
+    struct PriceLevel {
+        queue_type orders;
+        std::int64_t total_qty = 0;
+        std::size_t order_count = 0;
+        std::uint64_t oldest_ts_ns = 0;
+        [[no_unique_address]] std::conditional_t<kTrackPositions, SlotFenwick, NoPositions> positions;
+
+        friend void swap(PriceLevel& a, PriceLevel& b) noexcept {
+            using std::swap;
+            swap(a.orders, b.orders);
+            swap(a.total_qty, b.total_qty);
+            swap(a.order_count, b.order_count);
+            swap(a.oldest_ts_ns, b.oldest_ts_ns);
+            swap(a.positions, b.positions);
+        }
+    };
+
+    /// Whether the book's storage can hold the order (always, unless
+    /// compact). add() and match() expect orders that fit.
+    static constexpr bool fits(const Order& order) noexcept { return storage_policy::fits(order); }
+
     void add(const Order& order);
     void add(Order&& order);
 
     void match(Order& incoming, std::vector<Trade>& trades);
 
+    /// Hint the lines match() and add() touch first for this order: the
+    /// best levels, its own price level where that is found without a
+    /// search, and its id slot. Worth it once the book object itself is
+    /// in cache (see group_match.hpp).
+    void prefetch(const Order& order) const noexcept {
+        bids_.prefetch(order.price);
+        asks_.prefetch(order.price);
+        ids_.prefetch(order.id);
+    }
+
+    /// Hint the id slot of a resting order: the first miss of a by-id
+    /// update such as cancel() or reduce() (see book_builder.hpp).
+    void prefetch_id(std::uint64_t id) const noexcept { ids_.prefetch(id); }
+
+    /// Hint the next misses of a by-id update: the order's queue node
+    /// (node-based queues only) and its side's levels. Probes the id map,
+    /// so it pays off once prefetch_id() has landed.
+    void prefetch_resting(std::uint64_t id) const noexcept {
+        const auto* loc = ids_.find(id);
+        if (loc == nullptr) {
+            return;
+        }
+        if constexpr (std::is_pointer_v<typename queue_type::handle>) {
+            lob::prefetch(loc->handle);
+        }
+        if (loc->side == Side::Buy) {
+            bids_.prefetch(loc->price);
+        } else {
+            asks_.prefetch(loc->price);
+        }
+    }
+
+    /// Equilibrium of a crossed book (see auction.hpp); not crossed if the
+    /// book is not. O(crossed levels).
+    AuctionResult indicative_uncross(std::int64_t reference = 0) const;
+
+    /// Execute the call auction: every trade prints at the equilibrium
+    /// price, bids and asks each filled in price-time priority. Trades
+    /// carry the buy order as taker_id and the sell order as maker_id.
+    AuctionResult uncross(std::vector<Trade>& trades, std::int64_t reference = 0);
+
+    /// Remove a resting order. Returns the quantity cancelled, or 0 if the
+    /// id is not resting in the book.
+    std::int64_t cancel(std::uint64_t id);
+
+    /// As cancel(id), also returning the removed order (qty is what was
+    /// left resting). False if the id is not resting in the book.
+    bool cancel(std::uint64_t id, Order& removed);
+
+    /// Copy of a resting order (qty is what is still open). False if the
+    /// id is not resting in the book.
+    bool find(std::uint64_t id, Order& out) const;
+
+    /// Whether the id is resting in the book (an id map probe only).
+    bool contains(std::uint64_t id) const noexcept { return ids_.find(id) != nullptr; }
+
+    /// Take qty off a resting order in place, keeping its time priority;
+    /// it leaves the book once nothing is left. Returns the quantity
+    /// removed (capped at what was resting; 0 if the id is not resting).
+    std::int64_t reduce(std::uint64_t id, std::int64_t qty);
+
     std::int64_t best_bid() const;
     std::int64_t best_ask() const;
 
+    LevelStats level_stats(Side side, std::int64_t price) const;
+    LevelStats top_stats(Side side) const;
+    SideStats side_stats(Side side) const;
+
+    /// Top-of-book quantity imbalance (bid - ask) / (bid + ask), in [-1, 1].
+    double imbalance() const;
+
+    /// Quantity and orders ahead of a resting order at its price. O(log n)
+    /// with track_queue_positions, otherwise a walk of the level.
+    QueuePosition queue_position(std::uint64_t id) const;
+
+    /// Liquidity a taker on `side` can reach at prices up to `limit`, and
+    /// the cost of filling `size` of it (for FOK and risk checks).
+    Liquidity liquidity(Side side, std::int64_t limit, std::int64_t size) const;
+
+    /// Cumulative depth per side, bucketed into bins of bin_ticks.
+    DepthProfile depth_profile(std::int64_t bin_ticks = 1) const;
+
     void dump(std::ostream& os, std::size_t depth = 10) const;
     void dump_csv(std::ostream& os) const;
 
 private:
-    struct PriceLevel {
-        std::deque<Order> orders;
-        std::int64_t total_qty = 0;
+    struct OrderLocation {
+        Side side = Side::Buy;
+        std::int64_t price = 0;
+        typename queue_type::handle handle{};
+        std::uint32_t slot = 0;
     };
 
-    std::map<std::int64_t, PriceLevel, std::greater<>> bids_;
-    std::map<std::int64_t, PriceLevel, std::less<>> asks_;
+    struct SideTotals {
+        std::int64_t qty = 0;
+        std::size_t orders = 0;
+    };
+
+    template <Side S>
+    auto& levels() noexcept {
+        if constexpr (S == Side::Buy) {
+            return bids_;
+        } else {
+            return asks_;
+        }
+    }
+
+    template <Side S>
+    SideTotals& totals() noexcept {
+        return S == Side::Buy ? bid_totals_ : ask_totals_;
+    }
+
+    template <Side S>
+    void insert(Order&& order);
+
+    template <Side S>
+    void match_side(Order& incoming, std::vector<Trade>& trades);
+
+    /// Maker side of one fill.
+    struct Fill {
+        std::uint64_t id = 0;
+        std::int64_t leaves = 0;
+        std::int64_t cum = 0;
+        std::uint32_t account = 0;
+    };
+
+    template <Side S>
+    Fill fill_front(PriceLevel& level, std::int64_t qty);
+
+    template <Side S>
+    void settle(std::int64_t price, PriceLevel& level);
+
+    template <Side S>
+    void allocate_level(PriceLevel& level, std::int64_t price, Order& incoming, std::vector<Trade>& trades);
+
+    template <Side S>
+    Order remove(const OrderLocation& loc, std::uint64_t id);
+
+    template <Side S>
+    std::int64_t reduce_resting(const OrderLocation& loc, std::uint64_t id, std::int64_t qty);
+
+    void repack_positions(PriceLevel& level);
+
+    static LevelStats stats_of(const PriceLevel& level) noexcept {
+        return {level.total_qty, level.order_count, level.oldest_ts_ns};
+    }
+
+    pool_type pool_;
+    typename LevelPolicy::template index<PriceLevel, Side::Buy> bids_;
+    typename LevelPolicy::template index<PriceLevel, Side::Sell> asks_;
+    SideTotals bid_totals_;
+    SideTotals ask_totals_;
+    OrderIdMap<OrderLocation> ids_;
+    std::vector<std::int64_t> resting_scratch_; // pro-rata only
+    std::vector<std::int64_t> fill_scratch_;
 };
 
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::add(const Order& order) {
+    add(Order{order});
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::add(Order&& order) {
+    if (order.side == Side::Buy) {
+        insert<Side::Buy>(std::move(order));
+    } else {
+        insert<Side::Sell>(std::move(order));
+    }
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+template <Side S>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::insert(Order&& order) {
+    auto& side = levels<S>();
+    const auto id = order.id;
+    const auto price = order.price;
+    const auto qty = order.qty;
+
+    auto& level = side.at(price);
+    if (level.order_count == 0) {
+        level.oldest_ts_ns = order.ts_ns;
+    }
+    stored_type stored{storage_policy::pack(std::move(order))};
+    std::uint32_t slot = 0;
+    if constexpr (kTrackPositions) {
+        if (level.positions.full()) {
+            repack_positions(level);
+        }
+        slot = stored.slot = level.positions.push(qty);
+    }
+    level.total_qty += qty;
+    ++level.order_count;
+    const auto handle = level.orders.push_back(std::move(stored), pool_);
+    side.sync(price, level);
+
+    auto& totals = this->totals<S>();
+    totals.qty += qty;
+    ++totals.orders;
+    ids_.insert(id, {S, price, handle, slot});
+}
+
+/// Re-number a level's live orders from slot 0 in a tree with room to grow.
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::repack_positions(PriceLevel& level) {
+    if constexpr (kTrackPositions) {
+        level.positions.reset(std::max(SlotFenwick::kMinSlots, std::bit_ceil(2 * (level.order_count + 1))));
+        level.orders.for_each([&](stored_type& o) {
+            o.slot = level.positions.push(o.qty);
+            ids_.find(o.id)->slot = o.slot;
+            return true;
+        });
+    }
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::match(Order& incoming, std::vector<Trade>& trades) {
+    if (incoming.qty <= 0) {
+        return;
+    }
+
+    if (incoming.side == Side::Buy) {
+        match_side<Side::Sell>(incoming, trades);
+    } else {
+        match_side<Side::Buy>(incoming, trades);
+    }
+}
+
+/// Match against resting side S.
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+template <Side S>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::match_side(Order& incoming, std::vector<Trade>& trades) {
+    auto& side = levels<S>();
+    while (incoming.qty > 0 && !side.empty()) {
+        const auto price = side.best_price();
+        if (is_better<S>(incoming.price, price)) {
+            break;
+        }
+
+        auto& level = side.best();
+        if constexpr (allocation_policy::pro_rata) {
+            if (incoming.qty < level.total_qty) {
+                allocate_level<S>(level, price, incoming, trades);
+                settle<S>(price, level);
+                break;
+            }
+        }
+        while (incoming.qty > 0 && !level.orders.empty()) {
+            const auto exec_qty = std::min<std::int64_t>(incoming.qty, level.orders.front().qty);
+            incoming.qty -= exec_qty;
+            incoming.cum_qty += exec_qty;
+            const auto maker = fill_front<S>(level, exec_qty);
+            trades.push_back({incoming.id, maker.id, price, exec_qty, incoming.qty, maker.leaves,
+                              incoming.cum_qty, maker.cum, incoming.account, maker.account});
+        }
+        settle<S>(price, level);
+    }
+}
+
+/// Fill qty (at most the front order's) from the front of a level of side
+/// S; the order leaves the book once empty.
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+template <Side S>
+auto BasicOrderBook<LevelPolicy, QueuePolicy, Options>::fill_front(PriceLevel& level, std::int64_t qty) -> Fill {
+    auto& maker = level.orders.front();
+    auto& totals = this->totals<S>();
+    const Fill fill{maker.id, maker.qty - qty, maker.cum_qty + qty, maker.account};
+
+    maker.qty -= qty;
+    maker.cum_qty += qty;
+    level.total_qty -= qty;
+    totals.qty -= qty;
+    if constexpr (kTrackPositions) {
+        level.positions.add(maker.slot, -qty, maker.qty == 0 ? -1 : 0);
+    }
+
+    if (maker.qty == 0) {
+        ids_.erase(fill.id);
+        level.orders.pop_front(pool_);
+        --level.order_count;
+        --totals.orders;
+    }
+    return fill;
+}
+
+/// Bring the best level of side S back in line after fills from its front.
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+template <Side S>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::settle(std::int64_t price, PriceLevel& level) {
+    if (level.orders.empty()) {
+        levels<S>().pop_best();
+    } else {
+        level.oldest_ts_ns = level.orders.front().ts_ns;
+        levels<S>().sync(price, level);
+    }
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+AuctionResult BasicOrderBook<LevelPolicy, QueuePolicy, Options>::indicative_uncross(std::int64_t reference) const {
+    if (bids_.empty() || asks_.empty() || bids_.best_price() < asks_.best_price()) {
+        return {};
+    }
+    const auto best_bid = bids_.best_price();
+    const auto best_ask = asks_.best_price();
+
+    std::vector<AuctionLevel> bids;
+    std::vector<AuctionLevel> asks;
+    bids_.for_each([&](std::int64_t price, const PriceLevel& level) {
+        if (price < best_ask) {
+            return false;
+        }
+        bids.push_back({price, level.total_qty});
+        return true;
+    });
+    asks_.for_each([&](std::int64_t price, const PriceLevel& level) {
+        if (price > best_bid) {
+            return false;
+        }
+        asks.push_back({price, level.total_qty});
+        return true;
+    });
+    return find_equilibrium(bids, asks, reference);
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+AuctionResult BasicOrderBook<LevelPolicy, QueuePolicy, Options>::uncross(std::vector<Trade>& trades,
+                                                                         std::int64_t reference) {
+    const auto result = indicative_uncross(reference);
+    auto remaining = result.volume;
+    while (remaining > 0) {
+        const auto bid_price = bids_.best_price();
+        const auto ask_price = asks_.best_price();
+        auto& bid = bids_.best();
+        auto& ask = asks_.best();
+
+        const auto qty = std::min<std::int64_t>({remaining, bid.orders.front().qty, ask.orders.front().qty});
+        const auto buy = fill_front<Side::Buy>(bid, qty);
+        const auto sell = fill_front<Side::Sell>(ask, qty);
+        trades.push_back({buy.id, sell.id, result.price, qty, buy.leaves, sell.leaves, buy.cum, sell.cum,
+                          buy.account, sell.account});
+        remaining -= qty;
+
+        settle<Side::Buy>(bid_price, bid);
+        settle<Side::Sell>(ask_price, ask);
+    }
+    return result;
+}
+
+/// Share incoming.qty (less than the level's total) across the level with
+/// the pro-rata policy; one trade per maker that receives a fill, in
+/// queue order. Makers filled completely leave the level.
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+template <Side S>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::allocate_level(
+    PriceLevel& level, std::int64_t price, Order& incoming, std::vector<Trade>& trades) {
+    resting_scratch_.clear();
+    level.orders.for_each([&](const stored_type& o) {
+        resting_scratch_.push_back(o.qty);
+        return true;
+    });
+    fill_scratch_.resize(resting_scratch_.size());
+    allocate_pro_rata<allocation_policy>(resting_scratch_.data(), resting_scratch_.size(), incoming.qty,
+                                         fill_scratch_.data());
+
+    std::int64_t filled = 0;
+    std::size_t done = 0;
+    std::size_t i = 0;
+    level.orders.for_each([&](stored_type& maker) {
+        const auto exec_qty = fill_scratch_[i++];
+        if (exec_qty > 0) {
+            maker.qty -= exec_qty;
+            maker.cum_qty += exec_qty;
+            filled += exec_qty;
+            done += maker.qty == 0;
+            if constexpr (kTrackPositions) {
+                level.positions.add(maker.slot, -exec_qty, maker.qty == 0 ? -1 : 0);
+            }
+            trades.push_back({incoming.id, maker.id, price, exec_qty, incoming.qty - filled, maker.qty,
+                              incoming.cum_qty + filled, maker.cum_qty, incoming.account, maker.account});
+        }
+        return true;
+    });
+
+    incoming.qty -= filled;
+    incoming.cum_qty += filled;
+    level.total_qty -= filled;
+    auto& totals = this->totals<S>();
+    totals.qty -= filled;
+    if (done > 0) {
+        level.orders.remove_if([this](const stored_type& o) {
+            if (o.qty != 0) {
+                return false;
+            }
+            ids_.erase(o.id);
+            return true;
+        }, pool_);
+        level.order_count -= done;
+        totals.orders -= done;
+    }
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+std::int64_t BasicOrderBook<LevelPolicy, QueuePolicy, Options>::cancel(std::uint64_t id) {
+    Order removed;
+    return cancel(id, removed) ? removed.qty : 0;
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+bool BasicOrderBook<LevelPolicy, QueuePolicy, Options>::cancel(std::uint64_t id, Order& removed) {
+    const auto* found = ids_.find(id);
+    if (!found) {
+        return false;
+    }
+    const auto loc = *found;
+    ids_.erase(id);
+    removed = loc.side == Side::Buy ? remove<Side::Buy>(loc, id) : remove<Side::Sell>(loc, id);
+    return true;
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+bool BasicOrderBook<LevelPolicy, QueuePolicy, Options>::find(std::uint64_t id, Order& out) const {
+    const auto* loc = ids_.find(id);
+    if (!loc) {
+        return false;
+    }
+    const auto& level = *(loc->side == Side::Buy ? bids_.find(loc->price) : asks_.find(loc->price));
+    out = storage_policy::unpack(level.orders.find(loc->handle, id), loc->price);
+    return true;
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+std::int64_t BasicOrderBook<LevelPolicy, QueuePolicy, Options>::reduce(std::uint64_t id, std::int64_t qty) {
+    auto* found = ids_.find(id);
+    if (!found || qty <= 0) {
+        return 0;
+    }
+    const auto loc = *found;
+    if (loc.side == Side::Buy) {
+        return reduce_resting<Side::Buy>(loc, id, qty);
+    }
+    return reduce_resting<Side::Sell>(loc, id, qty);
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+template <Side S>
+std::int64_t BasicOrderBook<LevelPolicy, QueuePolicy, Options>::reduce_resting(const OrderLocation& loc,
+                                                                               std::uint64_t id, std::int64_t qty) {
+    auto& level = *levels<S>().find(loc.price);
+    auto& stored = level.orders.find(loc.handle, id);
+    if (qty >= stored.qty) {
+        ids_.erase(id);
+        return remove<S>(loc, id).qty;
+    }
+    stored.qty -= static_cast<decltype(stored.qty)>(qty);
+    level.total_qty -= qty;
+    totals<S>().qty -= qty;
+    if constexpr (kTrackPositions) {
+        level.positions.add(stored.slot, -qty, 0);
+    }
+    levels<S>().sync(loc.price, level);
+    return qty;
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+template <Side S>
+Order BasicOrderBook<LevelPolicy, QueuePolicy, Options>::remove(const OrderLocation& loc, std::uint64_t id) {
+    auto& side = levels<S>();
+    auto& level = *side.find(loc.price);
+    const bool was_front = level.orders.front().id == id;
+    const auto stored = level.orders.erase(loc.handle, id, pool_);
+    const auto order = storage_policy::unpack(stored, loc.price);
+
+    level.total_qty -= order.qty;
+    --level.order_count;
+    if constexpr (kTrackPositions) {
+        level.positions.add(stored.slot, -order.qty, -1);
+    }
+    auto& totals = this->totals<S>();
+    totals.qty -= order.qty;
+    --totals.orders;
+
+    if (level.order_count == 0) {
+        side.erase(loc.price);
+    } else {
+        if (was_front) {
+            level.oldest_ts_ns = level.orders.front().ts_ns;
+        }
+        side.sync(loc.price, level);
+    }
+    return order;
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+std::int64_t BasicOrderBook<LevelPolicy, QueuePolicy, Options>::best_bid() const {
+    if (bids_.empty()) {
+        return 0;
+    }
+    return bids_.best_price();
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+std::int64_t BasicOrderBook<LevelPolicy, QueuePolicy, Options>::best_ask() const {
+    if (asks_.empty()) {
+        return 0;
+    }
+    return asks_.best_price();
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+LevelStats BasicOrderBook<LevelPolicy, QueuePolicy, Options>::level_stats(Side side, std::int64_t price) const {
+    const auto* level = side == Side::Buy ? bids_.find(price) : asks_.find(price);
+    return level ? stats_of(*level) : LevelStats{};
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+LevelStats BasicOrderBook<LevelPolicy, QueuePolicy, Options>::top_stats(Side side) const {
+    if (side == Side::Buy) {
+        return bids_.empty() ? LevelStats{} : level_stats(side, bids_.best_price());
+    }
+    return asks_.empty() ? LevelStats{} : level_stats(side, asks_.best_price());
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+SideStats BasicOrderBook<LevelPolicy, QueuePolicy, Options>::side_stats(Side side) const {
+    if (side == Side::Buy) {
+        return {bid_totals_.qty, bid_totals_.orders, bids_.size()};
+    }
+    return {ask_totals_.qty, ask_totals_.orders, asks_.size()};
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+double BasicOrderBook<LevelPolicy, QueuePolicy, Options>::imbalance() const {
+    const auto bid = top_stats(Side::Buy).qty;
+    const auto ask = top_stats(Side::Sell).qty;
+    const auto total = bid + ask;
+    return total > 0 ? static_cast<double>(bid - ask) / static_cast<double>(total) : 0.0;
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+QueuePosition BasicOrderBook<LevelPolicy, QueuePolicy, Options>::queue_position(std::uint64_t id) const {
+    const auto* loc = ids_.find(id);
+    if (!loc) {
+        return {};
+    }
+    QueuePosition pos;
+    pos.found = true;
+    pos.side = loc->side;
+    pos.price = loc->price;
+
+    const auto& level = *(loc->side == Side::Buy ? bids_.find(loc->price) : asks_.find(loc->price));
+    if constexpr (kTrackPositions) {
+        std::int64_t orders = 0;
+        level.positions.prefix(loc->slot, pos.qty_ahead, orders);
+        pos.orders_ahead = static_cast<std::size_t>(orders);
+    } else {
+        level.orders.for_each([&](const stored_type& o) {
+            if (o.id == id) {
+                return false;
+            }
+            pos.qty_ahead += o.qty;
+            ++pos.orders_ahead;
+            return true;
+        });
+    }
+    return pos;
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+Liquidity BasicOrderBook<LevelPolicy, QueuePolicy, Options>::liquidity(
+    Side side, std::int64_t limit, std::int64_t size) const {
+    return side == Side::Buy ? asks_.liquidity(limit, size) : bids_.liquidity(limit, size);
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+DepthProfile BasicOrderBook<LevelPolicy, QueuePolicy, Options>::depth_profile(std::int64_t bin_ticks) const {
+    DepthProfile profile;
+    profile.bin_ticks = bin_ticks;
+    std::vector<std::int64_t> bins;
+
+    bids_.bin_depth(bin_ticks, bins);
+    if (!bins.empty()) {
+        append_depth_side(bins, floor_div(bids_.best_price(), bin_ticks), -1, bin_ticks, profile.bids);
+    }
+    asks_.bin_depth(bin_ticks, bins);
+    if (!bins.empty()) {
+        append_depth_side(bins, floor_div(asks_.best_price(), bin_ticks), 1, bin_ticks, profile.asks);
+    }
+    return profile;
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::dump(std::ostream& os, std::size_t depth) const {
+    os << "BIDS (price/qty)\n";
+    std::size_t count = 0;
+    bids_.for_each([&](std::int64_t price, const PriceLevel& level) {
+        os << "  " << price << " / " << level.total_qty << "\n";
+        return ++count < depth;
+    });
+
+    os << "ASKS (price/qty)\n";
+    count = 0;
+    asks_.for_each([&](std::int64_t price, const PriceLevel& level) {
+        os << "  " << price << " / " << level.total_qty << "\n";
+        return ++count < depth;
+    });
+}
+
+template <typename LevelPolicy, typename QueuePolicy, typename Options>
+void BasicOrderBook<LevelPolicy, QueuePolicy, Options>::dump_csv(std::ostream& os) const {
+    CsvWriter csv(os);
+    csv.field("side").field("price").field("total_qty").end_row();
+    bids_.for_each([&](std::int64_t price, const PriceLevel& level) {
+        csv.field("BID").field(price).field(level.total_qty).end_row();
+        return true;
+    });
+    asks_.for_each([&](std::int64_t price, const PriceLevel& level) {
+        csv.field("ASK").field(price).field(level.total_qty).end_row();
+        return true;
+    });
+}
+
+// Pre-instantiated variants (defined in order_book.cpp).
+using OrderBook                = BasicOrderBook<MapLevels, DequeOrders>;
+using MapListOrderBook         = BasicOrderBook<MapLevels, ListOrders>;
+using MapRingOrderBook         = BasicOrderBook<MapLevels, RingOrders>;
+using FlatDequeOrderBook       = BasicOrderBook<FlatLevels, DequeOrders>;
+using FlatListOrderBook        = BasicOrderBook<FlatLevels, ListOrders>;
+using FlatRingOrderBook        = BasicOrderBook<FlatLevels, RingOrders>;
+using LadderDequeOrderBook     = BasicOrderBook<LadderLevels, DequeOrders>;
+using LadderListOrderBook      = BasicOrderBook<LadderLevels, ListOrders>;
+using LadderRingOrderBook      = BasicOrderBook<LadderLevels, RingOrders>;
+using TrackedOrderBook         = BasicOrderBook<MapLevels, DequeOrders, TrackQueuePositions>;
+using ProRataOrderBook         = BasicOrderBook<MapLevels, DequeOrders, ProRataOptions>;
+using TopOrderProRataOrderBook = BasicOrderBook<MapLevels, DequeOrders, TopOrderProRataOptions>;
+using CompactOrderBook         = BasicOrderBook<MapLevels, DequeOrders, CompactOptions>;
+
+extern template class BasicOrderBook<MapLevels, DequeOrders>;
+extern template class BasicOrderBook<MapLevels, ListOrders>;
+extern template class BasicOrderBook<MapLevels, RingOrders>;
+extern template class BasicOrderBook<FlatLevels, DequeOrders>;
+extern template class BasicOrderBook<FlatLevels, ListOrders>;
+extern template class BasicOrderBook<FlatLevels, RingOrders>;
+extern template class BasicOrderBook<LadderLevels, DequeOrders>;
+extern template class BasicOrderBook<LadderLevels, ListOrders>;
+extern template class BasicOrderBook<LadderLevels, RingOrders>;
+extern template class BasicOrderBook<MapLevels, DequeOrders, TrackQueuePositions>;
+extern template class BasicOrderBook<MapLevels, DequeOrders, ProRataOptions>;
+extern template class BasicOrderBook<MapLevels, DequeOrders, TopOrderProRataOptions>;
+extern template class BasicOrderBook<MapLevels, DequeOrders, CompactOptions>;
+
 } // namespace lob
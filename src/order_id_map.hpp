@@ -0,0 +1,141 @@
+#pragma once
+/// --------------------------------------------------------
+/// OrderIdMap<V> — open-addressing map keyed by order id
+///
+/// • Linear probing over a power-of-two slot array
+/// • Fibonacci hashing of the 64-bit id
+/// • Backward-shift deletion (no tombstones)
+/// • Grows at 50% load; never shrinks
+///
+/// The id ~0 is reserved as the empty-slot marker.
+/// --------------------------------------------------------
+
+#include "prefetch.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+template <typename V>
+class OrderIdMap {
+public:
+    explicit OrderIdMap(std::size_t capacity = 1024) {
+        rehash(round_up(capacity));
+    }
+
+    V* find(std::uint64_t key) noexcept {
+        for (auto i = home(key);; i = (i + 1) & mask_) {
+            if (slots_[i].key == kEmpty) {
+                return nullptr;
+            }
+            if (slots_[i].key == key) {
+                return &slots_[i].value;
+            }
+        }
+    }
+
+    const V* find(std::uint64_t key) const noexcept {
+        return const_cast<OrderIdMap*>(this)->find(key);
+    }
+
+    /// Hint the home slot of key (where find or insert starts).
+    void prefetch(std::uint64_t key) const noexcept {
+        lob::prefetch(&slots_[home(key)]);
+    }
+
+    /// Insert or overwrite.
+    V& insert(std::uint64_t key, V value) {
+        if ((size_ + 1) * 2 > slots_.size()) {
+            rehash(slots_.size() * 2);
+        }
+        auto i = home(key);
+        for (; slots_[i].key != kEmpty; i = (i + 1) & mask_) {
+            if (slots_[i].key == key) {
+                slots_[i].value = std::move(value);
+                return slots_[i].value;
+            }
+        }
+        slots_[i].key = key;
+        slots_[i].value = std::move(value);
+        ++size_;
+        return slots_[i].value;
+    }
+
+    bool erase(std::uint64_t key) noexcept {
+        auto i = home(key);
+        for (;; i = (i + 1) & mask_) {
+            if (slots_[i].key == kEmpty) {
+                return false;
+            }
+            if (slots_[i].key == key) {
+                break;
+            }
+        }
+        // Pull later members of the probe run back into the hole.
+        for (auto j = (i + 1) & mask_; slots_[j].key != kEmpty; j = (j + 1) & mask_) {
+            const auto h = home(slots_[j].key);
+            if (((j - h) & mask_) >= ((j - i) & mask_)) {
+                slots_[i] = std::move(slots_[j]);
+                i = j;
+            }
+        }
+        slots_[i].key = kEmpty;
+        --size_;
+        return true;
+    }
+
+    void reserve(std::size_t count) {
+        if (count * 2 > slots_.size()) {
+            rehash(round_up(count * 2));
+        }
+    }
+
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+private:
+    static constexpr std::uint64_t kEmpty = ~std::uint64_t{0};
+
+    struct Slot {
+        std::uint64_t key = kEmpty;
+        V value{};
+    };
+
+    static std::size_t round_up(std::size_t n) {
+        std::size_t cap = 16;
+        while (cap < n) {
+            cap *= 2;
+        }
+        return cap;
+    }
+
+    std::size_t home(std::uint64_t key) const noexcept {
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> shift_);
+    }
+
+    void rehash(std::size_t capacity) {
+        auto old = std::move(slots_);
+        slots_.assign(capacity, Slot{});
+        mask_ = capacity - 1;
+        shift_ = 64;
+        for (auto c = capacity; c > 1; c >>= 1) {
+            --shift_;
+        }
+        size_ = 0;
+        for (auto& slot : old) {
+            if (slot.key != kEmpty) {
+                insert(slot.key, std::move(slot.value));
+            }
+        }
+    }
+
+    std::vector<Slot> slots_;
+    std::size_t mask_ = 0;
+    unsigned shift_ = 64;
+    std::size_t size_ = 0;
+};
+
+} // namespace lob
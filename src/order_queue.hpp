@@ -0,0 +1,337 @@
+#pragma once
+/// --------------------------------------------------------
+/// Per-price-level FIFO queue policies
+///
+/// A queue policy exposes two member templates:
+///   queue<T> — the FIFO container stored in each price level
+///   pool<T>  — book-wide storage shared by every queue
+///
+/// Mutating calls take the pool so node-based queues can
+/// allocate from it; the other policies ignore it.
+///
+/// push_back returns a handle that erase() and find() use to
+/// reach the element again: a node pointer for the list,
+/// nothing for the contiguous queues (which search by T::id).
+/// remove_if(pred) drops matching elements, keeping the
+/// order of the rest.
+/// for_each(fn) visits elements front to back until fn
+/// returns false. swap() exchanges storage without
+/// allocating, so emptied levels can be recycled.
+///
+/// • DequeOrders — std::deque, the original layout
+/// • ListOrders  — IntrusiveList over pooled nodes
+/// • RingOrders  — power-of-two circular buffer
+/// --------------------------------------------------------
+
+#include "intrusive_list.hpp"
+#include "memory_pool.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace lob {
+
+/// Placeholder pool for queues that own their storage.
+struct NoPool {};
+
+/// Placeholder handle for queues that erase by searching.
+struct NoHandle {};
+
+template <typename T>
+class DequeQueue {
+public:
+    using handle = NoHandle;
+
+    handle push_back(T&& value, NoPool&) {
+        items_.push_back(std::move(value));
+        return {};
+    }
+
+    void pop_front(NoPool&) {
+        items_.pop_front();
+    }
+
+    /// Remove and return the element with the given id (must be present).
+    T erase(handle, std::uint64_t id, NoPool&) {
+        auto it = std::find_if(items_.begin(), items_.end(), [id](const T& v) { return v.id == id; });
+        T value = std::move(*it);
+        items_.erase(it);
+        return value;
+    }
+
+    /// The element with the given id (must be present), in place.
+    T& find(handle, std::uint64_t id) {
+        return *std::find_if(items_.begin(), items_.end(), [id](const T& v) { return v.id == id; });
+    }
+
+    const T& find(handle, std::uint64_t id) const {
+        return *std::find_if(items_.begin(), items_.end(), [id](const T& v) { return v.id == id; });
+    }
+
+    /// Remove every element matching pred, keeping the order of the rest.
+    template <typename Pred>
+    std::size_t remove_if(Pred&& pred, NoPool&) {
+        const auto it = std::remove_if(items_.begin(), items_.end(), pred);
+        const auto removed = static_cast<std::size_t>(items_.end() - it);
+        items_.erase(it, items_.end());
+        return removed;
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (auto& v : items_) {
+            if (!fn(v)) {
+                return;
+            }
+        }
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto& v : items_) {
+            if (!fn(v)) {
+                return;
+            }
+        }
+    }
+
+    T&          front() noexcept { return items_.front(); }
+    const T&    front() const noexcept { return items_.front(); }
+    bool        empty() const noexcept { return items_.empty(); }
+    std::size_t size()  const noexcept { return items_.size(); }
+
+    friend void swap(DequeQueue& a, DequeQueue& b) noexcept {
+        a.items_.swap(b.items_);
+    }
+
+private:
+    std::deque<T> items_;
+};
+
+template <typename T>
+struct ListNode {
+    T value{};
+    ListNode* next = nullptr;
+    ListNode* prev = nullptr;
+};
+
+template <typename T>
+class ListQueue {
+public:
+    using node_type = ListNode<T>;
+    using pool_type = ObjectPool<node_type>;
+    using handle = node_type*;
+
+    handle push_back(T&& value, pool_type& pool) {
+        auto* node = pool.allocate();
+        node->value = std::move(value);
+        list_.push_back(node);
+        return node;
+    }
+
+    void pop_front(pool_type& pool) {
+        pool.deallocate(list_.pop_front());
+    }
+
+    /// O(1) unlink through the node handle.
+    T erase(handle node, std::uint64_t, pool_type& pool) {
+        list_.remove(node);
+        T value = std::move(node->value);
+        pool.deallocate(node);
+        return value;
+    }
+
+    T& find(handle node, std::uint64_t) noexcept {
+        return node->value;
+    }
+
+    const T& find(handle node, std::uint64_t) const noexcept {
+        return node->value;
+    }
+
+    template <typename Pred>
+    std::size_t remove_if(Pred&& pred, pool_type& pool) {
+        std::size_t removed = 0;
+        for (auto* node = list_.front(); node;) {
+            auto* next = node->next;
+            if (pred(node->value)) {
+                list_.remove(node);
+                pool.deallocate(node);
+                ++removed;
+            }
+            node = next;
+        }
+        return removed;
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (auto* node = list_.front(); node; node = node->next) {
+            if (!fn(node->value)) {
+                return;
+            }
+        }
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (const auto* node = list_.front(); node; node = node->next) {
+            if (!fn(node->value)) {
+                return;
+            }
+        }
+    }
+
+    T&          front() noexcept { return list_.front()->value; }
+    const T&    front() const noexcept { return list_.front()->value; }
+    bool        empty() const noexcept { return list_.empty(); }
+    std::size_t size()  const noexcept { return list_.size(); }
+
+    friend void swap(ListQueue& a, ListQueue& b) noexcept {
+        auto tmp = std::move(a.list_);
+        a.list_ = std::move(b.list_);
+        b.list_ = std::move(tmp);
+    }
+
+private:
+    IntrusiveList<node_type> list_;
+};
+
+template <typename T>
+class RingQueue {
+public:
+    using handle = NoHandle;
+
+    handle push_back(T&& value, NoPool&) {
+        if (size_ == slots_.size()) {
+            grow();
+        }
+        slots_[(head_ + size_) & mask_] = std::move(value);
+        ++size_;
+        return {};
+    }
+
+    void pop_front(NoPool&) noexcept {
+        head_ = (head_ + 1) & mask_;
+        --size_;
+    }
+
+    /// Remove and return the element with the given id (must be present);
+    /// later elements shift forward one slot.
+    T erase(handle, std::uint64_t id, NoPool&) {
+        std::size_t i = 0;
+        while (slots_[(head_ + i) & mask_].id != id) {
+            ++i;
+        }
+        T value = std::move(slots_[(head_ + i) & mask_]);
+        for (; i + 1 < size_; ++i) {
+            slots_[(head_ + i) & mask_] = std::move(slots_[(head_ + i + 1) & mask_]);
+        }
+        --size_;
+        return value;
+    }
+
+    T& find(handle, std::uint64_t id) {
+        std::size_t i = 0;
+        while (slots_[(head_ + i) & mask_].id != id) {
+            ++i;
+        }
+        return slots_[(head_ + i) & mask_];
+    }
+
+    const T& find(handle, std::uint64_t id) const {
+        std::size_t i = 0;
+        while (slots_[(head_ + i) & mask_].id != id) {
+            ++i;
+        }
+        return slots_[(head_ + i) & mask_];
+    }
+
+    template <typename Pred>
+    std::size_t remove_if(Pred&& pred, NoPool&) {
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < size_; ++i) {
+            auto& v = slots_[(head_ + i) & mask_];
+            if (pred(v)) {
+                continue;
+            }
+            if (kept != i) {
+                slots_[(head_ + kept) & mask_] = std::move(v);
+            }
+            ++kept;
+        }
+        const auto removed = size_ - kept;
+        size_ = kept;
+        return removed;
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) {
+        for (std::size_t i = 0; i < size_; ++i) {
+            if (!fn(slots_[(head_ + i) & mask_])) {
+                return;
+            }
+        }
+    }
+
+    template <typename Fn>
+    void for_each(Fn&& fn) const {
+        for (std::size_t i = 0; i < size_; ++i) {
+            if (!fn(slots_[(head_ + i) & mask_])) {
+                return;
+            }
+        }
+    }
+
+    T&          front() noexcept { return slots_[head_]; }
+    const T&    front() const noexcept { return slots_[head_]; }
+    bool        empty() const noexcept { return size_ == 0; }
+    std::size_t size()  const noexcept { return size_; }
+
+    friend void swap(RingQueue& a, RingQueue& b) noexcept {
+        a.slots_.swap(b.slots_);
+        std::swap(a.head_, b.head_);
+        std::swap(a.size_, b.size_);
+        std::swap(a.mask_, b.mask_);
+    }
+
+private:
+    static constexpr std::size_t kInitialCapacity = 8;
+
+    void grow() {
+        const auto capacity = slots_.empty() ? kInitialCapacity : slots_.size() * 2;
+        std::vector<T> next(capacity);
+        for (std::size_t i = 0; i < size_; ++i) {
+            next[i] = std::move(slots_[(head_ + i) & mask_]);
+        }
+        slots_ = std::move(next);
+        head_ = 0;
+        mask_ = capacity - 1;
+    }
+
+    std::vector<T> slots_;
+    std::size_t head_ = 0;
+    std::size_t size_ = 0;
+    std::size_t mask_ = 0;
+};
+
+struct DequeOrders {
+    template <typename T> using queue = DequeQueue<T>;
+    template <typename T> using pool = NoPool;
+};
+
+struct ListOrders {
+    template <typename T> using queue = ListQueue<T>;
+    template <typename T> using pool = ObjectPool<ListNode<T>>;
+};
+
+struct RingOrders {
+    template <typename T> using queue = RingQueue<T>;
+    template <typename T> using pool = NoPool;
+};
+
+} // namespace lob
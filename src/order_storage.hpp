@@ -0,0 +1,64 @@
+#pragma once
+/// --------------------------------------------------------
+/// How a book stores its resting orders
+///
+/// WideStorage    — the Order itself (48 bytes)
+/// CompactStorage — CompactOrder (32 bytes): 32-bit qty and
+///                  cum qty, no price (a resting order's price
+///                  is its level's)
+///
+/// Orders are converted at the book boundary: pack() on the
+/// way in, unpack() (with the level price) on the way out.
+/// fits() is the overflow check; the engine rejects an order
+/// that does not fit before it reaches the book. Everything
+/// the book emits (Trade, Order, stats) stays 64-bit.
+/// --------------------------------------------------------
+
+#include "types.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+namespace lob {
+
+struct WideStorage {
+    using order_type = Order;
+
+    static constexpr bool fits(const Order&) noexcept { return true; }
+    static Order pack(Order&& order) noexcept { return std::move(order); }
+    static Order unpack(const Order& stored, std::int64_t) noexcept { return stored; }
+};
+
+struct CompactOrder {
+    std::uint64_t id = 0;
+    std::uint64_t ts_ns = 0;
+    std::int32_t qty = 0;
+    std::int32_t cum_qty = 0;
+    std::uint32_t account = 0;
+    Side side = Side::Buy;
+};
+
+static_assert(sizeof(CompactOrder) == 32, "two resting orders per cache line");
+
+struct CompactStorage {
+    using order_type = CompactOrder;
+
+    /// Original quantity (open plus filled) within 32 bits, so neither
+    /// qty nor cum_qty can overflow while the order rests.
+    static constexpr bool fits(const Order& order) noexcept {
+        constexpr std::int64_t kMax = std::numeric_limits<std::int32_t>::max();
+        return order.qty >= 0 && order.cum_qty >= 0 && order.qty <= kMax - order.cum_qty;
+    }
+
+    static CompactOrder pack(const Order& order) noexcept {
+        return {order.id, order.ts_ns, static_cast<std::int32_t>(order.qty), static_cast<std::int32_t>(order.cum_qty),
+                order.account, order.side};
+    }
+
+    static Order unpack(const CompactOrder& stored, std::int64_t price) noexcept {
+        return {stored.id, stored.side, stored.account, price, stored.qty, stored.ts_ns, stored.cum_qty};
+    }
+};
+
+} // namespace lob
@@ -0,0 +1,223 @@
+#pragma once
+/// --------------------------------------------------------
+/// Order-entry pipeline as coroutine stages
+///
+///   parse -> risk -> match -> publish
+///
+/// Each stage is a coroutine on one Scheduler, linked by
+/// bounded Channels, so the whole pipeline runs on the
+/// calling thread with no cross-thread handoff:
+/// • parse reads the input in 64 KiB chunks and yields after
+///   each one, so a slow read never holds up matching of
+///   what is already parsed
+/// • risk runs the stateless checks (book price range);
+///   checks that read the book or positions stay in the
+///   engine, at match time, where they see the book the order
+///   will meet
+/// • match feeds the engine and forwards trades
+/// • publish writes trades as CSV, flushing in 64 KiB chunks
+///
+/// Input lines, ids assigned 1, 2, ... in line order:
+///   B|S PRICE QTY     new order
+///   C ID              cancel
+/// --------------------------------------------------------
+
+#include "coro.hpp"
+#include "csv_writer.hpp"
+#include "matching_engine.hpp"
+#include "price.hpp"
+#include "replay.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+namespace lob {
+
+struct PipelineMessage {
+    Order order; // for a cancel, order.id is the id to cancel
+    bool cancel = false;
+};
+
+struct PipelineStats {
+    std::size_t messages = 0;
+    std::size_t malformed = 0; // lines skipped
+    std::size_t rejected = 0;
+    std::size_t trades = 0;
+};
+
+/// One input line; false if malformed. `id` becomes the order id.
+inline bool parse_message(std::string_view line, const PriceScale& scale, std::uint64_t id, PipelineMessage& msg) {
+    const auto kind = detail::next_field(line);
+    msg = {};
+    if (kind == "C") {
+        msg.cancel = true;
+        return detail::parse_uint(detail::next_field(line), msg.order.id);
+    }
+    if (kind != "B" && kind != "S") {
+        return false;
+    }
+    std::uint64_t qty = 0;
+    msg.order.id = id;
+    msg.order.side = kind == "B" ? Side::Buy : Side::Sell;
+    if (scale.parse(detail::next_field(line), msg.order.price) != PriceError::None ||
+        !detail::parse_uint(detail::next_field(line), qty) || qty == 0) {
+        return false;
+    }
+    msg.order.qty = static_cast<std::int64_t>(qty);
+    msg.order.ts_ns = now_ns();
+    return true;
+}
+
+/// Reads a stream a chunk at a time and hands out its lines.
+class ChunkedLineReader {
+public:
+    explicit ChunkedLineReader(std::istream& in, std::size_t chunk = 1 << 16) : in_(in), buf_(chunk) {}
+
+    /// Read the next chunk (keeping any partial line); false once the
+    /// input is exhausted and every line handed out.
+    bool fill() {
+        if (eof_) {
+            return false;
+        }
+        const auto rest = len_ - pos_;
+        std::memmove(buf_.data(), buf_.data() + pos_, rest);
+        pos_ = 0;
+        len_ = rest;
+        if (len_ == buf_.size()) {
+            buf_.resize(buf_.size() * 2); // a line longer than a chunk
+        }
+        in_.read(buf_.data() + len_, static_cast<std::streamsize>(buf_.size() - len_));
+        const auto got = static_cast<std::size_t>(in_.gcount());
+        len_ += got;
+        eof_ = got == 0;
+        return !eof_ || len_ > 0;
+    }
+
+    /// Next complete line of the chunk (without the newline); after the
+    /// last chunk, also the unterminated last line. False when none.
+    bool next_line(std::string_view& line) {
+        if (pos_ == len_) {
+            return false;
+        }
+        const auto* begin = buf_.data() + pos_;
+        const auto* nl = static_cast<const char*>(std::memchr(begin, '\n', len_ - pos_));
+        if (nl == nullptr) {
+            if (!eof_) {
+                return false;
+            }
+            line = {begin, len_ - pos_};
+            pos_ = len_;
+            return true;
+        }
+        line = {begin, static_cast<std::size_t>(nl - begin)};
+        pos_ = static_cast<std::size_t>(nl - buf_.data()) + 1;
+        return true;
+    }
+
+private:
+    std::istream& in_;
+    std::vector<char> buf_;
+    std::size_t pos_ = 0;
+    std::size_t len_ = 0;
+    bool eof_ = false;
+};
+
+namespace detail {
+
+inline bool blank(std::string_view line) noexcept {
+    return line.find_first_not_of(" \t\r") == std::string_view::npos;
+}
+
+inline Task parse_stage(Scheduler& scheduler, std::istream& in, const PriceScale& scale,
+                        Channel<PipelineMessage>& out, PipelineStats& stats) {
+    ChunkedLineReader reader(in);
+    std::uint64_t lines = 0;
+    PipelineMessage msg;
+    std::string_view line;
+    while (reader.fill()) {
+        while (reader.next_line(line)) {
+            if (blank(line)) {
+                continue;
+            }
+            if (!parse_message(line, scale, ++lines, msg)) {
+                ++stats.malformed;
+                continue;
+            }
+            ++stats.messages;
+            co_await out.push(msg);
+        }
+        co_await scheduler.yield();
+    }
+    out.close();
+}
+
+template <typename Book>
+Task risk_stage(Channel<PipelineMessage>& in, Channel<PipelineMessage>& out, PipelineStats& stats) {
+    PipelineMessage msg;
+    while (co_await in.pop(msg)) {
+        if (!msg.cancel && !Book::fits(msg.order)) {
+            ++stats.rejected;
+            continue;
+        }
+        co_await out.push(msg);
+    }
+    out.close();
+}
+
+template <typename Book>
+Task match_stage(BasicMatchingEngine<Book>& engine, Channel<PipelineMessage>& in, Channel<Trade>& out,
+                 PipelineStats& stats) {
+    std::vector<Trade> trades;
+    trades.reserve(64);
+    PipelineMessage msg;
+    while (co_await in.pop(msg)) {
+        if (msg.cancel) {
+            engine.cancel(msg.order.id);
+            continue;
+        }
+        if (engine.process(msg.order, trades) != RejectReason::None) {
+            ++stats.rejected;
+        }
+        for (const auto& t : trades) {
+            co_await out.push(t);
+        }
+        trades.clear();
+    }
+    out.close();
+}
+
+inline Task publish_stage(Channel<Trade>& in, std::ostream& os, PipelineStats& stats) {
+    CsvWriter csv(os);
+    csv.field("taker_id").field("maker_id").field("price").field("qty").end_row();
+    Trade t;
+    while (co_await in.pop(t)) {
+        csv.field(t.taker_id).field(t.maker_id).field(t.price).field(t.qty).end_row();
+        ++stats.trades;
+    }
+}
+
+} // namespace detail
+
+/// Run `in` through engine, writing trades to `out`. Returns when the
+/// input is exhausted and every trade written.
+template <typename Book>
+PipelineStats run_pipeline(BasicMatchingEngine<Book>& engine, std::istream& in, std::ostream& out,
+                           const PriceScale& scale, std::size_t capacity = 1024) {
+    PipelineStats stats;
+    Scheduler scheduler;
+    Channel<PipelineMessage> parsed(scheduler, capacity);
+    Channel<PipelineMessage> checked(scheduler, capacity);
+    Channel<Trade> trades(scheduler, capacity);
+    scheduler.spawn(detail::parse_stage(scheduler, in, scale, parsed, stats));
+    scheduler.spawn(detail::risk_stage<Book>(parsed, checked, stats));
+    scheduler.spawn(detail::match_stage(engine, checked, trades, stats));
+    scheduler.spawn(detail::publish_stage(trades, out, stats));
+    scheduler.run();
+    return stats;
+}
+
+} // namespace lob
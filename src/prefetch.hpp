@@ -0,0 +1,38 @@
+#pragma once
+/// --------------------------------------------------------
+/// Software prefetch hints
+///
+/// Read prefetches into all cache levels. Only hints: a
+/// prefetch of a line that is never used costs a fill,
+/// never correctness.
+/// --------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace lob {
+
+inline constexpr std::size_t kCacheLine = 64;
+
+inline void prefetch(const void* p) noexcept {
+#if defined(_MSC_VER)
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    __builtin_prefetch(p, 0, 3);
+#endif
+}
+
+/// Every cache line of [p, p + bytes).
+inline void prefetch_range(const void* p, std::size_t bytes) noexcept {
+    const auto first = reinterpret_cast<std::uintptr_t>(p) & ~(kCacheLine - 1);
+    const auto end = reinterpret_cast<std::uintptr_t>(p) + bytes;
+    for (auto line = first; line < end; line += kCacheLine) {
+        prefetch(reinterpret_cast<const void*>(line));
+    }
+}
+
+} // namespace lob
@@ -0,0 +1,187 @@
+#pragma once
+/// --------------------------------------------------------
+/// PriceScale — exact decimal prices <-> tick numbers
+///
+/// An instrument quotes prices with `decimals` digits after
+/// the point, in steps of `tick` units of 10^-decimals (a
+/// 0.05 tick is decimals 2, tick 5). The book only sees
+/// tick numbers, price / tick size, so every instrument's
+/// prices are consecutive integers and the dense ladder is
+/// as compact for a 0.25 tick as for a 0.01 one.
+///
+/// Parsing and formatting are integer-only: no double on
+/// the way in or out, and a price that is not a whole
+/// number of ticks is rejected rather than rounded.
+/// --------------------------------------------------------
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+namespace lob {
+
+enum class PriceError : std::uint8_t { None, Malformed, TooPrecise, OffTick, Overflow };
+
+inline const char* to_string(PriceError error) {
+    switch (error) {
+    case PriceError::None:       return "ok";
+    case PriceError::Malformed:  return "not a decimal number";
+    case PriceError::TooPrecise: return "more decimals than the instrument quotes";
+    case PriceError::OffTick:    return "not a multiple of the tick size";
+    case PriceError::Overflow:   return "out of range";
+    }
+    return "?";
+}
+
+class PriceScale {
+public:
+    static constexpr unsigned kMaxDecimals = 18;
+    static constexpr std::size_t kMaxChars = 24; // longest format() output
+
+    /// Cents by default: two decimals, one-cent tick.
+    constexpr PriceScale() noexcept = default;
+
+    constexpr PriceScale(unsigned decimals, std::int64_t tick) noexcept
+        : decimals_(decimals), tick_(tick), unit_(pow10(decimals)) {}
+
+    /// Scale from a tick size literal: "0.01", "0.05", "0.25", "1".
+    static bool from_tick_size(std::string_view text, PriceScale& out) noexcept {
+        const auto point = text.find('.');
+        const auto decimals = point == std::string_view::npos ? 0 : text.size() - point - 1;
+        if (decimals > kMaxDecimals) {
+            return false;
+        }
+        std::int64_t units = 0;
+        if (parse_units(text, static_cast<unsigned>(decimals), units) != PriceError::None || units <= 0) {
+            return false;
+        }
+        out = PriceScale(static_cast<unsigned>(decimals), units);
+        return true;
+    }
+
+    unsigned decimals() const noexcept { return decimals_; }
+    std::int64_t tick() const noexcept { return tick_; }
+
+    /// Decimal text to a tick number.
+    PriceError parse(std::string_view text, std::int64_t& ticks) const noexcept {
+        std::int64_t units = 0;
+        const auto error = parse_units(text, decimals_, units);
+        if (error != PriceError::None) {
+            return error;
+        }
+        if (!on_tick(units)) {
+            return PriceError::OffTick;
+        }
+        ticks = units / tick_;
+        return PriceError::None;
+    }
+
+    /// Price in units of 10^-decimals is a whole number of ticks.
+    bool on_tick(std::int64_t units) const noexcept { return units % tick_ == 0; }
+
+    /// Write ticks as decimal text (always `decimals` digits after the
+    /// point) into out, which needs kMaxChars bytes. Returns the length.
+    std::size_t format(std::int64_t ticks, char* out) const noexcept {
+        // |ticks * tick| can exceed int64; the unsigned magnitude cannot
+        // for any tick a caller could parse.
+        const bool negative = ticks < 0;
+        const auto magnitude = (negative ? 0 - static_cast<std::uint64_t>(ticks) : static_cast<std::uint64_t>(ticks)) *
+                               static_cast<std::uint64_t>(tick_);
+        const auto unit = static_cast<std::uint64_t>(unit_);
+        auto whole = magnitude / unit;
+        auto frac = magnitude % unit;
+
+        char digits[kMaxChars];
+        std::size_t n = 0;
+        for (unsigned d = 0; d < decimals_; ++d) {
+            digits[n++] = static_cast<char>('0' + frac % 10);
+            frac /= 10;
+        }
+        if (decimals_ > 0) {
+            digits[n++] = '.';
+        }
+        do {
+            digits[n++] = static_cast<char>('0' + whole % 10);
+            whole /= 10;
+        } while (whole > 0);
+
+        std::size_t len = 0;
+        if (negative) {
+            out[len++] = '-';
+        }
+        while (n > 0) {
+            out[len++] = digits[--n];
+        }
+        return len;
+    }
+
+    std::string to_string(std::int64_t ticks) const {
+        char buf[kMaxChars];
+        return {buf, format(ticks, buf)};
+    }
+
+private:
+    static constexpr std::int64_t pow10(unsigned n) noexcept {
+        std::int64_t p = 1;
+        while (n-- > 0) {
+            p *= 10;
+        }
+        return p;
+    }
+
+    /// [-]digits[.digits] to units of 10^-decimals. Extra decimals are
+    /// accepted only if they are zeros.
+    static PriceError parse_units(std::string_view text, unsigned decimals, std::int64_t& units) noexcept {
+        constexpr auto kMax = std::numeric_limits<std::int64_t>::max();
+        std::size_t i = 0;
+        const bool negative = !text.empty() && text[0] == '-';
+        i += negative;
+
+        std::int64_t value = 0;
+        std::size_t digits = 0;
+        unsigned frac_digits = 0;
+        bool point = false;
+        for (; i < text.size(); ++i) {
+            const char c = text[i];
+            if (c == '.' && !point) {
+                point = true;
+                continue;
+            }
+            if (c < '0' || c > '9') {
+                return PriceError::Malformed;
+            }
+            ++digits;
+            if (point && frac_digits == decimals) {
+                if (c != '0') {
+                    return PriceError::TooPrecise;
+                }
+                continue;
+            }
+            frac_digits += point;
+            const auto d = c - '0';
+            if (value > (kMax - d) / 10) {
+                return PriceError::Overflow;
+            }
+            value = value * 10 + d;
+        }
+        if (digits == 0) {
+            return PriceError::Malformed;
+        }
+        for (; frac_digits < decimals; ++frac_digits) {
+            if (value > kMax / 10) {
+                return PriceError::Overflow;
+            }
+            value *= 10;
+        }
+        units = negative ? -value : value;
+        return PriceError::None;
+    }
+
+    unsigned decimals_ = 2;
+    std::int64_t tick_ = 1;
+    std::int64_t unit_ = 100;
+};
+
+} // namespace lob
@@ -0,0 +1,87 @@
+#pragma once
+/// --------------------------------------------------------
+/// Queue-position tracking for resting orders
+///
+/// Each order takes the next arrival slot at its level. A
+/// Fenwick tree over the slots holds (remaining qty, 1) per
+/// live order, so the quantity and order count ahead of any
+/// slot is one O(log n) prefix query. Fills and cancels are
+/// point updates. When the slots run out the level re-packs
+/// its live orders into a fresh tree (amortised O(log n)).
+///
+/// Enabled per book through BookOptions::track_queue_positions;
+/// untracked books answer the same query with a level walk.
+/// --------------------------------------------------------
+
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lob {
+
+/// Where a resting order stands in its price level's FIFO queue.
+struct QueuePosition {
+    bool found = false;
+    Side side = Side::Buy;
+    std::int64_t price = 0;
+    std::int64_t qty_ahead = 0;
+    std::size_t orders_ahead = 0;
+};
+
+/// Order record as stored by a position-tracking book.
+template <typename Stored>
+struct Positioned : Stored {
+    std::uint32_t slot = 0;
+};
+
+using PositionedOrder = Positioned<Order>;
+
+class SlotFenwick {
+public:
+    static constexpr std::size_t kMinSlots = 16;
+
+    bool full() const noexcept { return next_ + 1 >= tree_.size(); }
+
+    /// Drop all slots and size the tree for `slots` arrivals.
+    void reset(std::size_t slots) {
+        tree_.assign(slots + 1, Node{});
+        next_ = 0;
+    }
+
+    /// Assign the next arrival slot to an order of `qty`.
+    std::uint32_t push(std::int64_t qty) noexcept {
+        const auto slot = next_++;
+        add(slot, qty, 1);
+        return slot;
+    }
+
+    void add(std::uint32_t slot, std::int64_t qty, std::int64_t count) noexcept {
+        for (auto i = static_cast<std::size_t>(slot) + 1; i < tree_.size(); i += i & (~i + 1)) {
+            tree_[i].qty += qty;
+            tree_[i].count += count;
+        }
+    }
+
+    /// Sum over the slots strictly before `slot`.
+    void prefix(std::uint32_t slot, std::int64_t& qty, std::int64_t& count) const noexcept {
+        qty = 0;
+        count = 0;
+        for (auto i = static_cast<std::size_t>(slot); i > 0; i -= i & (~i + 1)) {
+            qty += tree_[i].qty;
+            count += tree_[i].count;
+        }
+    }
+
+private:
+    struct Node {
+        std::int64_t qty = 0;
+        std::int64_t count = 0;
+    };
+
+    std::vector<Node> tree_;   // 1-based
+    std::uint32_t next_ = 0;
+};
+
+} // namespace lob
@@ -0,0 +1,244 @@
+#pragma once
+/// --------------------------------------------------------
+/// Parallel replay of a multi-symbol workload
+///
+/// Workload file, one event per line, in time order:
+///   TS SYMBOL SIDE PRICE QTY     new order
+///   TS SYMBOL C ID               cancel
+/// Ids are assigned 1, 2, ... in line order, as for --stdin.
+///
+/// Each symbol's book is independent, so the workload is
+/// partitioned by symbol and every partition replayed
+/// through its own engine, largest first, on a
+/// WorkStealingPool. A symbol's trades depend only on its
+/// own events, so they are the same for any thread count;
+/// merge_by_time() interleaves them by (ts, symbol, order)
+/// into one deterministic stream.
+/// --------------------------------------------------------
+
+#include "matching_engine.hpp"
+#include "price.hpp"
+#include "sim.hpp"
+#include "work_stealing.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <istream>
+#include <numeric>
+#include <ostream>
+#include <queue>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace lob {
+
+struct ReplayEvent {
+    std::uint64_t ts = 0;
+    bool cancel = false;
+    Order order; // for a cancel, order.id is the id to cancel
+};
+
+struct Workload {
+    std::vector<std::string> symbols;
+    std::vector<std::vector<ReplayEvent>> events; // per symbol, in time order
+    std::size_t total = 0;
+};
+
+struct SymbolTrade {
+    std::uint64_t ts = 0;
+    std::uint32_t symbol = 0;
+    Trade trade;
+};
+
+namespace detail {
+
+inline std::string_view next_field(std::string_view& line) {
+    const auto start = line.find_first_not_of(" \t\r");
+    if (start == std::string_view::npos) {
+        line = {};
+        return {};
+    }
+    line.remove_prefix(start);
+    const auto end = std::min(line.find_first_of(" \t\r"), line.size());
+    const auto field = line.substr(0, end);
+    line.remove_prefix(end);
+    return field;
+}
+
+inline bool parse_uint(std::string_view text, std::uint64_t& value) {
+    if (text.empty()) {
+        return false;
+    }
+    value = 0;
+    for (const char c : text) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+        value = value * 10 + static_cast<std::uint64_t>(c - '0');
+    }
+    return true;
+}
+
+} // namespace detail
+
+/// False (with a message naming the line) on a malformed event.
+inline bool read_workload(std::istream& in, const PriceScale& scale, Workload& out, std::string& error) {
+    std::unordered_map<std::string, std::uint32_t> index;
+    std::string line;
+    std::size_t line_no = 0;
+    while (std::getline(in, line)) {
+        ++line_no;
+        std::string_view rest = line;
+        const auto ts_text = detail::next_field(rest);
+        if (ts_text.empty()) {
+            continue;
+        }
+        const auto symbol = detail::next_field(rest);
+        const auto kind = detail::next_field(rest);
+
+        ReplayEvent event;
+        std::uint64_t value = 0;
+        bool ok = detail::parse_uint(ts_text, event.ts) && !symbol.empty();
+        event.order.id = static_cast<std::uint64_t>(out.total + 1);
+        event.order.ts_ns = event.ts;
+        if (ok && kind == "C") {
+            event.cancel = true;
+            ok = detail::parse_uint(detail::next_field(rest), event.order.id);
+        } else if (ok && (kind == "B" || kind == "S")) {
+            event.order.side = kind == "B" ? Side::Buy : Side::Sell;
+            ok = scale.parse(detail::next_field(rest), event.order.price) == PriceError::None &&
+                 detail::parse_uint(detail::next_field(rest), value) && value > 0;
+            event.order.qty = static_cast<std::int64_t>(value);
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            error = "line " + std::to_string(line_no) + ": " + line;
+            return false;
+        }
+
+        const auto [it, added] = index.try_emplace(std::string(symbol), static_cast<std::uint32_t>(out.symbols.size()));
+        if (added) {
+            out.symbols.emplace_back(symbol);
+            out.events.emplace_back();
+        }
+        out.events[it->second].push_back(event);
+        ++out.total;
+    }
+    return true;
+}
+
+/// Synthetic workload: cfg.count events over `symbols` symbols with
+/// Zipf-like activity (symbol k gets weight 1/(k+1)), a fifth of them
+/// cancels of an earlier order of the same symbol.
+inline void generate_workload(std::ostream& out, const SimConfig& cfg, std::size_t symbols, const PriceScale& scale) {
+    std::mt19937_64 rng(cfg.seed);
+    std::vector<double> weights(std::max<std::size_t>(1, symbols));
+    for (std::size_t k = 0; k < weights.size(); ++k) {
+        weights[k] = 1.0 / static_cast<double>(k + 1);
+    }
+    std::discrete_distribution<std::size_t> pick_symbol(weights.begin(), weights.end());
+    std::uniform_int_distribution<std::int64_t> price_delta(-cfg.price_range, cfg.price_range);
+    std::uniform_int_distribution<std::int64_t> qty_dist(1, std::max<std::int64_t>(1, cfg.max_qty));
+    std::bernoulli_distribution side_dist(cfg.buy_ratio);
+    std::bernoulli_distribution cancel_dist(0.2);
+    std::vector<std::vector<std::uint64_t>> issued(weights.size());
+
+    for (std::size_t i = 0; i < cfg.count; ++i) {
+        const auto s = pick_symbol(rng);
+        out << (i + 1) * 100 << " SYM" << s << ' ';
+        auto& ids = issued[s];
+        if (!ids.empty() && cancel_dist(rng)) {
+            out << "C " << ids[std::uniform_int_distribution<std::size_t>(0, ids.size() - 1)(rng)] << '\n';
+            continue;
+        }
+        const auto price = std::max<std::int64_t>(1, cfg.base_price + price_delta(rng));
+        out << (side_dist(rng) ? 'B' : 'S') << ' ' << scale.to_string(price) << ' ' << qty_dist(rng) << '\n';
+        ids.push_back(i + 1);
+    }
+}
+
+struct ReplayResult {
+    std::vector<std::vector<SymbolTrade>> trades; // per symbol, in time order
+    double seconds = 0.0;
+    std::uint64_t steals = 0;
+};
+
+/// Replay every symbol through its own engine on `threads` workers.
+template <typename Book>
+ReplayResult replay_parallel(const Workload& workload, unsigned threads) {
+    ReplayResult result;
+    result.trades.resize(workload.symbols.size());
+
+    // Largest partitions first, so the long poles start early.
+    std::vector<std::size_t> order(workload.symbols.size());
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return workload.events[a].size() > workload.events[b].size();
+    });
+
+    WorkStealingPool pool(threads);
+    const auto start = now_ns();
+    pool.run(order, [&](std::size_t symbol, unsigned) {
+        LatencyStats latency;
+        latency.reserve(workload.events[symbol].size());
+        BasicMatchingEngine<Book> engine(latency);
+        std::vector<Trade> trades;
+        auto& out = result.trades[symbol];
+        for (const auto& event : workload.events[symbol]) {
+            if (event.cancel) {
+                engine.cancel(event.order.id);
+                continue;
+            }
+            engine.process(event.order, trades);
+            for (const auto& t : trades) {
+                out.push_back({event.ts, static_cast<std::uint32_t>(symbol), t});
+            }
+            trades.clear();
+        }
+    });
+    result.seconds = static_cast<double>(now_ns() - start) * 1e-9;
+    result.steals = pool.steals();
+    return result;
+}
+
+/// One stream ordered by (ts, symbol, position within the symbol).
+inline std::vector<SymbolTrade> merge_by_time(const std::vector<std::vector<SymbolTrade>>& by_symbol) {
+    struct Head {
+        std::uint64_t ts;
+        std::uint32_t symbol;
+        std::size_t pos;
+        bool operator>(const Head& other) const noexcept {
+            return ts != other.ts ? ts > other.ts : symbol > other.symbol;
+        }
+    };
+    std::priority_queue<Head, std::vector<Head>, std::greater<>> heads;
+    std::size_t total = 0;
+    for (std::size_t s = 0; s < by_symbol.size(); ++s) {
+        total += by_symbol[s].size();
+        if (!by_symbol[s].empty()) {
+            heads.push({by_symbol[s][0].ts, static_cast<std::uint32_t>(s), 0});
+        }
+    }
+    std::vector<SymbolTrade> merged;
+    merged.reserve(total);
+    while (!heads.empty()) {
+        auto head = heads.top();
+        heads.pop();
+        const auto& trades = by_symbol[head.symbol];
+        // Drain the run of this symbol that precedes the next head.
+        do {
+            merged.push_back(trades[head.pos++]);
+        } while (head.pos < trades.size() && trades[head.pos].ts == head.ts);
+        if (head.pos < trades.size()) {
+            head.ts = trades[head.pos].ts;
+            heads.push(head);
+        }
+    }
+    return merged;
+}
+
+} // namespace lob
@@ -0,0 +1,169 @@
+#pragma once
+/// --------------------------------------------------------
+/// Pre-trade risk checks with per-account limits
+///
+/// Accounts are dense ids indexing a flat table of one
+/// cache line each: the account's limits next to its live
+/// exposure, so a check touches a single line.
+///
+/// Checks, in order:
+///   • account known
+///   • order qty      <= max_order_qty
+///   • price * qty    <= max_notional
+///   • open orders    <  max_open_orders
+///   • worst-case position (filled position plus every open
+///     order on the order's side, plus this order) within
+///     ±max_position
+///   • fat finger: a buy priced more than max_price_distance
+///     ticks above the best ask (a sell below the best bid)
+///
+/// Exposure is updated on rest, fill and cancel by the
+/// engine. Limits default to "unlimited".
+/// --------------------------------------------------------
+
+#include "types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace lob {
+
+struct RiskLimits {
+    static constexpr std::int64_t kUnlimited = std::numeric_limits<std::int64_t>::max();
+
+    std::int64_t max_order_qty = kUnlimited;
+    std::int64_t max_notional = kUnlimited;       // ticks * qty
+    std::int64_t max_position = kUnlimited;
+    std::int64_t max_price_distance = kUnlimited; // ticks from the opposite best
+    std::uint32_t max_open_orders = std::numeric_limits<std::uint32_t>::max();
+};
+
+struct alignas(64) AccountRisk {
+    // limits
+    std::int64_t max_order_qty = RiskLimits::kUnlimited;
+    std::int64_t max_notional = RiskLimits::kUnlimited;
+    std::int64_t max_position = RiskLimits::kUnlimited;
+    std::int64_t max_price_distance = RiskLimits::kUnlimited;
+    std::uint32_t max_open_orders = 0;
+    // exposure
+    std::uint32_t open_orders = 0;
+    std::int64_t position = 0;
+    std::int64_t open_buy_qty = 0;
+    std::int64_t open_sell_qty = 0;
+};
+
+static_assert(sizeof(AccountRisk) == 64, "one account per cache line");
+
+/// price * qty > limit, without overflow.
+inline bool notional_exceeds(std::int64_t price, std::int64_t qty, std::int64_t limit) noexcept {
+#if defined(__SIZEOF_INT128__)
+    return static_cast<__int128>(price) * qty > limit;
+#else
+    return static_cast<long double>(price) * static_cast<long double>(qty) > static_cast<long double>(limit);
+#endif
+}
+
+class PreTradeRisk {
+public:
+    /// Give accounts [0, count) the same limits (exposure reset).
+    void assign(std::size_t count, const RiskLimits& limits) {
+        accounts_.assign(count, AccountRisk{});
+        for (std::size_t a = 0; a < count; ++a) {
+            set_limits(static_cast<std::uint32_t>(a), limits);
+        }
+    }
+
+    /// Set one account's limits, growing the table as needed.
+    void set_limits(std::uint32_t account, const RiskLimits& limits) {
+        if (account >= accounts_.size()) {
+            accounts_.resize(account + std::size_t{1});
+        }
+        auto& a = accounts_[account];
+        a.max_order_qty = limits.max_order_qty;
+        a.max_notional = limits.max_notional;
+        a.max_position = limits.max_position;
+        a.max_price_distance = limits.max_price_distance;
+        a.max_open_orders = limits.max_open_orders;
+    }
+
+    /// No accounts configured: the engine skips the stage entirely.
+    bool active() const noexcept { return !accounts_.empty(); }
+    std::size_t accounts() const noexcept { return accounts_.size(); }
+
+    const AccountRisk& account(std::uint32_t id) const { return accounts_[id]; }
+
+    /// best_bid / best_ask are 0 when that side is empty.
+    RejectReason check(const Order& order, std::int64_t best_bid, std::int64_t best_ask) const noexcept {
+        if (order.account >= accounts_.size()) {
+            return RejectReason::UnknownAccount;
+        }
+        const auto& a = accounts_[order.account];
+        if (order.qty > a.max_order_qty) {
+            return RejectReason::MaxOrderQty;
+        }
+        if (notional_exceeds(order.price, order.qty, a.max_notional)) {
+            return RejectReason::MaxNotional;
+        }
+        if (a.open_orders >= a.max_open_orders) {
+            return RejectReason::MaxOpenOrders;
+        }
+        if (order.side == Side::Buy) {
+            if (a.position + a.open_buy_qty + order.qty > a.max_position) {
+                return RejectReason::PositionLimit;
+            }
+            if (best_ask > 0 && order.price - best_ask > a.max_price_distance) {
+                return RejectReason::PriceDistance;
+            }
+        } else {
+            if (a.open_sell_qty + order.qty - a.position > a.max_position) {
+                return RejectReason::PositionLimit;
+            }
+            if (best_bid > 0 && best_bid - order.price > a.max_price_distance) {
+                return RejectReason::PriceDistance;
+            }
+        }
+        return RejectReason::None;
+    }
+
+    /// An accepted order's remainder rests in the book.
+    void on_rest(const Order& order) noexcept {
+        auto& a = accounts_[order.account];
+        ++a.open_orders;
+        open_qty(a, order.side) += order.qty;
+    }
+
+    /// A resting order left the book by cancel (qty is what it had left).
+    void on_cancel(const Order& order) noexcept {
+        auto& a = accounts_[order.account];
+        --a.open_orders;
+        open_qty(a, order.side) -= order.qty;
+    }
+
+    /// Apply a trade. `taker_side` is the incoming order's side (the buy
+    /// side for an auction uncross); `taker_resting` is set when the taker
+    /// was already in the book, as in an uncross.
+    void on_trade(const Trade& trade, Side taker_side, bool taker_resting) noexcept {
+        const auto maker_side = taker_side == Side::Buy ? Side::Sell : Side::Buy;
+        fill(accounts_[trade.taker_account], taker_side, trade.qty, taker_resting, trade.taker_leaves == 0);
+        fill(accounts_[trade.maker_account], maker_side, trade.qty, true, trade.maker_leaves == 0);
+    }
+
+private:
+    static std::int64_t& open_qty(AccountRisk& a, Side side) noexcept {
+        return side == Side::Buy ? a.open_buy_qty : a.open_sell_qty;
+    }
+
+    static void fill(AccountRisk& a, Side side, std::int64_t qty, bool resting, bool done) noexcept {
+        a.position += side == Side::Buy ? qty : -qty;
+        if (resting) {
+            open_qty(a, side) -= qty;
+            a.open_orders -= done;
+        }
+    }
+
+    std::vector<AccountRisk> accounts_;
+};
+
+} // namespace lob
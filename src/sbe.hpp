@@ -0,0 +1,387 @@
+#pragma once
+/// --------------------------------------------------------
+/// SBE-style binary codec, laid out at compile time
+///
+/// A message is a fixed-size block of fields at fixed
+/// offsets behind an 8-byte header, in the manner of Simple
+/// Binary Encoding:
+///
+///   header   block_length, template_id, schema_id, version
+///            (uint16 each)
+///   block    the fields, back to back, no padding
+///
+/// Layouts are plain C++ types. A field is a tag type
+/// deriving from Field<T> (integers and enums) or Chars<N>
+/// (fixed-width text); a Message lists its fields in order.
+/// Offsets, block lengths and the schema's byte order are
+/// all constants, so get<F>() / set<F>() compile to one
+/// load or store (plus a bswap for a non-native order),
+/// with no parsing.
+///
+/// Versioning, also checked at compile time:
+///   • each field names the schema version that added it
+///     (Field<T, Since>); fields must be appended in
+///     version order, so every older layout is a prefix
+///   • Encoder<M, V> writes version V's block and rejects
+///     (static_assert) fields newer than V
+///   • a reader takes the acting version from the header:
+///     fields newer than the sender read as their null
+///     value; a newer sender's longer block is skipped by
+///     its block_length
+///
+/// Reader and Encoder are flyweights: they hold a pointer
+/// into the caller's buffer and never copy the message.
+/// --------------------------------------------------------
+
+#include "endian.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <limits>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace lob::sbe {
+
+template <typename T>
+concept Scalar = (std::integral<T> && !std::same_as<T, bool>) || std::is_enum_v<T>;
+
+namespace detail {
+
+template <typename T>
+struct wire_uint {
+    using type = std::make_unsigned_t<T>;
+};
+
+template <typename T>
+    requires std::is_enum_v<T>
+struct wire_uint<T> {
+    using type = std::make_unsigned_t<std::underlying_type_t<T>>;
+};
+
+/// The SBE null of a type: max for unsigned, min for signed.
+template <Scalar T>
+constexpr T default_null() noexcept {
+    if constexpr (std::is_enum_v<T>) {
+        return static_cast<T>(std::numeric_limits<std::underlying_type_t<T>>::max());
+    } else if constexpr (std::is_signed_v<T>) {
+        return std::numeric_limits<T>::min();
+    } else {
+        return std::numeric_limits<T>::max();
+    }
+}
+
+} // namespace detail
+
+/// An integer or enum field added in schema version `Since`; reads as
+/// `Null` from a sender older than that.
+template <Scalar T, std::uint16_t Since = 0, T Null = detail::default_null<T>()>
+struct Field {
+    using value_type = T;
+    static constexpr std::size_t size = sizeof(T);
+    static constexpr std::uint16_t since = Since;
+    static constexpr T null_value = Null;
+
+    template <std::endian Order>
+    static T load(const std::byte* p) noexcept {
+        return static_cast<T>(lob::load<typename detail::wire_uint<T>::type, Order>(p));
+    }
+
+    template <std::endian Order>
+    static void store(std::byte* p, T v) noexcept {
+        using U = typename detail::wire_uint<T>::type;
+        lob::store<U, Order>(p, static_cast<U>(v));
+    }
+};
+
+/// Fixed-width text, NUL-padded; reads back without the padding. The
+/// view points into the message buffer.
+template <std::size_t N, std::uint16_t Since = 0>
+struct Chars {
+    using value_type = std::string_view;
+    static constexpr std::size_t size = N;
+    static constexpr std::uint16_t since = Since;
+    static constexpr std::string_view null_value{};
+
+    template <std::endian>
+    static std::string_view load(const std::byte* p) noexcept {
+        const auto* c = reinterpret_cast<const char*>(p);
+        return {c, static_cast<std::size_t>(std::find(c, c + N, '\0') - c)};
+    }
+
+    template <std::endian>
+    static void store(std::byte* p, std::string_view v) noexcept {
+        const auto n = std::min(v.size(), N);
+        std::memcpy(p, v.data(), n);
+        std::memset(p + n, 0, N - n);
+    }
+};
+
+/// Fields back to back, in declaration order.
+template <typename... Fields>
+struct Layout {
+    static constexpr std::size_t block_length = (std::size_t{0} + ... + Fields::size);
+
+    template <typename F>
+    static constexpr bool has = (std::is_same_v<F, Fields> || ...);
+
+    template <typename F>
+    static constexpr std::size_t offset = [] {
+        static_assert(has<F>, "field is not part of this layout");
+        std::size_t off = 0;
+        bool found = false;
+        ((found = found || std::is_same_v<F, Fields>, off += found ? 0 : Fields::size), ...);
+        return off;
+    }();
+
+    /// Block length as written by schema version v.
+    static constexpr std::size_t length_at(std::uint16_t v) noexcept {
+        return (std::size_t{0} + ... + (Fields::since <= v ? Fields::size : 0));
+    }
+
+    static constexpr std::uint16_t newest = std::max({std::uint16_t{0}, Fields::since...});
+
+private:
+    static constexpr bool appended_in_order() {
+        constexpr std::array<std::uint16_t, sizeof...(Fields)> since{Fields::since...};
+        return std::is_sorted(since.begin(), since.end());
+    }
+    static_assert(appended_in_order(), "fields must be appended in schema version order");
+    template <typename F>
+    static constexpr std::size_t count = (std::size_t{std::is_same_v<F, Fields>} + ... + 0);
+    static_assert(((count<Fields> == 1) && ...), "a field may appear once per layout");
+};
+
+/// Schema identity and byte order shared by its messages.
+template <std::uint16_t Id, std::uint16_t Version, std::endian Order = std::endian::little>
+struct Schema {
+    static constexpr std::uint16_t id = Id;
+    static constexpr std::uint16_t version = Version;
+    static constexpr std::endian byte_order = Order;
+};
+
+template <typename S, std::uint16_t TemplateId, typename... Fields>
+struct Message : Layout<Fields...> {
+    using schema = S;
+    static constexpr std::uint16_t template_id = TemplateId;
+    static_assert(Layout<Fields...>::newest <= S::version, "field is newer than its schema");
+};
+
+struct Header {
+    std::uint16_t block_length = 0;
+    std::uint16_t template_id = 0;
+    std::uint16_t schema_id = 0;
+    std::uint16_t version = 0;
+};
+
+inline constexpr std::size_t kHeaderSize = 8;
+
+template <std::endian Order>
+inline Header load_header(const std::byte* p) noexcept {
+    return {lob::load<std::uint16_t, Order>(p), lob::load<std::uint16_t, Order>(p + 2),
+            lob::load<std::uint16_t, Order>(p + 4), lob::load<std::uint16_t, Order>(p + 6)};
+}
+
+template <std::endian Order>
+inline void store_header(std::byte* p, const Header& h) noexcept {
+    lob::store<std::uint16_t, Order>(p, h.block_length);
+    lob::store<std::uint16_t, Order>(p + 2, h.template_id);
+    lob::store<std::uint16_t, Order>(p + 4, h.schema_id);
+    lob::store<std::uint16_t, Order>(p + 6, h.version);
+}
+
+/// Read-only flyweight over one block of layout L. `version` is the
+/// sender's: fields it did not have read as null.
+template <typename L, std::endian Order>
+class BlockReader {
+public:
+    explicit BlockReader(const std::byte* block, std::uint16_t version = std::numeric_limits<std::uint16_t>::max())
+        : p_(block), version_(version) {}
+
+    template <typename F>
+    typename F::value_type get() const noexcept {
+        static_assert(L::template has<F>, "field is not part of this layout");
+        if constexpr (F::since > 0) {
+            if (version_ < F::since) {
+                return F::null_value;
+            }
+        }
+        return F::template load<Order>(p_ + L::template offset<F>);
+    }
+
+    const std::byte* data() const noexcept { return p_; }
+    std::uint16_t version() const noexcept { return version_; }
+
+private:
+    const std::byte* p_;
+    std::uint16_t version_;
+};
+
+/// Write flyweight over one block of layout L, as of version V.
+template <typename L, std::endian Order, std::uint16_t V = std::numeric_limits<std::uint16_t>::max()>
+class BlockWriter {
+public:
+    explicit BlockWriter(std::byte* block) : p_(block) {}
+
+    template <typename F>
+    BlockWriter& set(typename F::value_type v) noexcept {
+        static_assert(L::template has<F>, "field is not part of this layout");
+        static_assert(F::since <= V, "field is newer than the version being written");
+        F::template store<Order>(p_ + L::template offset<F>, v);
+        return *this;
+    }
+
+private:
+    std::byte* p_;
+};
+
+template <typename M>
+using Reader = BlockReader<M, M::schema::byte_order>;
+
+/// Writes the header and block of message M, as schema version V, at
+/// the front of a buffer of at least `size` bytes.
+template <typename M, std::uint16_t V = M::schema::version>
+class Encoder {
+public:
+    static_assert(V <= M::schema::version, "version is newer than the schema");
+    static constexpr std::size_t block_length = M::length_at(V);
+    static constexpr std::size_t size = kHeaderSize + block_length;
+
+    explicit Encoder(void* buffer) noexcept : p_(static_cast<std::byte*>(buffer)), block_(p_ + kHeaderSize) {
+        store_header<M::schema::byte_order>(
+            p_, {static_cast<std::uint16_t>(block_length), M::template_id, M::schema::id, V});
+    }
+
+    template <typename F>
+    Encoder& set(typename F::value_type v) noexcept {
+        block_.template set<F>(v);
+        return *this;
+    }
+
+    std::string_view bytes() const noexcept { return {reinterpret_cast<const char*>(p_), size}; }
+
+private:
+    std::byte* p_;
+    BlockWriter<M, M::schema::byte_order, V> block_;
+};
+
+enum class Error : std::uint8_t {
+    None,
+    Incomplete,      // the buffer ends inside the message
+    BadSchema,       // another schema id
+    UnknownTemplate, // no message with this template id
+    ShortBlock,      // block shorter than the sender's version requires
+};
+
+inline const char* to_string(Error error) {
+    switch (error) {
+    case Error::None:            return "none";
+    case Error::Incomplete:      return "incomplete message";
+    case Error::BadSchema:       return "unknown schema id";
+    case Error::UnknownTemplate: return "unknown template id";
+    case Error::ShortBlock:      return "block too short for its version";
+    }
+    return "unknown";
+}
+
+/// One framed message: its header, and where its block starts.
+struct Frame {
+    Header header;
+    const std::byte* block = nullptr;
+    std::size_t length = 0; // header + block, as sent
+
+    template <typename M>
+    bool is() const noexcept {
+        return header.template_id == M::template_id;
+    }
+
+    /// Reader for a frame that is<M>() and was checked by decode().
+    template <typename M>
+    Reader<M> get() const noexcept {
+        return Reader<M>(block, header.version);
+    }
+};
+
+/// Frame the message at the front of [data, data + size) and check it
+/// against the messages Ms of schema S. On Incomplete nothing is
+/// consumed; on UnknownTemplate or ShortBlock `out.length` still skips
+/// the message.
+template <typename S, typename... Ms>
+Error decode(const void* data, std::size_t size, Frame& out) noexcept {
+    const auto* p = static_cast<const std::byte*>(data);
+    if (size < kHeaderSize) {
+        return Error::Incomplete;
+    }
+    out.header = load_header<S::byte_order>(p);
+    if (out.header.schema_id != S::id) {
+        return Error::BadSchema;
+    }
+    out.length = kHeaderSize + out.header.block_length;
+    if (size < out.length) {
+        return Error::Incomplete;
+    }
+    out.block = p + kHeaderSize;
+    auto error = Error::UnknownTemplate;
+    ((out.is<Ms>() ? (error = out.header.block_length >= Ms::length_at(out.header.version) ? Error::None
+                                                                                             : Error::ShortBlock)
+                   : error),
+     ...);
+    return error;
+}
+
+/// Frames messages of schema S from a stream, refilling a buffer in
+/// chunks.
+template <typename S, typename... Ms>
+class StreamReader {
+public:
+    explicit StreamReader(std::istream& in, std::size_t chunk = 1 << 16) : in_(in), buf_(chunk) {}
+
+    /// Next message; its block stays valid until the following call.
+    /// False at the end of the input (error None) or on the first bad
+    /// message (a cut-off last message is Incomplete).
+    bool next(Frame& out, Error& error) {
+        for (;;) {
+            error = decode<S, Ms...>(buf_.data() + pos_, len_ - pos_, out);
+            if (error == Error::None) {
+                pos_ += out.length;
+                return true;
+            }
+            if (error != Error::Incomplete) {
+                return false;
+            }
+            if (!fill()) {
+                error = pos_ == len_ ? Error::None : Error::Incomplete;
+                return false;
+            }
+        }
+    }
+
+private:
+    bool fill() {
+        const auto rest = len_ - pos_;
+        std::memmove(buf_.data(), buf_.data() + pos_, rest);
+        pos_ = 0;
+        len_ = rest;
+        if (len_ == buf_.size()) {
+            buf_.resize(buf_.size() * 2);
+        }
+        in_.read(reinterpret_cast<char*>(buf_.data() + len_), static_cast<std::streamsize>(buf_.size() - len_));
+        const auto got = static_cast<std::size_t>(in_.gcount());
+        len_ += got;
+        return got > 0;
+    }
+
+    std::istream& in_;
+    std::vector<std::byte> buf_;
+    std::size_t pos_ = 0;
+    std::size_t len_ = 0;
+};
+
+} // namespace lob::sbe
@@ -0,0 +1,166 @@
+#pragma once
+/// --------------------------------------------------------
+/// Trading session state, price bands and circuit breaker
+///
+/// States:
+///   PreOpen    — orders rest without matching
+///   Auction    — call phase; orders rest until the uncross
+///   Continuous — orders match on arrival
+///   Halted     — new orders rejected, cancels allowed
+///   Closed     — everything rejected
+///
+/// Price band: orders priced outside reference ± band_bps are
+/// rejected (or halt the session, per band_action). The
+/// reference follows the last trade, so the band moves with
+/// the market.
+///
+/// Circuit breaker: no trade prints outside anchor ±
+/// breaker_bps. The engine matches each order only up to
+/// trade_limit(); an order that would trade beyond it halts
+/// the session, and its remainder is not rested. The anchor
+/// is fixed at open and reset by each auction uncross; a
+/// halted session reopens through a new auction.
+///
+/// Limits are recomputed on trades and state changes only;
+/// the per-order check is a state test plus two compares.
+/// --------------------------------------------------------
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace lob {
+
+enum class SessionState : std::uint8_t { PreOpen, Auction, Continuous, Halted, Closed };
+
+enum class BandAction : std::uint8_t { Reject, Halt };
+
+inline const char* to_string(SessionState state) {
+    switch (state) {
+    case SessionState::PreOpen:    return "PRE_OPEN";
+    case SessionState::Auction:    return "AUCTION";
+    case SessionState::Continuous: return "CONTINUOUS";
+    case SessionState::Halted:     return "HALTED";
+    case SessionState::Closed:     return "CLOSED";
+    }
+    return "?";
+}
+
+struct SessionConfig {
+    SessionState initial = SessionState::Continuous;
+    std::int64_t reference_price = 0; // ticks; 0 = taken from the first trade
+    std::int64_t band_bps = 0;        // 0 = no price band
+    std::int64_t breaker_bps = 0;     // 0 = no circuit breaker
+    BandAction band_action = BandAction::Reject;
+};
+
+class TradingSession {
+public:
+    explicit TradingSession(const SessionConfig& config = {})
+        : config_(config), state_(config.initial) {
+        if (config_.reference_price > 0) {
+            anchor(config_.reference_price);
+        }
+    }
+
+    SessionState state() const noexcept { return state_; }
+    bool matching() const noexcept { return state_ == SessionState::Continuous; }
+    std::int64_t reference_price() const noexcept { return reference_; }
+    std::int64_t band_low() const noexcept { return band_lo_; }
+    std::int64_t band_high() const noexcept { return band_hi_; }
+
+    /// Admission check for a new order.
+    RejectReason check(const Order& order) noexcept {
+        if (state_ >= SessionState::Halted) {
+            return state_ == SessionState::Halted ? RejectReason::Halted : RejectReason::Closed;
+        }
+        if (order.price < band_lo_ || order.price > band_hi_) {
+            if (config_.band_action == BandAction::Halt && matching()) {
+                state_ = SessionState::Halted;
+            }
+            return RejectReason::PriceBand;
+        }
+        return RejectReason::None;
+    }
+
+    bool accepts_cancels() const noexcept { return state_ != SessionState::Closed; }
+
+    /// The furthest price an order on `side` limited at `price` may trade
+    /// at: its limit, capped by the circuit breaker.
+    std::int64_t trade_limit(Side side, std::int64_t price) const noexcept {
+        return side == Side::Buy ? std::min(price, breaker_hi_) : std::max(price, breaker_lo_);
+    }
+
+    /// Feed the last trade price of a match. Returns true if it tripped
+    /// the circuit breaker.
+    bool on_trade(std::int64_t price) noexcept {
+        if (anchor_ == 0) {
+            anchor(price);
+            return false;
+        }
+        if (price < breaker_lo_ || price > breaker_hi_) {
+            state_ = SessionState::Halted;
+            return true;
+        }
+        recentre(price);
+        return false;
+    }
+
+    void start_auction() noexcept {
+        if (state_ != SessionState::Closed) {
+            state_ = SessionState::Auction;
+        }
+    }
+
+    /// Continuous trading from `price` (an auction price, or 0 to keep the
+    /// current reference).
+    void open(std::int64_t price = 0) noexcept {
+        if (price > 0) {
+            anchor(price);
+        }
+        state_ = SessionState::Continuous;
+    }
+
+    void halt() noexcept { state_ = SessionState::Halted; }
+    void close() noexcept { state_ = SessionState::Closed; }
+
+private:
+    static constexpr std::int64_t kNoLow = std::numeric_limits<std::int64_t>::min();
+    static constexpr std::int64_t kNoHigh = std::numeric_limits<std::int64_t>::max();
+
+    static std::int64_t width(std::int64_t price, std::int64_t bps) noexcept {
+        return price * bps / 10'000;
+    }
+
+    void anchor(std::int64_t price) noexcept {
+        anchor_ = price;
+        if (config_.breaker_bps > 0) {
+            const auto w = width(price, config_.breaker_bps);
+            breaker_lo_ = price - w;
+            breaker_hi_ = price + w;
+        }
+        recentre(price);
+    }
+
+    void recentre(std::int64_t price) noexcept {
+        reference_ = price;
+        if (config_.band_bps > 0) {
+            const auto w = width(price, config_.band_bps);
+            band_lo_ = price - w;
+            band_hi_ = price + w;
+        }
+    }
+
+    SessionConfig config_;
+    SessionState state_;
+    std::int64_t reference_ = 0;
+    std::int64_t anchor_ = 0;
+    std::int64_t band_lo_ = kNoLow;
+    std::int64_t band_hi_ = kNoHigh;
+    std::int64_t breaker_lo_ = kNoLow;
+    std::int64_t breaker_hi_ = kNoHigh;
+};
+
+} // namespace lob
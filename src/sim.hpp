@@ -16,6 +16,7 @@ struct SimConfig {
     std::int64_t max_qty = 100;
     std::uint64_t seed = 1;
     double buy_ratio = 0.5;
+    std::uint32_t accounts = 1; // orders spread uniformly over [0, accounts)
 };
 
 template <typename Fn>
@@ -24,6 +25,7 @@ void run_simulation(const SimConfig& cfg, Fn&& on_order) {
     std::uniform_int_distribution<std::int64_t> price_delta(-cfg.price_range, cfg.price_range);
     std::uniform_int_distribution<std::int64_t> qty_dist(1, std::max<std::int64_t>(1, cfg.max_qty));
     std::bernoulli_distribution side_dist(cfg.buy_ratio);
+    std::uniform_int_distribution<std::uint32_t> account_dist(0, std::max<std::uint32_t>(1, cfg.accounts) - 1);
 
     for (std::size_t i = 0; i < cfg.count; ++i) {
         const auto delta = price_delta(rng);
@@ -33,6 +35,9 @@ void run_simulation(const SimConfig& cfg, Fn&& on_order) {
         order.side = side_dist(rng) ? Side::Buy : Side::Sell;
         order.price = price;
         order.qty = qty_dist(rng);
+        if (cfg.accounts > 1) {
+            order.account = account_dist(rng);
+        }
         order.ts_ns = now_ns();
         on_order(order);
     }
@@ -0,0 +1,239 @@
+#pragma once
+/// --------------------------------------------------------
+/// Parameter sweeps over the simulator
+///
+/// A grid names a list of values per parameter:
+///   seed=1..8 buy-ratio=0.4,0.5,0.6 range=0.25,0.50 max-qty=50,100
+/// (items separated by spaces or ';', integer lists may use
+/// a..b). Every combination is one simulation with its own
+/// engine and LatencyStats; the points run concurrently on a
+/// WorkStealingPool and come back in grid order, one row
+/// each, whatever the thread count.
+/// --------------------------------------------------------
+
+#include "matching_engine.hpp"
+#include "metrics.hpp"
+#include "price.hpp"
+#include "sim.hpp"
+#include "time_utils.hpp"
+#include "work_stealing.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <numeric>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace lob {
+
+struct SweepGrid {
+    std::vector<std::uint64_t> seeds;
+    std::vector<double> buy_ratios;
+    std::vector<std::int64_t> ranges; // ticks
+    std::vector<std::int64_t> max_qtys;
+};
+
+namespace detail {
+
+/// Call parse(item) for each comma-separated item; false if any fails
+/// or there are none.
+template <typename Parse>
+bool parse_list(std::string_view text, Parse&& parse) {
+    bool any = false;
+    while (!text.empty()) {
+        const auto comma = std::min(text.find(','), text.size());
+        if (!parse(text.substr(0, comma))) {
+            return false;
+        }
+        any = true;
+        text.remove_prefix(std::min(comma + 1, text.size()));
+    }
+    return any;
+}
+
+template <typename Int>
+bool parse_int(std::string_view text, Int& value) {
+    const auto end = text.data() + text.size();
+    return !text.empty() && std::from_chars(text.data(), end, value).ptr == end;
+}
+
+/// Integers and inclusive ranges: "1,4,10..12".
+template <typename Int>
+bool parse_int_list(std::string_view text, std::vector<Int>& out) {
+    return parse_list(text, [&](std::string_view item) {
+        const auto dots = item.find("..");
+        Int lo = 0;
+        Int hi = 0;
+        if (!parse_int(item.substr(0, dots), lo)) {
+            return false;
+        }
+        if (dots == std::string_view::npos) {
+            hi = lo;
+        } else if (!parse_int(item.substr(dots + 2), hi) || hi < lo) {
+            return false;
+        }
+        for (auto v = lo;; ++v) {
+            out.push_back(v);
+            if (v == hi) {
+                return true;
+            }
+        }
+    });
+}
+
+} // namespace detail
+
+/// Parse a grid spec; prices (range) use `scale`. Parameters not named
+/// keep the single value from `base`. False (with a message) on error.
+inline bool parse_sweep_grid(std::string_view spec, const SimConfig& base, const PriceScale& scale, SweepGrid& grid,
+                             std::string& error) {
+    grid = {};
+    while (!spec.empty()) {
+        const auto end = std::min(spec.find_first_of(" ;"), spec.size());
+        const auto item = spec.substr(0, end);
+        spec.remove_prefix(std::min(end + 1, spec.size()));
+        if (item.empty()) {
+            continue;
+        }
+        const auto eq = item.find('=');
+        const auto key = item.substr(0, eq);
+        const auto values = eq == std::string_view::npos ? std::string_view{} : item.substr(eq + 1);
+
+        bool ok = false;
+        if (key == "seed") {
+            ok = detail::parse_int_list(values, grid.seeds);
+        } else if (key == "max-qty") {
+            ok = detail::parse_int_list(values, grid.max_qtys);
+        } else if (key == "buy-ratio") {
+            ok = detail::parse_list(values, [&](std::string_view v) {
+                // std::from_chars for double is not everywhere yet.
+                try {
+                    std::size_t used = 0;
+                    const auto ratio = std::stod(std::string(v), &used);
+                    grid.buy_ratios.push_back(ratio);
+                    return used == v.size() && ratio >= 0.0 && ratio <= 1.0;
+                } catch (...) {
+                    return false;
+                }
+            });
+        } else if (key == "range") {
+            ok = detail::parse_list(values, [&](std::string_view v) {
+                grid.ranges.push_back(0);
+                return scale.parse(v, grid.ranges.back()) == PriceError::None && grid.ranges.back() >= 0;
+            });
+        } else {
+            error = "unknown sweep parameter '" + std::string(key) + "'";
+            return false;
+        }
+        if (!ok) {
+            error = "invalid sweep values '" + std::string(item) + "'";
+            return false;
+        }
+    }
+
+    if (grid.seeds.empty()) {
+        grid.seeds.push_back(base.seed);
+    }
+    if (grid.buy_ratios.empty()) {
+        grid.buy_ratios.push_back(base.buy_ratio);
+    }
+    if (grid.ranges.empty()) {
+        grid.ranges.push_back(base.price_range);
+    }
+    if (grid.max_qtys.empty()) {
+        grid.max_qtys.push_back(base.max_qty);
+    }
+    return true;
+}
+
+/// Every combination, seed varying fastest.
+inline std::vector<SimConfig> expand(const SweepGrid& grid, const SimConfig& base) {
+    std::vector<SimConfig> points;
+    for (const auto max_qty : grid.max_qtys) {
+        for (const auto range : grid.ranges) {
+            for (const auto ratio : grid.buy_ratios) {
+                for (const auto seed : grid.seeds) {
+                    auto cfg = base;
+                    cfg.seed = seed;
+                    cfg.buy_ratio = ratio;
+                    cfg.price_range = range;
+                    cfg.max_qty = max_qty;
+                    points.push_back(cfg);
+                }
+            }
+        }
+    }
+    return points;
+}
+
+struct SweepResult {
+    SimConfig cfg;
+    double seconds = 0.0;
+    LatencySummary latency;
+    std::size_t trades = 0;
+    SideStats bids;
+    SideStats asks;
+};
+
+struct Sweep {
+    std::vector<SweepResult> results; // in expand() order
+    double seconds = 0.0;             // wall time of the whole sweep
+    std::uint64_t steals = 0;
+};
+
+/// Run every point on `threads` workers.
+template <typename Book>
+Sweep run_sweep(const std::vector<SimConfig>& points, unsigned threads) {
+    Sweep sweep;
+    sweep.results.resize(points.size());
+    std::vector<std::size_t> tasks(points.size());
+    std::iota(tasks.begin(), tasks.end(), std::size_t{0});
+
+    WorkStealingPool pool(threads);
+    const auto start = now_ns();
+    pool.run(tasks, [&](std::size_t i, unsigned) {
+        const auto& cfg = points[i];
+        auto& r = sweep.results[i];
+        r.cfg = cfg;
+
+        LatencyStats latency;
+        latency.reserve(cfg.count);
+        BasicMatchingEngine<Book> engine(latency);
+        std::vector<Trade> trades;
+        trades.reserve(64);
+        const auto run_start = now_ns();
+        run_simulation(cfg, [&](const Order& order) {
+            engine.process(order, trades);
+            r.trades += trades.size();
+            trades.clear();
+        });
+        r.seconds = static_cast<double>(now_ns() - run_start) * 1e-9;
+        r.latency = latency.summary();
+        r.bids = engine.book().side_stats(Side::Buy);
+        r.asks = engine.book().side_stats(Side::Sell);
+    });
+    sweep.seconds = static_cast<double>(now_ns() - start) * 1e-9;
+    sweep.steals = pool.steals();
+    return sweep;
+}
+
+/// One row per point; prices (range) in the instrument's decimals.
+inline void write_sweep_csv(std::ostream& os, const Sweep& sweep, const PriceScale& scale) {
+    os << "seed,buy_ratio,range,max_qty,orders,seconds,msg_per_s,"
+          "lat_min_ns,lat_avg_ns,lat_p50_ns,lat_p90_ns,lat_p99_ns,lat_max_ns,"
+          "trades,bid_qty,bid_orders,bid_levels,ask_qty,ask_orders,ask_levels\n";
+    for (const auto& r : sweep.results) {
+        const auto rate = r.seconds > 0.0 ? static_cast<double>(r.cfg.count) / r.seconds : 0.0;
+        os << r.cfg.seed << ',' << r.cfg.buy_ratio << ',' << scale.to_string(r.cfg.price_range) << ','
+           << r.cfg.max_qty << ',' << r.cfg.count << ',' << r.seconds << ',' << static_cast<std::uint64_t>(rate)
+           << ',' << r.latency.min << ',' << r.latency.avg << ',' << r.latency.p50 << ',' << r.latency.p90 << ','
+           << r.latency.p99 << ',' << r.latency.max << ',' << r.trades << ',' << r.bids.qty << ','
+           << r.bids.orders << ',' << r.bids.levels << ',' << r.asks.qty << ',' << r.asks.orders << ','
+           << r.asks.levels << '\n';
+    }
+}
+
+} // namespace lob
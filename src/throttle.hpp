@@ -0,0 +1,210 @@
+#pragma once
+/// --------------------------------------------------------
+/// Message throttling with token buckets on TSC time
+///
+/// Each bucket is kept in its virtual-scheduling (GCRA) form:
+/// a single "theoretical arrival time" in TSC ticks. With
+/// emission interval T = 1 / rate and burst tolerance
+/// tau = (burst - 1) * T, a message at time t conforms if
+/// t >= tat - tau, and then tat = max(tat, t) + T. That is a
+/// token bucket of `burst` tokens refilled at `rate`, at the
+/// cost of one compare and one add — no refill arithmetic,
+/// no syscalls.
+///
+/// Buckets:
+///   • per account (Order::account), for a fixed number of
+///     accounts allocated up front; accounts past that share
+///     one overflow bucket, so a client cannot grow the table
+///   • optional aggregate bucket over every message
+///
+/// Excess messages are rejected, or queued with the exact
+/// TSC time at which they conform (their slot is reserved)
+/// and released in that order by release_due(). A queued
+/// message can be withdrawn by id with cancel().
+/// --------------------------------------------------------
+
+#include "types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace lob {
+
+enum class ThrottleAction : std::uint8_t { Reject, Queue };
+
+enum class ThrottleVerdict : std::uint8_t { Admit = 0, Queue = 1, Reject = 2 };
+
+struct ThrottleConfig {
+    double account_rate = 0.0;        // messages/s per account; 0 = unlimited
+    std::uint32_t account_burst = 1;
+    double total_rate = 0.0;          // messages/s over all accounts; 0 = unlimited
+    std::uint32_t total_burst = 1;
+    ThrottleAction action = ThrottleAction::Reject;
+    std::size_t max_queued = 65'536;  // beyond this, queueing falls back to reject
+    std::size_t accounts = 65'536;    // own buckets for accounts [0, accounts); the rest share one
+};
+
+struct ThrottleCounters {
+    std::uint64_t admitted = 0;
+    std::uint64_t rejected = 0;
+    std::uint64_t queued = 0;
+    std::uint64_t released = 0;
+};
+
+class Throttle {
+public:
+    /// tsc_hz: TSC ticks per second (see tsc_ticks_per_second()).
+    void configure(const ThrottleConfig& config, double tsc_hz) {
+        config_ = config;
+        account_ = make_rate(config.account_rate, config.account_burst, tsc_hz);
+        total_ = make_rate(config.total_rate, config.total_burst, tsc_hz);
+        total_tat_ = 0;
+        buckets_.assign(config.accounts + 1, Bucket{});
+    }
+
+    bool active() const noexcept { return account_.interval > 0 || total_.interval > 0; }
+
+    /// Requires configure().
+    ThrottleVerdict admit(const Order& order, std::uint64_t now) {
+        auto& bucket = buckets_[bucket_index(order.account)];
+
+        const auto release = std::max(conform_at(bucket.tat, account_), conform_at(total_tat_, total_));
+        const bool ok = release <= now;
+        if (config_.action == ThrottleAction::Queue && !ok) {
+            return enqueue(bucket, order, release);
+        }
+
+        // Admit or reject without a data-dependent branch (compilers turn
+        // a plain select back into one): an admitted message charges the
+        // buckets, a rejected one leaves them as is.
+        const auto mask = std::uint64_t{0} - static_cast<std::uint64_t>(ok);
+        if (account_.interval > 0) {
+            const auto tat = std::max(bucket.tat, now) + account_.interval;
+            bucket.tat ^= (bucket.tat ^ tat) & mask;
+        }
+        if (total_.interval > 0) {
+            const auto tat = std::max(total_tat_, now) + total_.interval;
+            total_tat_ ^= (total_tat_ ^ tat) & mask;
+        }
+        counters_.admitted += ok;
+        counters_.rejected += !ok;
+        bucket.throttled += !ok;
+        return static_cast<ThrottleVerdict>(static_cast<std::uint8_t>(ThrottleVerdict::Reject) * !ok);
+    }
+
+    /// Hand every queued message that conforms by `now` to fn, in release
+    /// order. Returns the number released.
+    template <typename Fn>
+    std::size_t release_due(std::uint64_t now, Fn&& fn) {
+        std::size_t released = 0;
+        while (!pending_.empty() && pending_.front().release <= now) {
+            std::pop_heap(pending_.begin(), pending_.end(), std::greater<>{});
+            const auto order = pending_.back().order;
+            pending_.pop_back();
+            ++released;
+            fn(order);
+        }
+        counters_.released += released;
+        return released;
+    }
+
+    /// Hand every queued message to fn, in release order, due or not.
+    template <typename Fn>
+    std::size_t release_all(Fn&& fn) {
+        return release_due(std::numeric_limits<std::uint64_t>::max(), std::forward<Fn>(fn));
+    }
+
+    /// Withdraw queued message `id` into `out`. False if none is queued.
+    /// A linear search: the queue is bounded by max_queued.
+    bool cancel(std::uint64_t id, Order& out) {
+        const auto it = std::find_if(pending_.begin(), pending_.end(),
+                                     [id](const Pending& p) { return p.order.id == id; });
+        if (it == pending_.end()) {
+            return false;
+        }
+        out = it->order;
+        pending_.erase(it);
+        std::make_heap(pending_.begin(), pending_.end(), std::greater<>{});
+        return true;
+    }
+
+    std::size_t queued() const noexcept { return pending_.size(); }
+    const ThrottleCounters& counters() const noexcept { return counters_; }
+
+    /// Messages an account has had throttled (rejected or queued); for an
+    /// account past ThrottleConfig::accounts, those of the shared bucket.
+    std::uint64_t throttled(std::uint32_t account) const noexcept {
+        return buckets_.empty() ? 0 : buckets_[bucket_index(account)].throttled;
+    }
+
+private:
+    struct Rate {
+        std::uint64_t interval = 0; // TSC ticks per message; 0 = unlimited
+        std::uint64_t tolerance = 0;
+    };
+
+    struct Bucket {
+        std::uint64_t tat = 0;
+        std::uint64_t throttled = 0;
+    };
+
+    struct Pending {
+        std::uint64_t release = 0;
+        std::uint64_t seq = 0;
+        Order order;
+
+        bool operator>(const Pending& other) const noexcept {
+            return release != other.release ? release > other.release : seq > other.seq;
+        }
+    };
+
+    static Rate make_rate(double rate, std::uint32_t burst, double tsc_hz) {
+        if (rate <= 0.0) {
+            return {};
+        }
+        const auto interval = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(tsc_hz / rate));
+        return {interval, interval * (std::max<std::uint32_t>(1, burst) - 1)};
+    }
+
+    std::size_t bucket_index(std::uint32_t account) const noexcept {
+        return std::min<std::size_t>(account, buckets_.size() - 1);
+    }
+
+    static std::uint64_t conform_at(std::uint64_t tat, const Rate& rate) noexcept {
+        return tat > rate.tolerance ? tat - rate.tolerance : 0;
+    }
+
+    ThrottleVerdict enqueue(Bucket& bucket, const Order& order, std::uint64_t release) {
+        ++bucket.throttled;
+        if (pending_.size() >= config_.max_queued) {
+            ++counters_.rejected;
+            return ThrottleVerdict::Reject;
+        }
+        // Reserve the slot the message conforms at.
+        if (account_.interval > 0) {
+            bucket.tat = std::max(bucket.tat, release) + account_.interval;
+        }
+        if (total_.interval > 0) {
+            total_tat_ = std::max(total_tat_, release) + total_.interval;
+        }
+        pending_.push_back({release, next_seq_++, order});
+        std::push_heap(pending_.begin(), pending_.end(), std::greater<>{});
+        ++counters_.queued;
+        return ThrottleVerdict::Queue;
+    }
+
+    ThrottleConfig config_;
+    Rate account_;
+    Rate total_;
+    std::uint64_t total_tat_ = 0;
+    std::vector<Bucket> buckets_; // one per account, then the shared overflow bucket
+    std::vector<Pending> pending_; // min-heap on (release, seq)
+    std::uint64_t next_seq_ = 0;
+    ThrottleCounters counters_;
+};
+
+} // namespace lob
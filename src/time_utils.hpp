@@ -3,6 +3,12 @@
 #include <chrono>
 #include <cstdint>
 
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
 namespace lob {
 
 inline std::uint64_t now_ns() {
@@ -12,4 +18,37 @@ inline std::uint64_t now_ns() {
             .count());
 }
 
+/// Wall-clock ns since the Unix epoch (for timestamps sent to clients).
+inline std::uint64_t wall_clock_ns() {
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+}
+
+/// Raw time-stamp counter (no syscall); steady_clock ns where there is none.
+inline std::uint64_t read_tsc() noexcept {
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return now_ns();
+#endif
+}
+
+/// TSC ticks per second, measured once against steady_clock (~10 ms spin
+/// on first use). Assumes an invariant TSC.
+inline double tsc_ticks_per_second() {
+    static const double rate = [] {
+        const auto t0 = now_ns();
+        const auto c0 = read_tsc();
+        std::uint64_t t1 = t0;
+        while (t1 - t0 < 10'000'000) {
+            t1 = now_ns();
+        }
+        const auto c1 = read_tsc();
+        return static_cast<double>(c1 - c0) * 1e9 / static_cast<double>(t1 - t0);
+    }();
+    return rate;
+}
+
 } // namespace lob
@@ -1,11 +1,12 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
 namespace lob {
 
-enum class Side { Buy, Sell };
+enum class Side : std::uint8_t { Buy, Sell };
 
 inline std::string side_to_string(Side side) {
     return side == Side::Buy ? "BUY" : "SELL";
@@ -14,16 +15,71 @@ inline std::string side_to_string(Side side) {
 struct Order {
     std::uint64_t id = 0;
     Side side = Side::Buy;
-    std::int64_t price = 0; // price in ticks (cents)
+    std::uint32_t account = 0;
+    std::int64_t price = 0; // tick number: price / tick size (see price.hpp)
     std::int64_t qty = 0;
     std::uint64_t ts_ns = 0;
+    std::int64_t cum_qty = 0; // quantity filled so far; qty is what is still open
 };
 
 struct Trade {
     std::uint64_t taker_id = 0;
     std::uint64_t maker_id = 0;
-    std::int64_t price = 0;
+    std::int64_t price = 0; // tick number
     std::int64_t qty = 0;
+    std::int64_t taker_leaves = 0; // quantity still open after this fill
+    std::int64_t maker_leaves = 0;
+    std::int64_t taker_cum = 0;    // quantity filled so far, this fill included
+    std::int64_t maker_cum = 0;
+    std::uint32_t taker_account = 0;
+    std::uint32_t maker_account = 0;
 };
 
+/// Why the engine refused an order.
+enum class RejectReason : std::uint8_t {
+    None,
+    Halted,
+    Closed,
+    PriceBand,
+    UnknownAccount,
+    MaxOrderQty,
+    MaxNotional,
+    MaxOpenOrders,
+    PositionLimit,
+    PriceDistance,
+    OutOfRange, // does not fit the book's storage (see order_storage.hpp)
+    Throttled,
+    Queued, // not a reject: held by the throttle and processed later
+    // Refused by the gateway before the engine (client order ids).
+    DuplicateClOrdId,
+    InvalidClOrdId, // empty, or longer than a ClientKey holds
+    ClOrdIdLimit,   // the ClientOrderMap is full
+    TooLate,        // a replace to no more than the order has filled
+};
+
+inline constexpr std::size_t kRejectReasonCount = 17;
+
+inline const char* to_string(RejectReason reason) {
+    switch (reason) {
+    case RejectReason::None:             return "NONE";
+    case RejectReason::Halted:           return "HALTED";
+    case RejectReason::Closed:           return "CLOSED";
+    case RejectReason::PriceBand:        return "PRICE_BAND";
+    case RejectReason::UnknownAccount:   return "UNKNOWN_ACCOUNT";
+    case RejectReason::MaxOrderQty:      return "MAX_ORDER_QTY";
+    case RejectReason::MaxNotional:      return "MAX_NOTIONAL";
+    case RejectReason::MaxOpenOrders:    return "MAX_OPEN_ORDERS";
+    case RejectReason::PositionLimit:    return "POSITION_LIMIT";
+    case RejectReason::PriceDistance:    return "PRICE_DISTANCE";
+    case RejectReason::OutOfRange:       return "OUT_OF_RANGE";
+    case RejectReason::Throttled:        return "THROTTLED";
+    case RejectReason::Queued:           return "QUEUED";
+    case RejectReason::DuplicateClOrdId: return "DUPLICATE_CLORDID";
+    case RejectReason::InvalidClOrdId:   return "INVALID_CLORDID";
+    case RejectReason::ClOrdIdLimit:     return "CLORDID_LIMIT";
+    case RejectReason::TooLate:          return "TOO_LATE";
+    }
+    return "?";
+}
+
 } // namespace lob
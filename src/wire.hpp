@@ -0,0 +1,108 @@
+#pragma once
+/// --------------------------------------------------------
+/// Binary order entry and output messages
+///
+/// The engine's own SBE-style schema (sbe.hpp): id 1,
+/// little-endian, fixed offsets, 8-byte header per message.
+///
+///   id  message           block  fields
+///   1   NewOrder          21     side, price, qty, account
+///   2   CancelOrder       8      order_id
+///   3   ExecutionReport   63     exec_id, order_id,
+///                                contra_id, price, last_qty,
+///                                leaves_qty, cum_qty, account,
+///                                exec_type, side, reason
+///   4   TradeReport       32     taker_id, maker_id, price,
+///                                qty
+///
+/// Version history:
+///   1  all four messages
+///   2  NewOrder.account (a version-1 order has account 0)
+///
+/// Prices are ticks and quantities shares, as in Order;
+/// order ids are the engine's (1, 2, ... in input order).
+/// --------------------------------------------------------
+
+#include "exec_report.hpp"
+#include "sbe.hpp"
+#include "types.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace lob::wire {
+
+using Schema = sbe::Schema<1, 2, std::endian::little>;
+
+struct OrderId : sbe::Field<std::uint64_t> {};
+struct ExecId : sbe::Field<std::uint64_t> {};
+struct ContraId : sbe::Field<std::uint64_t> {};
+struct TakerId : sbe::Field<std::uint64_t> {};
+struct MakerId : sbe::Field<std::uint64_t> {};
+struct Price : sbe::Field<std::int64_t> {};
+struct Qty : sbe::Field<std::int64_t> {};
+struct LastQty : sbe::Field<std::int64_t> {};
+struct LeavesQty : sbe::Field<std::int64_t> {};
+struct CumQty : sbe::Field<std::int64_t> {};
+struct Account : sbe::Field<std::uint32_t> {};
+struct OrderAccount : sbe::Field<std::uint32_t, 2, 0> {}; // NewOrder, since version 2
+struct OrderSide : sbe::Field<Side> {};
+struct Type : sbe::Field<ExecType> {};
+struct Reason : sbe::Field<RejectReason> {};
+
+using NewOrder = sbe::Message<Schema, 1, OrderSide, Price, Qty, OrderAccount>;
+using CancelOrder = sbe::Message<Schema, 2, OrderId>;
+using ExecutionReport = sbe::Message<Schema, 3, ExecId, OrderId, ContraId, Price, LastQty, LeavesQty, CumQty,
+                                     Account, Type, OrderSide, Reason>;
+using TradeReport = sbe::Message<Schema, 4, TakerId, MakerId, Price, Qty>;
+
+static_assert(NewOrder::block_length == 21 && NewOrder::length_at(1) == 17);
+static_assert(ExecutionReport::block_length == 63);
+
+/// Largest message of the schema, header included.
+inline constexpr std::size_t kMaxMessage =
+    sbe::kHeaderSize + std::max({NewOrder::block_length, CancelOrder::block_length,
+                                 ExecutionReport::block_length, TradeReport::block_length});
+
+using Reader = sbe::StreamReader<Schema, NewOrder, CancelOrder, ExecutionReport, TradeReport>;
+
+/// The order a NewOrder asks for (id and ts_ns are the caller's); false
+/// for an unknown side or a price or qty that is not positive.
+inline bool read_order(const sbe::Reader<NewOrder>& m, Order& out) noexcept {
+    out.side = m.get<OrderSide>();
+    out.price = m.get<Price>();
+    out.qty = m.get<Qty>();
+    out.account = m.get<OrderAccount>();
+    return (out.side == Side::Buy || out.side == Side::Sell) && out.price > 0 && out.qty > 0;
+}
+
+inline std::string_view encode_new_order(const Order& order, std::byte* out) noexcept {
+    sbe::Encoder<NewOrder> m(out);
+    m.set<OrderSide>(order.side).set<Price>(order.price).set<Qty>(order.qty).set<OrderAccount>(order.account);
+    return m.bytes();
+}
+
+inline std::string_view encode_cancel(std::uint64_t order_id, std::byte* out) noexcept {
+    sbe::Encoder<CancelOrder> m(out);
+    m.set<OrderId>(order_id);
+    return m.bytes();
+}
+
+inline std::string_view encode(const ExecReport& r, std::byte* out) noexcept {
+    sbe::Encoder<ExecutionReport> m(out);
+    m.set<ExecId>(r.exec_id).set<OrderId>(r.order_id).set<ContraId>(r.contra_id).set<Price>(r.price);
+    m.set<LastQty>(r.last_qty).set<LeavesQty>(r.leaves_qty).set<CumQty>(r.cum_qty).set<Account>(r.account);
+    m.set<Type>(r.type).set<OrderSide>(r.side).set<Reason>(r.reason);
+    return m.bytes();
+}
+
+inline std::string_view encode(const Trade& t, std::byte* out) noexcept {
+    sbe::Encoder<TradeReport> m(out);
+    m.set<TakerId>(t.taker_id).set<MakerId>(t.maker_id).set<Price>(t.price).set<Qty>(t.qty);
+    return m.bytes();
+}
+
+} // namespace lob::wire
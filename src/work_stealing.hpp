@@ -0,0 +1,114 @@
+#pragma once
+/// --------------------------------------------------------
+/// WorkStealingPool — run independent tasks across threads
+///
+/// Tasks are dealt round-robin, in the order given, onto one
+/// deque per worker (pass the largest first). A worker takes
+/// from the front of its own deque; once that is empty it
+/// steals from the back of the others', so a worker that
+/// drew a few huge tasks sheds the rest to idle peers.
+///
+/// No task spawns another, so a worker stops once every
+/// deque is empty. Deques are mutex-guarded: tasks here are
+/// whole symbols or whole simulations, so a lock per task
+/// is noise.
+/// --------------------------------------------------------
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lob {
+
+class WorkStealingPool {
+public:
+    /// threads == 0: one per hardware thread.
+    explicit WorkStealingPool(unsigned threads = 0)
+        : threads_(threads > 0 ? threads : std::max(1u, std::thread::hardware_concurrency())) {}
+
+    unsigned threads() const noexcept { return threads_; }
+
+    /// Tasks taken from another worker's deque in the last run().
+    std::uint64_t steals() const noexcept { return steals_; }
+
+    /// Call fn(task, worker) once for every task id, and wait for all.
+    template <typename Fn>
+    void run(const std::vector<std::size_t>& tasks, Fn&& fn) {
+        std::vector<std::unique_ptr<Queue>> queues;
+        for (unsigned w = 0; w < threads_; ++w) {
+            queues.push_back(std::make_unique<Queue>());
+        }
+        for (std::size_t i = 0; i < tasks.size(); ++i) {
+            queues[i % threads_]->tasks.push_back(tasks[i]);
+        }
+
+        std::vector<std::uint64_t> steals(threads_, 0);
+        auto worker = [&](unsigned self) {
+            std::size_t task = 0;
+            for (;;) {
+                if (queues[self]->pop_front(task)) {
+                    fn(task, self);
+                    continue;
+                }
+                bool stolen = false;
+                for (unsigned k = 1; k < threads_ && !stolen; ++k) {
+                    stolen = queues[(self + k) % threads_]->pop_back(task);
+                }
+                if (!stolen) {
+                    return;
+                }
+                ++steals[self];
+                fn(task, self);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned w = 1; w < threads_; ++w) {
+            pool.emplace_back(worker, w);
+        }
+        worker(0);
+        for (auto& t : pool) {
+            t.join();
+        }
+        steals_ = 0;
+        for (const auto s : steals) {
+            steals_ += s;
+        }
+    }
+
+private:
+    struct alignas(64) Queue {
+        std::mutex mutex;
+        std::deque<std::size_t> tasks;
+
+        bool pop_front(std::size_t& task) {
+            std::lock_guard lock(mutex);
+            if (tasks.empty()) {
+                return false;
+            }
+            task = tasks.front();
+            tasks.pop_front();
+            return true;
+        }
+
+        bool pop_back(std::size_t& task) {
+            std::lock_guard lock(mutex);
+            if (tasks.empty()) {
+                return false;
+            }
+            task = tasks.back();
+            tasks.pop_back();
+            return true;
+        }
+    };
+
+    unsigned threads_;
+    std::uint64_t steals_ = 0;
+};
+
+} // namespace lob
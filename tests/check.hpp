@@ -0,0 +1,81 @@
+#pragma once
+/// --------------------------------------------------------
+/// Minimal test harness for the ctest targets in tests/
+///
+///   TEST(uncross_picks_max_volume) {
+///       CHECK(result.crossed);
+///       CHECK_EQ(result.price, 100);
+///   }
+///   int main() { return lob::test::run_all(); }
+///
+/// Each tests/test_<name>.cpp is one executable. A failed
+/// check prints file:line, the expression and, for CHECK_EQ,
+/// both values; the test carries on and the process exits
+/// non-zero.
+/// --------------------------------------------------------
+
+#include <cstddef>
+#include <iostream>
+#include <vector>
+
+namespace lob::test {
+
+struct Case {
+    const char* name;
+    void (*fn)();
+};
+
+inline std::vector<Case>& cases() {
+    static std::vector<Case> all;
+    return all;
+}
+
+inline std::size_t& failures() {
+    static std::size_t count = 0;
+    return count;
+}
+
+struct Register {
+    Register(const char* name, void (*fn)()) { cases().push_back({name, fn}); }
+};
+
+inline void fail(const char* file, int line, const char* expr) {
+    ++failures();
+    std::cerr << file << ":" << line << ": CHECK(" << expr << ") failed\n";
+}
+
+template <typename A, typename B>
+void check_eq(const A& a, const B& b, const char* file, int line, const char* expr_a, const char* expr_b) {
+    if (!(a == b)) {
+        ++failures();
+        std::cerr << file << ":" << line << ": CHECK_EQ(" << expr_a << ", " << expr_b << ") failed: " << a
+                  << " != " << b << "\n";
+    }
+}
+
+/// Run every TEST in registration order. Returns the process exit code.
+inline int run_all() {
+    for (const auto& c : cases()) {
+        const auto before = failures();
+        c.fn();
+        std::cout << (failures() == before ? "[ ok ] " : "[FAIL] ") << c.name << "\n";
+    }
+    std::cout << cases().size() << " tests, " << failures() << " failed checks\n";
+    return failures() == 0 ? 0 : 1;
+}
+
+} // namespace lob::test
+
+#define TEST(name)                                                         \
+    static void test_##name();                                             \
+    static const lob::test::Register register_##name(#name, &test_##name); \
+    static void test_##name()
+
+#define CHECK(expr)                                     \
+    do {                                                \
+        if (!(expr)) {                                  \
+            lob::test::fail(__FILE__, __LINE__, #expr); \
+        }                                               \
+    } while (false)
+
+#define CHECK_EQ(a, b) lob::test::check_eq((a), (b), __FILE__, __LINE__, #a, #b)
@@ -0,0 +1,110 @@
+/// --------------------------------------------------------
+/// Pro-rata allocation: shares, rounding and remainders
+/// --------------------------------------------------------
+
+#include "check.hpp"
+
+#include "allocation.hpp"
+#include "order_book.hpp"
+
+#include <cstdint>
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+
+using lob::Side;
+
+struct MinTwoAllocation : lob::ProRataAllocation {
+    static constexpr std::int64_t min_allocation = 2;
+};
+
+template <typename Policy>
+std::vector<std::int64_t> allocate(const std::vector<std::int64_t>& resting, std::int64_t qty) {
+    std::vector<std::int64_t> out(resting.size(), -1);
+    lob::allocate_pro_rata<Policy>(resting.data(), resting.size(), qty, out.data());
+    return out;
+}
+
+} // namespace
+
+TEST(pro_rata_remainder_goes_in_queue_order) {
+    // Shares 10 * (10, 20, 30) / 60 floor to 1, 3, 5; the one left over
+    // goes to the front of the queue.
+    const auto out = allocate<lob::ProRataAllocation>({10, 20, 30}, 10);
+    CHECK_EQ(out[0], 2);
+    CHECK_EQ(out[1], 3);
+    CHECK_EQ(out[2], 5);
+}
+
+TEST(pro_rata_remainder_capped_by_resting) {
+    // 50 * 3 / 100 = 1 is below the minimum and rounds to zero; the
+    // remainder of 3 fills the first order and stops at its size.
+    const auto out = allocate<MinTwoAllocation>({3, 3, 94}, 50);
+    CHECK_EQ(out[0], 3);
+    CHECK_EQ(out[1], 0);
+    CHECK_EQ(out[2], 47);
+}
+
+TEST(pro_rata_clears_level_when_qty_covers_it) {
+    const auto out = allocate<lob::ProRataAllocation>({10, 20, 30}, 100);
+    CHECK_EQ(out[0], 10);
+    CHECK_EQ(out[1], 20);
+    CHECK_EQ(out[2], 30);
+}
+
+TEST(top_order_fills_first) {
+    // The front order takes 10; 15 is split 20:30 among the rest.
+    const auto out = allocate<lob::TopOrderProRataAllocation>({10, 20, 30}, 25);
+    CHECK_EQ(out[0], 10);
+    CHECK_EQ(out[1], 6);
+    CHECK_EQ(out[2], 9);
+}
+
+TEST(pro_rata_conserves_quantity) {
+    std::mt19937_64 rng(7);
+    std::uniform_int_distribution<std::int64_t> size(1, 1'000);
+    std::uniform_int_distribution<std::size_t> count(1, 40);
+    for (int round = 0; round < 1'000; ++round) {
+        std::vector<std::int64_t> resting(count(rng));
+        std::int64_t total = 0;
+        for (auto& r : resting) {
+            total += r = size(rng);
+        }
+        const auto qty = std::uniform_int_distribution<std::int64_t>(1, total + 100)(rng);
+        const auto out = allocate<MinTwoAllocation>(resting, qty);
+        std::int64_t sum = 0;
+        for (std::size_t i = 0; i < out.size(); ++i) {
+            CHECK(out[i] >= 0 && out[i] <= resting[i]);
+            sum += out[i];
+        }
+        CHECK_EQ(sum, std::min(qty, total));
+    }
+}
+
+TEST(pro_rata_book_fills_by_size) {
+    lob::ProRataOrderBook book;
+    book.add(lob::Order{1, Side::Sell, 0, 100, 10, 1});
+    book.add(lob::Order{2, Side::Sell, 0, 100, 20, 2});
+    book.add(lob::Order{3, Side::Sell, 0, 100, 30, 3});
+
+    lob::Order buy{4, Side::Buy, 0, 100, 10, 4};
+    std::vector<lob::Trade> trades;
+    book.match(buy, trades);
+
+    std::map<std::uint64_t, std::int64_t> filled;
+    for (const auto& t : trades) {
+        CHECK_EQ(t.taker_id, 4u);
+        filled[t.maker_id] += t.qty;
+    }
+    CHECK_EQ(buy.qty, 0);
+    CHECK_EQ(filled[1], 2);
+    CHECK_EQ(filled[2], 3);
+    CHECK_EQ(filled[3], 5);
+    CHECK_EQ(book.level_stats(Side::Sell, 100).qty, 50);
+}
+
+int main() {
+    return lob::test::run_all();
+}
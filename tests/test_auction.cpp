@@ -0,0 +1,106 @@
+/// --------------------------------------------------------
+/// Call auction: equilibrium price selection and uncross
+/// --------------------------------------------------------
+
+#include "check.hpp"
+
+#include "auction.hpp"
+#include "order_book.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using lob::AuctionLevel;
+using lob::Side;
+
+std::int64_t traded(const std::vector<lob::Trade>& trades) {
+    std::int64_t qty = 0;
+    for (const auto& t : trades) {
+        qty += t.qty;
+    }
+    return qty;
+}
+
+} // namespace
+
+TEST(equilibrium_maximises_volume) {
+    // S(99..102) = 5, 15, 25, 25; D = 20, 20, 15, 10: 15 trades at 100 or
+    // 101, and 100 leaves the smaller surplus.
+    const std::vector<AuctionLevel> bids{{102, 10}, {101, 5}, {100, 5}};
+    const std::vector<AuctionLevel> asks{{99, 5}, {100, 10}, {101, 10}};
+    const auto r = lob::find_equilibrium(bids, asks);
+    CHECK(r.crossed);
+    CHECK_EQ(r.price, 100);
+    CHECK_EQ(r.volume, 15);
+    CHECK_EQ(r.surplus, 5);
+}
+
+TEST(equilibrium_follows_buy_pressure) {
+    // 10 trades at 100 and at 101, both with 5 left to buy: the higher.
+    const auto r = lob::find_equilibrium({{101, 15}}, {{100, 10}});
+    CHECK_EQ(r.price, 101);
+    CHECK_EQ(r.volume, 10);
+    CHECK_EQ(r.surplus, 5);
+}
+
+TEST(equilibrium_follows_sell_pressure) {
+    const auto r = lob::find_equilibrium({{101, 10}}, {{100, 15}});
+    CHECK_EQ(r.price, 100);
+    CHECK_EQ(r.surplus, -5);
+}
+
+TEST(equilibrium_balanced_tie_goes_to_reference) {
+    const std::vector<AuctionLevel> bids{{101, 10}};
+    const std::vector<AuctionLevel> asks{{100, 10}};
+    CHECK_EQ(lob::find_equilibrium(bids, asks, 100).price, 100);
+    CHECK_EQ(lob::find_equilibrium(bids, asks, 101).price, 101);
+    CHECK_EQ(lob::find_equilibrium(bids, asks, 150).price, 101);
+}
+
+TEST(equilibrium_not_crossed) {
+    CHECK(!lob::find_equilibrium({{99, 10}}, {{100, 10}}).crossed);
+    CHECK(!lob::find_equilibrium({}, {{100, 10}}).crossed);
+}
+
+TEST(uncross_executes_at_equilibrium) {
+    lob::OrderBook book;
+    std::uint64_t id = 0;
+    for (const auto& [price, qty] : std::vector<AuctionLevel>{{102, 10}, {101, 5}, {100, 5}}) {
+        book.add(lob::Order{++id, Side::Buy, 0, price, qty, id});
+    }
+    for (const auto& [price, qty] : std::vector<AuctionLevel>{{99, 5}, {100, 10}, {101, 10}}) {
+        book.add(lob::Order{++id, Side::Sell, 0, price, qty, id});
+    }
+
+    const auto indicative = book.indicative_uncross();
+    std::vector<lob::Trade> trades;
+    const auto r = book.uncross(trades);
+    CHECK(r.crossed);
+    CHECK_EQ(r.price, indicative.price);
+    CHECK_EQ(r.price, 100);
+    CHECK_EQ(traded(trades), 15);
+    for (const auto& t : trades) {
+        CHECK_EQ(t.price, 100);
+    }
+    // The bids at 102 and 101 fill first; the 100 bid and 101 ask remain.
+    CHECK_EQ(book.best_bid(), 100);
+    CHECK_EQ(book.best_ask(), 101);
+    CHECK(!book.indicative_uncross().crossed);
+}
+
+TEST(uncross_of_uncrossed_book_trades_nothing) {
+    lob::OrderBook book;
+    book.add(lob::Order{1, Side::Buy, 0, 99, 10, 1});
+    book.add(lob::Order{2, Side::Sell, 0, 100, 10, 2});
+    std::vector<lob::Trade> trades;
+    CHECK(!book.uncross(trades).crossed);
+    CHECK(trades.empty());
+    CHECK_EQ(book.best_bid(), 99);
+    CHECK_EQ(book.best_ask(), 100);
+}
+
+int main() {
+    return lob::test::run_all();
+}
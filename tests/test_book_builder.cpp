@@ -0,0 +1,112 @@
+/// --------------------------------------------------------
+/// BookBuilder: by-id updates, unknown and live-id reuse
+/// --------------------------------------------------------
+
+#include "check.hpp"
+
+#include "book_builder.hpp"
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace {
+
+using lob::BookUpdate;
+using lob::Side;
+
+} // namespace
+
+TEST(updates_by_id) {
+    lob::BookBuilder<> builder;
+    CHECK(builder.add(1, Side::Buy, 100, 10, 1));
+    CHECK(builder.add(2, Side::Buy, 100, 5, 2));
+    CHECK(builder.reduce(1, 4));
+    CHECK_EQ(builder.book().level_stats(Side::Buy, 100).qty, 11);
+
+    // Order 1 keeps its place at the front after the reduce.
+    CHECK_EQ(builder.book().queue_position(2).qty_ahead, 6);
+
+    CHECK(builder.replace(1, 3, 101, 7, 3));
+    CHECK_EQ(builder.book().best_bid(), 101);
+    CHECK(builder.remove(2));
+    CHECK(!builder.remove(2));
+    CHECK(!builder.reduce(9, 1));
+    CHECK_EQ(builder.stats().unknown_refs, 2u);
+}
+
+TEST(add_of_live_id_is_skipped) {
+    lob::BookBuilder<> builder;
+    CHECK(builder.add(1, Side::Buy, 100, 10, 1));
+    CHECK(!builder.add(1, Side::Sell, 105, 5, 2));
+    CHECK_EQ(builder.stats().duplicate_ids, 1u);
+    CHECK_EQ(builder.stats().adds, 1u);
+    CHECK_EQ(builder.book().best_ask(), 0);
+
+    // The original is still reachable by id and leaves cleanly.
+    CHECK(builder.remove(1));
+    CHECK_EQ(builder.book().best_bid(), 0);
+    CHECK_EQ(builder.book().side_stats(Side::Buy).orders, 0u);
+
+    // Once gone, the id may be reused.
+    CHECK(builder.add(1, Side::Sell, 105, 5, 3));
+    CHECK_EQ(builder.book().best_ask(), 105);
+}
+
+TEST(replace_to_live_id_is_skipped) {
+    lob::BookBuilder<> builder;
+    builder.add(1, Side::Buy, 100, 10, 1);
+    builder.add(2, Side::Buy, 99, 5, 2);
+    CHECK(!builder.replace(2, 1, 98, 4, 3));
+    CHECK_EQ(builder.stats().duplicate_ids, 1u);
+    CHECK_EQ(builder.book().level_stats(Side::Buy, 99).qty, 5);
+    CHECK_EQ(builder.book().level_stats(Side::Buy, 100).qty, 10);
+    CHECK(builder.replace(2, 2, 98, 4, 3)); // same id: allowed
+    CHECK_EQ(builder.book().level_stats(Side::Buy, 98).qty, 4);
+}
+
+TEST(batch_matches_one_at_a_time) {
+    std::mt19937_64 rng(13);
+    std::vector<BookUpdate> updates;
+    std::uint64_t next_id = 1;
+    for (int i = 0; i < 50'000; ++i) {
+        BookUpdate u;
+        u.ts_ns = static_cast<std::uint64_t>(i);
+        const auto pick = rng() % 10;
+        if (pick < 4 || next_id < 10) {
+            u.type = BookUpdate::Type::Add;
+            u.side = rng() % 2 ? Side::Buy : Side::Sell;
+            u.id = rng() % 20 == 0 ? 1 + rng() % next_id : next_id++; // some live-id reuse
+            u.price = u.side == Side::Buy ? 900 + static_cast<std::int64_t>(rng() % 100)
+                                          : 1'000 + static_cast<std::int64_t>(rng() % 100);
+            u.qty = 1 + static_cast<std::int64_t>(rng() % 100);
+        } else {
+            u.type = pick < 6 ? BookUpdate::Type::Reduce : pick < 8 ? BookUpdate::Type::Delete
+                                                                    : BookUpdate::Type::Replace;
+            u.id = 1 + rng() % next_id;
+            u.new_id = next_id++;
+            u.price = 950 + static_cast<std::int64_t>(rng() % 100);
+            u.qty = 1 + static_cast<std::int64_t>(rng() % 50);
+        }
+        updates.push_back(u);
+    }
+
+    lob::BookBuilder<> single;
+    for (const auto& u : updates) {
+        single.apply(u);
+    }
+    lob::BookBuilder<> batched;
+    batched.apply(updates.data(), updates.size(), 8);
+
+    for (const auto side : {Side::Buy, Side::Sell}) {
+        CHECK_EQ(single.book().side_stats(side).qty, batched.book().side_stats(side).qty);
+        CHECK_EQ(single.book().side_stats(side).orders, batched.book().side_stats(side).orders);
+    }
+    CHECK_EQ(single.stats().duplicate_ids, batched.stats().duplicate_ids);
+    CHECK(single.stats().duplicate_ids > 0);
+    CHECK_EQ(single.stats().unknown_refs, batched.stats().unknown_refs);
+}
+
+int main() {
+    return lob::test::run_all();
+}
@@ -0,0 +1,80 @@
+/// --------------------------------------------------------
+/// ClientOrderMap: lookups, limits and id reuse after erase
+/// --------------------------------------------------------
+
+#include "check.hpp"
+
+#include "client_order_map.hpp"
+
+#include <cstdint>
+#include <random>
+#include <string>
+#include <unordered_map>
+
+namespace {
+
+using Insert = lob::ClientOrderMap::Insert;
+
+} // namespace
+
+TEST(insert_find_erase) {
+    lob::ClientOrderMap map(16);
+    CHECK(map.insert(1, "A1", 10) == Insert::Ok);
+    CHECK(map.insert(2, "A1", 11) == Insert::Ok); // same text, other session
+    CHECK(map.insert(1, "A1", 12) == Insert::Duplicate);
+    CHECK_EQ(map.find(1, "A1"), 10u);
+    CHECK_EQ(map.find(2, "A1"), 11u);
+    CHECK_EQ(map.find(1, "A2"), lob::ClientOrderMap::kNoId);
+
+    CHECK(map.erase(1, "A1"));
+    CHECK(!map.erase(1, "A1"));
+    CHECK_EQ(map.find(1, "A1"), lob::ClientOrderMap::kNoId);
+    // A finished id may be reused.
+    CHECK(map.insert(1, "A1", 13) == Insert::Ok);
+    CHECK_EQ(map.find(1, "A1"), 13u);
+    CHECK_EQ(map.size(), 2u);
+}
+
+TEST(bad_ids_and_full_map) {
+    lob::ClientOrderMap map(4);
+    CHECK(map.insert(1, "", 1) == Insert::BadId);
+    CHECK(map.insert(1, std::string(27, 'x'), 1) == Insert::Ok);
+    CHECK(map.insert(1, std::string(28, 'x'), 2) == Insert::BadId);
+    for (std::uint64_t id = 2; id <= 4; ++id) {
+        CHECK(map.insert(1, "C" + std::to_string(id), id) == Insert::Ok);
+    }
+    CHECK(map.insert(1, "C5", 5) == Insert::Full);
+    CHECK(map.erase(1, "C2"));
+    CHECK(map.insert(1, "C5", 5) == Insert::Ok);
+}
+
+TEST(churn_matches_a_reference_map) {
+    // Live ids bounded well below capacity, so every insert fits and the
+    // backward-shift deletes run over long probe runs.
+    lob::ClientOrderMap map(1'024);
+    std::unordered_map<std::string, std::uint64_t> model;
+    std::mt19937_64 rng(21);
+    for (std::uint64_t step = 0; step < 200'000; ++step) {
+        const auto key = "K" + std::to_string(rng() % 1'500);
+        const auto it = model.find(key);
+        if (it == model.end()) {
+            if (model.size() < 1'000) {
+                CHECK(map.insert(7, key, step) == Insert::Ok);
+                model.emplace(key, step);
+            }
+        } else if (rng() % 2 == 0) {
+            CHECK(map.erase(7, key));
+            model.erase(it);
+        } else {
+            CHECK_EQ(map.find(7, key), it->second);
+        }
+    }
+    CHECK_EQ(map.size(), model.size());
+    for (const auto& [key, id] : model) {
+        CHECK_EQ(map.find(7, key), id);
+    }
+}
+
+int main() {
+    return lob::test::run_all();
+}
@@ -0,0 +1,124 @@
+/// --------------------------------------------------------
+/// FIX order entry: replace request round trip and a
+/// replace after a partial fill
+/// --------------------------------------------------------
+
+#include "check.hpp"
+
+#include "fix.hpp"
+#include "matching_engine.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+using lob::ExecType;
+using lob::RejectReason;
+using lob::Side;
+
+bool has_field(std::string_view message, const std::string& field) {
+    return message.find(std::string(1, lob::fix::kSoh) + field + lob::fix::kSoh) != std::string_view::npos;
+}
+
+// Buy 10 at 100 (id 1), then a sell of 4 fills part of it.
+struct PartiallyFilled {
+    lob::LatencyStats latency;
+    lob::MatchingEngine engine{latency};
+    lob::ExecReportBuffer reports{64};
+    std::vector<lob::Trade> trades;
+
+    PartiallyFilled() {
+        engine.attach_reports(&reports);
+        engine.process(lob::Order{1, Side::Buy, 0, 100, 10, 1}, trades);
+        engine.process(lob::Order{2, Side::Sell, 0, 100, 4, 2}, trades);
+        reports.clear();
+    }
+};
+
+} // namespace
+
+TEST(replace_request_round_trip) {
+    lob::FixEncoder encoder("CLIENT", "LOB");
+    char buf[lob::FixEncoder::kMaxMessage];
+    const auto msg = encoder.replace_request("A1", "A2", lob::Order{0, Side::Sell, 7, 10'125, 30, 0}, 0, buf);
+
+    lob::FixDecoder decoder;
+    lob::FixMessage out;
+    std::size_t length = 0;
+    CHECK(decoder.decode(msg.data(), msg.size(), out, length) == lob::FixError::None);
+    CHECK_EQ(length, msg.size());
+    CHECK(out.type == lob::FixMsgType::OrderCancelReplaceRequest);
+    CHECK_EQ(out.orig_clordid, std::string_view("A1"));
+    CHECK_EQ(out.clordid, std::string_view("A2"));
+    CHECK(out.order.side == Side::Sell);
+    CHECK_EQ(out.order.account, 7u);
+    CHECK_EQ(out.order.price, 10'125);
+    CHECK_EQ(out.order.qty, 30);
+}
+
+TEST(replace_after_partial_fill_carries_the_fills) {
+    PartiallyFilled s;
+    RejectReason reason = RejectReason::None;
+    CHECK(s.engine.replace(1, lob::Order{3, Side::Buy, 0, 99, 10, 3}, s.trades, reason));
+    CHECK(reason == RejectReason::None);
+
+    // The original leaves; the replacement rests with what is left of 10.
+    lob::Order resting;
+    CHECK(!s.engine.book().find(1, resting));
+    CHECK(s.engine.book().find(3, resting));
+    CHECK_EQ(resting.qty, 6);
+    CHECK_EQ(resting.cum_qty, 4);
+    CHECK_EQ(resting.price, 99);
+
+    CHECK_EQ(s.reports.size(), 2u);
+    CHECK(s.reports[0].type == ExecType::Cancelled);
+    CHECK_EQ(s.reports[0].order_id, 1u);
+    CHECK(s.reports[1].type == ExecType::New);
+    CHECK_EQ(s.reports[1].order_id, 3u);
+    CHECK_EQ(s.reports[1].leaves_qty, 6);
+    CHECK_EQ(s.reports[1].cum_qty, 4);
+
+    // The FIX report carries CumQty 4 and LeavesQty 6.
+    lob::FixEncoder encoder("LOB", "CLIENT");
+    char buf[lob::FixEncoder::kMaxMessage];
+    const auto msg = encoder.execution_report(s.reports[1], "A2", 0, buf);
+    CHECK(has_field(msg, "14=4"));
+    CHECK(has_field(msg, "151=6"));
+}
+
+TEST(replace_to_no_more_than_filled_is_too_late) {
+    PartiallyFilled s;
+    RejectReason reason = RejectReason::None;
+    CHECK(!s.engine.replace(1, lob::Order{3, Side::Buy, 0, 100, 4, 3}, s.trades, reason));
+    CHECK(reason == RejectReason::TooLate);
+    CHECK_EQ(s.reports.size(), 1u);
+    CHECK(s.reports[0].type == ExecType::CancelRejected);
+    CHECK(s.reports[0].reason == RejectReason::TooLate);
+
+    lob::Order resting;
+    CHECK(s.engine.book().find(1, resting));
+    CHECK_EQ(resting.qty, 6);
+
+    lob::FixEncoder encoder("LOB", "CLIENT");
+    char buf[lob::FixEncoder::kMaxMessage];
+    const auto msg = encoder.execution_report(s.reports[0], "A2", 0, buf, lob::FixMsgType::OrderCancelReplaceRequest);
+    CHECK(has_field(msg, "35=9"));
+    CHECK(has_field(msg, "434=2"));
+    CHECK(has_field(msg, "102=0"));
+}
+
+TEST(replace_of_unknown_order_is_rejected) {
+    PartiallyFilled s;
+    RejectReason reason = RejectReason::TooLate;
+    CHECK(!s.engine.replace(42, lob::Order{3, Side::Buy, 0, 100, 10, 3}, s.trades, reason));
+    CHECK(reason == RejectReason::None);
+    CHECK_EQ(s.reports.size(), 1u);
+    CHECK(s.reports[0].type == ExecType::CancelRejected);
+}
+
+int main() {
+    return lob::test::run_all();
+}
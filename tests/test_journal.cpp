@@ -0,0 +1,179 @@
+/// --------------------------------------------------------
+/// LZ block codec and the columnar journal: round trips and
+/// corrupt input
+/// --------------------------------------------------------
+
+#include "check.hpp"
+
+#include "journal.hpp"
+#include "lz.hpp"
+
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Bytes = std::vector<std::uint8_t>;
+
+Bytes compress(const Bytes& src) {
+    Bytes out(lob::lz_bound(src.size()));
+    out.resize(lob::lz_compress(src.data(), src.size(), out.data()));
+    return out;
+}
+
+// Decode into a buffer of exactly out_size bytes, so a sanitizer build
+// catches any write past it.
+bool decompress(const Bytes& src, std::size_t out_size, Bytes& out) {
+    out.assign(out_size, 0);
+    return lob::lz_decompress(src.data(), src.size(), out.data(), out_size);
+}
+
+Bytes sample(std::size_t n) {
+    std::mt19937_64 rng(3);
+    Bytes data;
+    while (data.size() < n) {
+        // Repeats at varying distances, with some noise between them.
+        const auto row = "trade," + std::to_string(rng() % 1'000) + ",10000," + std::to_string(rng() % 50) + "\n";
+        data.insert(data.end(), row.begin(), row.end());
+        data.push_back(static_cast<std::uint8_t>(rng()));
+    }
+    data.resize(n);
+    return data;
+}
+
+std::string trades_csv(std::size_t rows) {
+    std::mt19937_64 rng(11);
+    std::string csv = "trade_idx,taker_id,maker_id,price,qty,side\n";
+    std::int64_t price = 10'000;
+    for (std::size_t i = 0; i < rows; ++i) {
+        price += static_cast<std::int64_t>(rng() % 5) - 2;
+        csv += std::to_string(i) + "," + std::to_string(2 * i + 1) + "," + std::to_string(rng() % (i + 1)) + ","
+             + std::to_string(price) + "," + std::to_string(rng() % 100 + 1) + "," + (rng() % 2 ? "BUY" : "SELL")
+             + "\n";
+    }
+    return csv;
+}
+
+std::string round_trip(const std::string& csv, bool compress_blocks, std::string& journal) {
+    std::ostringstream packed;
+    lob::JournalStats stats;
+    std::string error;
+    if (!lob::csv_to_journal(csv.data(), csv.size(), packed, stats, error, compress_blocks)) {
+        return "pack failed: " + error;
+    }
+    journal = packed.str();
+    std::ostringstream text;
+    if (!lob::journal_to_csv(reinterpret_cast<const std::uint8_t*>(journal.data()), journal.size(), text, stats,
+                             error)) {
+        return "unpack failed: " + error;
+    }
+    return text.str();
+}
+
+} // namespace
+
+TEST(lz_round_trip) {
+    for (const auto n : {std::size_t{0}, std::size_t{1}, std::size_t{12}, std::size_t{100}, std::size_t{70'000}}) {
+        const auto src = sample(n);
+        const auto packed = compress(src);
+        CHECK(packed.size() <= lob::lz_bound(n));
+        Bytes out;
+        CHECK(decompress(packed, n, out));
+        CHECK(out == src);
+    }
+}
+
+TEST(lz_rejects_malformed_sequences) {
+    Bytes out;
+    // Match offset before the start of the output.
+    CHECK(!decompress({0x10, 'a', 0x02, 0x00}, 5, out));
+    // Offset 0.
+    CHECK(!decompress({0x10, 'a', 0x00, 0x00}, 5, out));
+    // Literal length past the end of the input.
+    CHECK(!decompress({0x50, 'a', 'b'}, 5, out));
+    // Extended length with its length bytes missing.
+    CHECK(!decompress({0xF0}, 20, out));
+    // Offset cut short.
+    CHECK(!decompress({0x10, 'a', 0x01}, 5, out));
+    // Match past the end of the output.
+    CHECK(!decompress({0x1F, 'a', 0x01, 0x00, 0x10}, 8, out));
+    // Well formed ("aaaaa"), but a different size than the caller expects.
+    CHECK(decompress({0x10, 'a', 0x01, 0x00}, 5, out));
+    CHECK(!decompress({0x10, 'a', 0x01, 0x00}, 4, out));
+    CHECK(!decompress({0x10, 'a', 0x01, 0x00}, 6, out));
+}
+
+TEST(lz_survives_corrupt_blocks) {
+    const auto src = sample(4'096);
+    const auto packed = compress(src);
+    std::mt19937_64 rng(5);
+    Bytes out;
+    for (std::size_t cut = 0; cut < packed.size(); cut += 7) {
+        CHECK(!decompress(Bytes(packed.begin(), packed.begin() + static_cast<std::ptrdiff_t>(cut)), src.size(), out));
+    }
+    for (int round = 0; round < 2'000; ++round) {
+        auto bad = packed;
+        for (int k = 0; k < 3; ++k) {
+            bad[rng() % bad.size()] = static_cast<std::uint8_t>(rng());
+        }
+        // Whatever it decides, it stays inside both buffers.
+        decompress(bad, src.size(), out);
+        CHECK_EQ(out.size(), src.size());
+    }
+}
+
+TEST(journal_round_trip) {
+    // 70k rows: two blocks; the side column is text.
+    const auto csv = trades_csv(70'000);
+    std::string journal;
+    CHECK(round_trip(csv, true, journal) == csv);
+    CHECK(journal.size() < csv.size() / 4);
+    CHECK(round_trip(csv, false, journal) == csv);
+}
+
+TEST(journal_round_trip_mixed_cells) {
+    // Negative values, a blank and a decimal in an integer column, and a
+    // non-canonical integer (kept as text so it converts back byte for byte).
+    const std::string csv = "id,price,note\n"
+                            "1,-5,a\n"
+                            "2,,b\n"
+                            "3,10.5,a\n"
+                            "4,007,c\n"
+                            "5,9223372036854775807,a\n";
+    std::string journal;
+    CHECK(round_trip(csv, true, journal) == csv);
+}
+
+TEST(journal_rejects_corrupt_files) {
+    const auto csv = trades_csv(5'000);
+    std::string journal;
+    CHECK(round_trip(csv, true, journal) == csv);
+
+    const auto unpack = [](const std::string& data, std::string& error) {
+        std::ostringstream text;
+        lob::JournalStats stats;
+        return lob::journal_to_csv(reinterpret_cast<const std::uint8_t*>(data.data()), data.size(), text, stats,
+                                   error);
+    };
+    std::string error;
+    CHECK(!unpack(journal.substr(0, journal.size() / 2), error));
+    CHECK(!error.empty());
+    CHECK(!unpack(journal.substr(0, 4), error));
+    auto bad_magic = journal;
+    bad_magic[0] = 'X';
+    CHECK(!unpack(bad_magic, error));
+
+    std::mt19937_64 rng(9);
+    for (int round = 0; round < 500; ++round) {
+        auto bad = journal;
+        bad[rng() % bad.size()] = static_cast<char>(rng());
+        unpack(bad, error); // may or may not notice, but must not crash
+    }
+}
+
+int main() {
+    return lob::test::run_all();
+}
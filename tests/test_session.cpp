@@ -0,0 +1,93 @@
+/// --------------------------------------------------------
+/// Session: price bands and the circuit breaker enforced
+/// inside the match
+/// --------------------------------------------------------
+
+#include "check.hpp"
+
+#include "matching_engine.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using lob::RejectReason;
+using lob::Side;
+
+// Breaker at 10000 +- 1%: trades must print within [9900, 10100].
+lob::SessionConfig breaker_config() {
+    lob::SessionConfig config;
+    config.reference_price = 10'000;
+    config.breaker_bps = 100;
+    return config;
+}
+
+} // namespace
+
+TEST(breaker_stops_the_match_at_its_limit) {
+    lob::LatencyStats latency;
+    lob::MatchingEngine engine(latency, breaker_config());
+    lob::ExecReportBuffer reports(64);
+    engine.attach_reports(&reports);
+
+    std::vector<lob::Trade> trades;
+    engine.process(lob::Order{1, Side::Sell, 0, 10'000, 5, 1}, trades);
+    engine.process(lob::Order{2, Side::Sell, 0, 10'050, 5, 2}, trades);
+    engine.process(lob::Order{3, Side::Sell, 0, 10'300, 5, 3}, trades);
+    reports.clear();
+
+    CHECK(engine.process(lob::Order{4, Side::Buy, 0, 10'400, 12, 4}, trades) == RejectReason::None);
+    CHECK_EQ(trades.size(), 2u);
+    for (const auto& t : trades) {
+        CHECK(t.price <= 10'100);
+    }
+    CHECK(engine.session().state() == lob::SessionState::Halted);
+    // The remainder of 2 is cancelled, not rested into the halted book.
+    CHECK_EQ(engine.book().best_bid(), 0);
+    CHECK_EQ(engine.book().best_ask(), 10'300);
+    const auto& last = reports[reports.size() - 1];
+    CHECK(last.type == lob::ExecType::Cancelled);
+    CHECK(last.reason == RejectReason::Halted);
+    CHECK_EQ(last.order_id, 4u);
+    CHECK_EQ(last.last_qty, 2);
+    CHECK_EQ(last.cum_qty, 10);
+
+    CHECK(engine.process(lob::Order{5, Side::Buy, 0, 10'000, 1, 5}, trades) == RejectReason::Halted);
+}
+
+TEST(breaker_does_not_halt_an_order_that_stops_short_of_it) {
+    lob::LatencyStats latency;
+    lob::MatchingEngine engine(latency, breaker_config());
+    std::vector<lob::Trade> trades;
+    engine.process(lob::Order{1, Side::Buy, 0, 10'000, 5, 1}, trades);
+    engine.process(lob::Order{2, Side::Buy, 0, 9'700, 5, 2}, trades);
+
+    // Limited above the breaker, but nothing is left to trade past it.
+    engine.process(lob::Order{3, Side::Sell, 0, 9'800, 8, 3}, trades);
+    CHECK(engine.session().matching());
+    CHECK_EQ(trades.size(), 1u);
+    CHECK_EQ(engine.book().best_ask(), 9'800);
+    CHECK_EQ(engine.book().best_bid(), 9'700);
+}
+
+TEST(price_band_rejects_outside_orders) {
+    lob::SessionConfig config;
+    config.reference_price = 10'000;
+    config.band_bps = 50;
+    lob::LatencyStats latency;
+    lob::MatchingEngine engine(latency, config);
+    std::vector<lob::Trade> trades;
+    CHECK(engine.process(lob::Order{1, Side::Buy, 0, 10'051, 1, 1}, trades) == RejectReason::PriceBand);
+    CHECK(engine.process(lob::Order{2, Side::Buy, 0, 10'050, 1, 2}, trades) == RejectReason::None);
+    CHECK(engine.session().matching());
+
+    config.band_action = lob::BandAction::Halt;
+    lob::MatchingEngine halting(latency, config);
+    CHECK(halting.process(lob::Order{1, Side::Sell, 0, 9'900, 1, 1}, trades) == RejectReason::PriceBand);
+    CHECK(halting.session().state() == lob::SessionState::Halted);
+}
+
+int main() {
+    return lob::test::run_all();
+}
@@ -0,0 +1,124 @@
+/// --------------------------------------------------------
+/// Throttle: admission, queue release order, cancel of a
+/// queued order and the end-of-run drain
+/// --------------------------------------------------------
+
+#include "check.hpp"
+
+#include "matching_engine.hpp"
+#include "throttle.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+using lob::Side;
+using lob::ThrottleVerdict;
+
+// A 1 kHz clock and one message per second per account: each slot is 1000
+// ticks, so the test controls exactly what is due.
+lob::Throttle queueing_throttle() {
+    lob::ThrottleConfig config;
+    config.account_rate = 1.0;
+    config.action = lob::ThrottleAction::Queue;
+    config.accounts = 4;
+    lob::Throttle throttle;
+    throttle.configure(config, 1'000.0);
+    return throttle;
+}
+
+lob::Order order(std::uint64_t id, std::uint32_t account) {
+    return lob::Order{id, Side::Buy, account, 100, 1, id};
+}
+
+std::vector<std::uint64_t> release_all(lob::Throttle& throttle) {
+    std::vector<std::uint64_t> ids;
+    throttle.release_all([&](const lob::Order& o) { ids.push_back(o.id); });
+    return ids;
+}
+
+} // namespace
+
+TEST(queue_releases_in_slot_then_arrival_order) {
+    auto throttle = queueing_throttle();
+    CHECK(throttle.admit(order(1, 0), 0) == ThrottleVerdict::Admit);
+    CHECK(throttle.admit(order(2, 0), 0) == ThrottleVerdict::Queue); // slot 1000
+    CHECK(throttle.admit(order(3, 0), 0) == ThrottleVerdict::Queue); // slot 2000
+    CHECK(throttle.admit(order(4, 1), 0) == ThrottleVerdict::Admit);
+    CHECK(throttle.admit(order(5, 1), 0) == ThrottleVerdict::Queue); // slot 1000, after 2
+    CHECK_EQ(throttle.queued(), 3u);
+
+    std::vector<std::uint64_t> ids;
+    CHECK_EQ(throttle.release_due(999, [&](const lob::Order& o) { ids.push_back(o.id); }), 0u);
+    CHECK_EQ(throttle.release_due(1'500, [&](const lob::Order& o) { ids.push_back(o.id); }), 2u);
+    CHECK(ids == (std::vector<std::uint64_t>{2, 5}));
+    CHECK(release_all(throttle) == (std::vector<std::uint64_t>{3}));
+    CHECK_EQ(throttle.queued(), 0u);
+    CHECK_EQ(throttle.counters().released, 3u);
+}
+
+TEST(cancel_withdraws_a_queued_order) {
+    auto throttle = queueing_throttle();
+    throttle.admit(order(1, 0), 0);
+    for (std::uint64_t id = 2; id <= 5; ++id) {
+        throttle.admit(order(id, 0), 0);
+    }
+    lob::Order removed;
+    CHECK(throttle.cancel(3, removed));
+    CHECK_EQ(removed.id, 3u);
+    CHECK(!throttle.cancel(3, removed));
+    CHECK(!throttle.cancel(1, removed)); // admitted, not queued
+    CHECK(release_all(throttle) == (std::vector<std::uint64_t>{2, 4, 5}));
+}
+
+TEST(reject_mode_never_queues) {
+    lob::ThrottleConfig config;
+    config.account_rate = 1.0;
+    lob::Throttle throttle;
+    throttle.configure(config, 1'000.0);
+    CHECK(throttle.admit(order(1, 0), 0) == ThrottleVerdict::Admit);
+    CHECK(throttle.admit(order(2, 0), 999) == ThrottleVerdict::Reject);
+    CHECK(throttle.admit(order(3, 0), 1'000) == ThrottleVerdict::Admit);
+    CHECK_EQ(throttle.queued(), 0u);
+    CHECK_EQ(throttle.throttled(0), 1u);
+}
+
+TEST(engine_cancels_queued_and_drains_the_rest) {
+    lob::LatencyStats latency;
+    lob::MatchingEngine engine(latency);
+    lob::ThrottleConfig config;
+    config.account_rate = 0.001; // nothing queued comes due during the test
+    config.action = lob::ThrottleAction::Queue;
+    config.accounts = 4;
+    engine.throttle().configure(config, lob::tsc_ticks_per_second());
+    lob::ExecReportBuffer reports(64);
+    engine.attach_reports(&reports);
+
+    std::vector<lob::Trade> trades;
+    CHECK(engine.process(lob::Order{1, Side::Sell, 0, 100, 5, 1}, trades) == lob::RejectReason::None);
+    CHECK(engine.process(lob::Order{2, Side::Sell, 0, 101, 5, 2}, trades) == lob::RejectReason::Queued);
+    CHECK(engine.process(lob::Order{3, Side::Sell, 0, 102, 5, 3}, trades) == lob::RejectReason::Queued);
+    CHECK(engine.process(lob::Order{4, Side::Sell, 0, 103, 5, 4}, trades) == lob::RejectReason::Queued);
+
+    reports.clear();
+    CHECK_EQ(engine.cancel(3), 5);
+    CHECK_EQ(reports.size(), 1u);
+    CHECK(reports[0].type == lob::ExecType::Cancelled);
+    CHECK_EQ(reports[0].order_id, 3u);
+    CHECK_EQ(engine.throttle().queued(), 2u);
+
+    reports.clear();
+    CHECK_EQ(engine.drain_throttled(trades), 2u);
+    CHECK_EQ(engine.throttle().queued(), 0u);
+    CHECK_EQ(reports.size(), 2u);
+    CHECK_EQ(reports[0].order_id, 2u);
+    CHECK_EQ(reports[1].order_id, 4u);
+    CHECK(reports[0].type == lob::ExecType::New && reports[1].type == lob::ExecType::New);
+    CHECK_EQ(engine.book().side_stats(Side::Sell).orders, 3u);
+    CHECK_EQ(engine.book().level_stats(Side::Sell, 102).orders, 0u);
+}
+
+int main() {
+    return lob::test::run_all();
+}
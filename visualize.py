@@ -8,6 +8,7 @@ Reads CSV data produced by lob_engine --dump-data and displays 3 charts:
 
 import csv
 import os
+import struct
 import sys
 from pathlib import Path
 
@@ -22,33 +23,81 @@ def read_csv(filepath):
         return list(csv.DictReader(f))
 
 
+DEPTH_HEADER = struct.Struct("<8sIIqQQ")
+
+
+def load_depth(data_dir):
+    """Load the native depth profile (depth.bin or depth.csv).
+
+    A run writes only one of the two, so when both exist the other is left
+    over from an earlier run into the same directory: the newer one is used.
+    Falls back to accumulating book.csv for dumps from older builds.
+    Returns (bid_prices, bid_cum, ask_prices, ask_cum) as int64 arrays, best first.
+    """
+    bin_path = data_dir / "depth.bin"
+    csv_path = data_dir / "depth.csv"
+    if bin_path.exists() and (not csv_path.exists() or bin_path.stat().st_mtime >= csv_path.stat().st_mtime):
+        raw = bin_path.read_bytes()
+        magic, version, _, _, bid_rows, ask_rows = DEPTH_HEADER.unpack_from(raw)
+        if magic != b"LOBDEPTH" or version != 1:
+            raise ValueError(f"{bin_path}: unsupported depth file")
+        cols = np.frombuffer(raw, dtype="<i8", offset=DEPTH_HEADER.size)
+        b, a = bid_rows, ask_rows
+        return cols[:b], cols[b:2 * b], cols[2 * b:2 * b + a], cols[2 * b + a:2 * b + 2 * a]
+
+    if csv_path.exists():
+        side = np.loadtxt(csv_path, delimiter=",", skiprows=1, usecols=0, dtype="U3", ndmin=1)
+        vals = np.loadtxt(csv_path, delimiter=",", skiprows=1, usecols=(1, 2), dtype=np.int64, ndmin=2)
+        bids, asks = vals[side == "BID"], vals[side == "ASK"]
+        return bids[:, 0], bids[:, 1], asks[:, 0], asks[:, 1]
+
+    book_rows = read_csv(data_dir / "book.csv")
+    bids = sorted(((int(r["price"]), int(r["total_qty"])) for r in book_rows if r["side"] == "BID"),
+                  key=lambda x: -x[0])
+    asks = sorted(((int(r["price"]), int(r["total_qty"])) for r in book_rows if r["side"] == "ASK"),
+                  key=lambda x: x[0])
+    bid_p = np.array([p for p, _ in bids], dtype=np.int64)
+    ask_p = np.array([p for p, _ in asks], dtype=np.int64)
+    bid_c = np.cumsum(np.array([q for _, q in bids], dtype=np.int64))
+    ask_c = np.cumsum(np.array([q for _, q in asks], dtype=np.int64))
+    return bid_p, bid_c, ask_p, ask_c
+
+
+def load_scale(data_dir):
+    """Load the price scale (scale.csv): returns (tick_size, decimals).
+
+    Prices in the dump are tick numbers; price = ticks * tick_size.
+    Dumps from older builds have no scale.csv and are in cents.
+    """
+    path = data_dir / "scale.csv"
+    if not path.exists():
+        return 0.01, 2
+    row = read_csv(path)[0]
+    return float(row["tick_size"]), int(row["decimals"])
+
+
 def load_data(data_dir):
-    """Load all CSV files from the data directory."""
+    """Load all data files from the data directory."""
     data_dir = Path(data_dir)
-    book = read_csv(data_dir / "book.csv")
+    scale = load_scale(data_dir)
+    depth = load_depth(data_dir)
     latency = read_csv(data_dir / "latency.csv")
     trades = read_csv(data_dir / "trades.csv")
-    return book, latency, trades
+    return scale, depth, latency, trades
 
 
-def plot_depth_chart(ax, book_rows):
+def plot_depth_chart(ax, depth, scale):
     """Plot the order book depth chart (cumulative quantity at each price level)."""
-    bids = [(int(r["price"]), int(r["total_qty"])) for r in book_rows if r["side"] == "BID"]
-    asks = [(int(r["price"]), int(r["total_qty"])) for r in book_rows if r["side"] == "ASK"]
-
-    # Sort bids descending by price, asks ascending
-    bids.sort(key=lambda x: -x[0])
-    asks.sort(key=lambda x: x[0])
+    tick_size, decimals = scale
+    bid_p, bid_cum, ask_p, ask_cum = depth
+    bid_prices = bid_p * tick_size
+    ask_prices = ask_p * tick_size
 
-    if bids:
-        bid_prices = [p / 100.0 for p, _ in bids]
-        bid_cum = list(np.cumsum([q for _, q in bids]))
+    if len(bid_prices):
         ax.fill_between(bid_prices, bid_cum, alpha=0.4, color="#22c55e", step="pre")
         ax.step(bid_prices, bid_cum, where="pre", color="#16a34a", linewidth=1.5, label="Bids")
 
-    if asks:
-        ask_prices = [p / 100.0 for p, _ in asks]
-        ask_cum = list(np.cumsum([q for _, q in asks]))
+    if len(ask_prices):
         ax.fill_between(ask_prices, ask_cum, alpha=0.4, color="#ef4444", step="pre")
         ax.step(ask_prices, ask_cum, where="pre", color="#dc2626", linewidth=1.5, label="Asks")
 
@@ -57,15 +106,14 @@ def plot_depth_chart(ax, book_rows):
     ax.set_ylabel("Cumulative Quantity")
     ax.legend(loc="upper center", framealpha=0.9)
     ax.grid(True, alpha=0.3)
-    ax.xaxis.set_major_formatter(ticker.FormatStrFormatter("%.2f"))
+    ax.xaxis.set_major_formatter(ticker.FormatStrFormatter(f"%.{decimals}f"))
 
     # Zoom to the interesting range around the spread
-    all_prices = [p / 100.0 for p, _ in bids + asks]
-    if all_prices:
-        mid = (min(all_prices) + max(all_prices)) / 2
-        span = max(all_prices) - min(all_prices)
-        margin = max(span * 0.05, 0.10)
-        ax.set_xlim(min(all_prices) - margin, max(all_prices) + margin)
+    all_prices = np.concatenate([bid_prices, ask_prices])
+    if len(all_prices):
+        span = all_prices.max() - all_prices.min()
+        margin = max(span * 0.05, 10 * tick_size)
+        ax.set_xlim(all_prices.min() - margin, all_prices.max() + margin)
 
 
 def plot_latency_histogram(ax, latency_rows):
@@ -111,14 +159,15 @@ def plot_latency_histogram(ax, latency_rows):
     )
 
 
-def plot_trade_prices(ax, trade_rows):
+def plot_trade_prices(ax, trade_rows, scale):
     """Plot trade execution prices over time."""
+    tick_size, decimals = scale
     if not trade_rows:
         ax.text(0.5, 0.5, "No trade data", ha="center", va="center", transform=ax.transAxes)
         return
 
     indices = [int(r["trade_idx"]) for r in trade_rows]
-    prices = [int(r["price"]) / 100.0 for r in trade_rows]
+    prices = [int(r["price"]) * tick_size for r in trade_rows]
     qtys = [int(r["qty"]) for r in trade_rows]
 
     # Downsample if too many trades for scatter
@@ -151,14 +200,14 @@ def plot_trade_prices(ax, trade_rows):
     ax.set_title("Trade Prices Over Time", fontsize=14, fontweight="bold")
     ax.set_xlabel("Trade Index")
     ax.set_ylabel("Price ($)")
-    ax.yaxis.set_major_formatter(ticker.FormatStrFormatter("%.2f"))
+    ax.yaxis.set_major_formatter(ticker.FormatStrFormatter(f"%.{decimals}f"))
     ax.grid(True, alpha=0.3)
 
     # Show spread info
     if prices:
         ax.text(
             0.02, 0.95,
-            f"{len(prices):,} trades  |  price range: ${min(prices):.2f} – ${max(prices):.2f}",
+            f"{len(prices):,} trades  |  price range: ${min(prices):.{decimals}f} – ${max(prices):.{decimals}f}",
             transform=ax.transAxes, fontsize=8,
             verticalalignment="top",
             bbox=dict(boxstyle="round,pad=0.3", facecolor="white", alpha=0.8),
@@ -174,8 +223,8 @@ def main():
         sys.exit(1)
 
     print(f"Loading data from {data_dir}/...")
-    book, latency, trades = load_data(data_dir)
-    print(f"  Book levels: {len(book)}")
+    scale, depth, latency, trades = load_data(data_dir)
+    print(f"  Depth rows: {len(depth[0]) + len(depth[2])}")
     print(f"  Latency samples: {len(latency)}")
     print(f"  Trades: {len(trades)}")
 
@@ -184,9 +233,9 @@ def main():
     fig, axes = plt.subplots(1, 3, figsize=(20, 6))
     fig.suptitle("Low-Latency Limit Order Book — Dashboard", fontsize=16, fontweight="bold", y=1.02)
 
-    plot_depth_chart(axes[0], book)
+    plot_depth_chart(axes[0], depth, scale)
     plot_latency_histogram(axes[1], latency)
-    plot_trade_prices(axes[2], trades)
+    plot_trade_prices(axes[2], trades, scale)
 
     plt.tight_layout()
     plt.savefig(os.path.join(data_dir, "dashboard.png"), dpi=150, bbox_inches="tight")